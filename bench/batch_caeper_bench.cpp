@@ -0,0 +1,38 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <caep/caep.h>
+#include "./bench_util.h"
+
+namespace {
+
+const int rule_count = 10000;
+const int batch_size = 10000;
+
+double TimeMs(const std::shared_ptr<caep::Caeper>& c, const std::vector<std::vector<std::string>>& reqs) {
+    auto start = std::chrono::steady_clock::now();
+    c->BatchCaeper(reqs);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+    auto c = bench::NewCaeper(rule_count);
+    std::vector<std::vector<std::string>> reqs;
+    for(int i = 0; i < batch_size; ++i)
+        reqs.push_back({"user" + std::to_string(i), "data" + std::to_string(i % 100), i % 2 ? "read" : "write"});
+
+    double sequential = TimeMs(c, reqs);
+    std::cout << "batch: " << batch_size << "\tcalling thread: " << sequential << " ms" << std::endl;
+
+    int max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for(int thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+        c->SetThreadPool(std::make_shared<caep::ThreadPool>(thread_count));
+        double parallel = TimeMs(c, reqs);
+        std::cout << "batch: " << batch_size << "\tthreads: " << thread_count
+                  << "\t" << parallel << " ms\tspeedup: " << sequential / parallel << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <caep/caep.h>
+#include <caep/log/thread_util/thread.h>
+
+namespace {
+
+const std::string policy = "batch_file_adapter_bench.csv";
+const int rules_per_thread = 20000;
+
+// Each of thread_count threads adds rules_per_thread rules in batches of batch_size, returns rules per second.
+double Throughput(int thread_count, int batch_size, size_t& groups) {
+    std::remove(policy.c_str());
+    auto adapter = std::make_shared<caep::BatchFileAdapter>(policy);
+
+    std::vector<std::unique_ptr<caep::Thread>> threads;
+    for(int i = 0; i < thread_count; ++i) {
+        threads.emplace_back(new caep::Thread([adapter, batch_size, i]() {
+            std::vector<std::vector<std::string>> rules;
+            for(int j = 0; j < rules_per_thread; ++j) {
+                rules.push_back({"user" + std::to_string(i) + "_" + std::to_string(j), "data" + std::to_string(j % 100), "read"});
+                if(int(rules.size()) == batch_size || j + 1 == rules_per_thread) {
+                    adapter->AddPolicies("a", "a", rules);
+                    rules.clear();
+                }
+            }
+        }));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(auto& thread : threads)
+        thread->Start();
+    for(auto& thread : threads)
+        thread->Join();
+    auto stop = std::chrono::steady_clock::now();
+
+    groups = adapter->GroupCount();
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    return double(thread_count) * rules_per_thread / seconds;
+}
+
+} // namespace
+
+int main() {
+    for(int batch_size : {100, 1000, 10000}) {
+        for(int thread_count : {1, 4, 16}) {
+            size_t groups = 0;
+            double rate = Throughput(thread_count, batch_size, groups);
+            std::cout << "batch: " << batch_size
+                      << "\tthreads: " << thread_count
+                      << "\trules/s: " << rate
+                      << "\tbatches: " << thread_count * ((rules_per_thread + batch_size - 1) / batch_size)
+                      << "\tcommits: " << groups << std::endl;
+        }
+    }
+    std::remove(policy.c_str());
+    return 0;
+}
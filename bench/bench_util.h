@@ -0,0 +1,26 @@
+#ifndef CAEP_BENCH_UTIL_H
+#define CAEP_BENCH_UTIL_H
+
+#include <memory>
+#include <string>
+#include <caep/caep.h>
+
+namespace bench {
+
+const std::string example_model = "../../example/basic_rbac_model.ini";
+const std::string example_policy = "../../example/basic_rbac_model.csv";
+
+// Loads the example model and appends rule_count synthetic rules to section 'a', "user<i>" may
+// read "data<i % 100>".
+template<typename C = caep::Caeper>
+std::shared_ptr<C> NewCaeper(int rule_count) {
+    auto c = std::make_shared<C>(example_model, example_policy);
+    c->EnableAutoSave(false);
+    for(int i = 0; i < rule_count; ++i)
+        c->AddPolicy({"user" + std::to_string(i), "data" + std::to_string(i % 100), "read"});
+    return c;
+}
+
+} // namespace bench
+
+#endif
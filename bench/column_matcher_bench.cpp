@@ -0,0 +1,56 @@
+#include <chrono>
+#include <iostream>
+#include <caep/caep.h>
+
+namespace {
+
+const int row_count = 100000;
+const int calls = 200;
+
+// Matches value against every row of field 1, returns rows per second.
+template<typename Func>
+double RowsPerSecond(const caep::Section& section, const std::string& value, Func func) {
+    size_t matched = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < calls; ++i)
+        matched += func(section, value);
+    auto stop = std::chrono::steady_clock::now();
+
+    if(matched == size_t(calls) + 1)
+        std::cout << matched << std::endl;
+    return double(calls) * section.RowCount() / std::chrono::duration<double>(stop - start).count();
+}
+
+// DefaultMatcher called for every row, as the full scan of Caeper does.
+size_t PerRow(const caep::Section& section, const std::string& value) {
+    size_t matched = 0;
+    for(size_t row = 0; row < section.RowCount(); ++row)
+        matched += caep::DefaultMatcher(value, section.symbols->Name(section.GetId(row, 1)));
+    return matched;
+}
+
+size_t PerColumn(const caep::Section& section, const std::string& value) {
+    std::vector<uint64_t> mask;
+    caep::ColumnMatcher::DefaultMatch(section, 1, value, section.symbols->Find(value), mask);
+    return caep::ColumnMatcher::CountRows(mask);
+}
+
+} // namespace
+
+int main() {
+    caep::Model* model = caep::Model::NewModelFromFile("../../example/basic_rbac_model.ini");
+    for(int i = 0; i < row_count; ++i) {
+        std::string res = i % 100 == 0 ? "/topic/" + std::to_string(i / 100) + "/*" : "/topic/" + std::to_string(i % 1000);
+        model->AddPolicy("a", "a", {"u" + std::to_string(i), res, "read"});
+    }
+    const auto& section = *model->m["a"].section_map["a"];
+
+    for(const std::string value : {"/topic/7", "/topic/7/post/1"}) {
+        double before = RowsPerSecond(section, value, PerRow);
+        double after = RowsPerSecond(section, value, PerColumn);
+        std::cout << value
+                  << "\tDefaultMatcher per row: " << before << " rows/s"
+                  << "\tColumnMatcher: " << after << " rows/s" << std::endl;
+    }
+    return 0;
+}
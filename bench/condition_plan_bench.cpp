@@ -0,0 +1,42 @@
+#include <chrono>
+#include <iostream>
+#include <caep/caep.h>
+#include "./bench_util.h"
+
+namespace {
+
+template<typename Func>
+double TimeUs(int rounds, Func func) {
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < rounds; ++i)
+        func();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(stop - start).count() / rounds;
+}
+
+void BenchConditionPlan(int rule_count, int rounds) {
+    auto c = bench::NewCaeper(rule_count);
+    std::string condition = c->GetModel()->m["c"].section_map["c"]->value;
+    std::vector<std::string> req{"Bob", "data1", "read"};
+
+    // The first synthetic rule allows early_req, AllowPriority is final before the other rules are evaluated.
+    std::vector<std::string> early_req{"user0", "data0", "read"};
+
+    double compiled = TimeUs(rounds, [&]() { c->Caep(req); });
+    double interpreted = TimeUs(rounds, [&]() { c->CaepWithMatcher(condition, req); });
+    double early = TimeUs(rounds, [&]() { c->Caep(early_req); });
+
+    std::cout << "rules: " << rule_count
+              << "\tcompiled plan: " << compiled << " us"
+              << "\tcompile per call: " << interpreted << " us"
+              << "\tallowed by first rule: " << early << " us" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    BenchConditionPlan(10, 20000);
+    BenchConditionPlan(1000, 2000);
+    BenchConditionPlan(10000, 200);
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <caep/caep.h>
+
+namespace {
+
+const std::string model = "../../example/basic_rbac_model.ini";
+const std::string policy = "filtered_load_bench.csv";
+
+// Writes rule_count rules of 1000 roles, a filter on one role keeps a thousandth of them.
+void WritePolicy(int rule_count) {
+    std::ofstream out(policy);
+    for(int i = 0; i < rule_count; ++i)
+        out << "a, role" << i % 1000 << ", data" << i % 5000 << ", " << (i % 2 ? "read" : "write") << "\n";
+}
+
+template<typename Func>
+double TimeMs(Func func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+    caep::Filter filter;
+    filter.A = {"role7"};
+
+    for(int rule_count : {100000, 1000000, 5000000}) {
+        WritePolicy(rule_count);
+        caep::FilteredFileAdapter scanning(policy);
+        caep::FilteredFileAdapter indexed(policy, true);
+        std::remove(indexed.IndexPath().c_str());
+
+        // Every load goes to a fresh model, so that no time is spent freeing the rules of the last one.
+        std::vector<std::unique_ptr<caep::Model>> models;
+        auto load = [&](caep::FilteredFileAdapter& adapter) {
+            models.emplace_back(caep::Model::NewModelFromFile(model));
+            caep::Model* loaded = models.back().get();
+            double ms = TimeMs([&]() { adapter.LoadFilteredPolicy(loaded, &filter); });
+            return std::make_pair(ms, loaded->GetPolicy("a", "a"));
+        };
+
+        auto scan = load(scanning);
+        auto build = load(indexed);
+        auto warm = load(indexed);
+        // A fresh adapter maps the saved index instead of building it.
+        caep::FilteredFileAdapter reopened(policy, true);
+        auto saved = load(reopened);
+
+        if(scan.second != build.second || scan.second != warm.second || scan.second != saved.second)
+            std::cout << "policies differ" << std::endl;
+        std::cout << "rules: " << rule_count
+                  << "\tloaded: " << scan.second.size()
+                  << "\tscan: " << scan.first << " ms"
+                  << "\tindex build: " << build.first << " ms"
+                  << "\tsaved index: " << saved.first << " ms"
+                  << "\tloaded index: " << warm.first << " ms" << std::endl;
+        std::remove(indexed.IndexPath().c_str());
+    }
+    std::remove(policy.c_str());
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <chrono>
+#include <iostream>
+#include <caep/caep.h>
+#include <caep/ip_parser/parser/parseCIDR.h>
+#include <caep/ip_parser/parser/parseIP.h>
+
+namespace {
+
+const int calls = 1000000;
+
+const std::vector<std::string> ips = {
+    "192.168.2.1", "10.0.0.1", "2001:db8::1", "::ffff:192.168.2.1", "fe80::1:2:3:4"
+};
+
+const std::vector<std::string> cidrs = {
+    "192.168.2.0/24", "10.0.0.0/8", "2001:db8::/32", "fe80::/10", "172.16.0.0/12"
+};
+
+// Parses the strings round robin, returns parses per second.
+template<typename Func>
+double ParsesPerSecond(const std::vector<std::string>& strs, Func func) {
+    size_t legal = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < calls; ++i)
+        legal += func(strs[i % strs.size()]);
+    auto stop = std::chrono::steady_clock::now();
+
+    if(legal == size_t(calls) + 1)
+        std::cout << legal << std::endl;
+    return calls / std::chrono::duration<double>(stop - start).count();
+}
+
+// parseIP as it was, the IPv4 and IPv6 parsers that copy the string for every octet.
+bool LegacyParseIP(const std::string& s) {
+    if(s[s.find_first_of(".:")] == '.')
+        return caep::parseIPv4(s).isLegal;
+    return caep::parseIPv6(s).isLegal;
+}
+
+} // namespace
+
+int main() {
+    double legacy = ParsesPerSecond(ips, LegacyParseIP);
+    double wrapped = ParsesPerSecond(ips, [](const std::string& s) {
+        return caep::parseIP(s).isLegal;
+    });
+    double in_place = ParsesPerSecond(ips, [](const std::string& s) {
+        caep::IPAddr addr;
+        return caep::parseIPAddr(s, addr);
+    });
+    std::cout << "addresses"
+              << "\tparseIPv4/parseIPv6: " << legacy << " parses/s"
+              << "\tparseIP: " << wrapped << " parses/s"
+              << "\tparseIPAddr: " << in_place << " parses/s" << std::endl;
+
+    wrapped = ParsesPerSecond(cidrs, [](const std::string& s) {
+        return caep::parseCIDR(s).ip.isLegal;
+    });
+    in_place = ParsesPerSecond(cidrs, [](const std::string& s) {
+        caep::IPAddr addr;
+        int bits;
+        return caep::parseCIDRAddr(s, addr, bits);
+    });
+    std::cout << "CIDRs"
+              << "\tparseCIDR: " << wrapped << " parses/s"
+              << "\tparseCIDRAddr: " << in_place << " parses/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <caep/caep.h>
+#include <caep/util/mapped_file.h>
+
+namespace {
+
+const std::string model = "../../example/basic_rbac_model.ini";
+const std::string policy = "parallel_policy_load_bench.csv";
+
+// Writes rule_count rules, a tenth of them role links, with 100000 users, 1000 roles and data.
+void WritePolicy(int rule_count) {
+    std::ofstream out(policy);
+    for(int i = 0; i < rule_count; ++i) {
+        if(i % 10 == 9)
+            out << "r, user" << i % 100000 << ", role" << i % 1000 << "\n";
+        else
+            out << "a, role" << i % 1000 << ", data" << i << ", " << (i % 2 ? "read" : "write") << "\n";
+    }
+}
+
+template<typename Func>
+double TimeMs(Func func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+// Rule counts are given as arguments, 1M and 5M by default.
+int main(int argc, char** argv) {
+    std::vector<int> rule_counts;
+    for(int i = 1; i < argc; ++i)
+        rule_counts.push_back(std::atoi(argv[i]));
+    if(rule_counts.empty())
+        rule_counts = {1000000, 5000000};
+
+    for(int rule_count : rule_counts) {
+        WritePolicy(rule_count);
+        caep::MappedFile file(policy);
+
+        std::vector<std::vector<std::string>> expected;
+        for(size_t thread_count : {size_t(1), size_t(2), size_t(4), size_t(8), size_t(16)}) {
+            std::unique_ptr<caep::Model> m(caep::Model::NewModelFromFile(model));
+            double ms = TimeMs([&]() {
+                if(thread_count == 1)
+                    caep::LoadPolicyText(file.View(), m.get());
+                else
+                    caep::LoadPolicyTextParallel(file.View(), m.get(), thread_count);
+            });
+
+            auto rules = m->GetPolicy("a", "a");
+            if(thread_count == 1)
+                expected = rules;
+            else if(rules != expected)
+                std::cout << "policies differ" << std::endl;
+            std::cout << "rules: " << rule_count
+                      << "\tthreads: " << thread_count
+                      << "\tload: " << ms << " ms"
+                      << "\trules/s: " << rule_count / ms * 1000 << std::endl;
+        }
+    }
+    std::remove(policy.c_str());
+    return 0;
+}
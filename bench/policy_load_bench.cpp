@@ -0,0 +1,72 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <caep/caep.h>
+#include <caep/util/caep_util.h>
+
+namespace {
+
+const std::string model = "../../example/basic_rbac_model.ini";
+const std::string policy = "policy_load_bench.csv";
+
+// Writes line_count rules, a tenth of them role links, with as many users as rules.
+void WritePolicy(int line_count) {
+    std::ofstream out(policy);
+    out << "# generated by policy_load_bench\n";
+    for(int i = 0; i < line_count; ++i) {
+        if(i % 10 == 9)
+            out << "r, user" << i << ", role" << i % 50 << "\n";
+        else
+            out << "a, user" << i << ", data" << i % 1000 << ", " << (i % 2 ? "read" : "write") << "\n";
+    }
+}
+
+// LoadPolicyLine as it was, every field is split and trimmed into a string of its own.
+void LegacyLoadPolicyLine(std::string line, caep::Model* m) {
+    if(line == "" || line.find("#") == 0)
+        return;
+
+    auto tokens = CaepUtil::Split(line, ",", -1);
+    for(auto& t : tokens)
+        t = CaepUtil::Trim(t);
+
+    auto key = tokens[0];
+    auto sec = key.substr(0, 1);
+    std::vector<std::string> new_tokens(tokens.begin() + 1, tokens.end());
+    m->m[sec].section_map[key]->AddRule(new_tokens);
+}
+
+// Loads the policy into a fresh model, returns lines per second.
+template<typename Func>
+double LinesPerSecond(int line_count, Func func) {
+    std::unique_ptr<caep::Model> m(caep::Model::NewModelFromFile(model));
+    caep::FileAdapter adapter(policy);
+
+    auto start = std::chrono::steady_clock::now();
+    func(adapter, m.get());
+    auto stop = std::chrono::steady_clock::now();
+
+    if(m->m["a"].section_map["a"]->RuleCount() + m->m["r"].section_map["r"]->RuleCount() != size_t(line_count))
+        std::cout << "lost rules" << std::endl;
+    return line_count / std::chrono::duration<double>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+    for(int line_count : {10000, 100000, 1000000}) {
+        WritePolicy(line_count);
+        double legacy = LinesPerSecond(line_count, [](caep::FileAdapter& adapter, caep::Model* m) {
+            adapter.LoadPolicyFile(m, LegacyLoadPolicyLine);
+        });
+        double mapped = LinesPerSecond(line_count, [](caep::FileAdapter& adapter, caep::Model* m) {
+            adapter.LoadPolicy(m);
+        });
+        std::cout << "lines: " << line_count
+                  << "\tgetline: " << legacy << " lines/s"
+                  << "\tmmap: " << mapped << " lines/s" << std::endl;
+    }
+    std::remove(policy.c_str());
+    return 0;
+}
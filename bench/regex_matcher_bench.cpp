@@ -0,0 +1,56 @@
+#include <chrono>
+#include <iostream>
+#include <regex>
+#include <caep/caep.h>
+
+namespace {
+
+const int pattern_count = 100;
+const int calls = 100000;
+
+// RegexMatcher as it was, the pattern is compiled on every call.
+bool CompileEveryCall(std::string str1, std::string str2) {
+    std::regex regex_s(str2);
+    return regex_match(str1, regex_s);
+}
+
+// Matches every request against pattern_count policy cells, returns matches per second.
+template<typename Func>
+double MatchesPerSecond(const std::vector<std::string>& patterns, Func func) {
+    std::vector<std::string> reqs;
+    for(int i = 0; i < pattern_count; ++i)
+        reqs.push_back("/topic/" + std::to_string(i) + "/post/" + std::to_string(i * 7));
+
+    size_t matched = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < calls; ++i)
+        matched += func(reqs[i % pattern_count], patterns[(i / pattern_count + i) % pattern_count]);
+    auto stop = std::chrono::steady_clock::now();
+
+    if(matched == size_t(calls) + 1)
+        std::cout << matched << std::endl;
+    return calls / std::chrono::duration<double>(stop - start).count();
+}
+
+void BenchRegexMatcher(const std::string& name, const std::vector<std::string>& patterns) {
+    double before = MatchesPerSecond(patterns, CompileEveryCall);
+    double after = MatchesPerSecond(patterns, caep::RegexMatcher);
+
+    std::cout << name
+              << "\tcompiled per call: " << before << " matches/s"
+              << "\tRegexCache: " << after << " matches/s" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> regexes, literals;
+    for(int i = 0; i < pattern_count; ++i) {
+        regexes.push_back("/topic/" + std::to_string(i) + "/post/[0-9]+");
+        literals.push_back("/topic/" + std::to_string(i) + "/post/" + std::to_string(i * 7));
+    }
+
+    BenchRegexMatcher("regex cells", regexes);
+    BenchRegexMatcher("literal cells", literals);
+    return 0;
+}
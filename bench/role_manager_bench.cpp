@@ -0,0 +1,64 @@
+#include <chrono>
+#include <iostream>
+#include <caep/caep.h>
+
+namespace {
+
+const int role_count = 10000;
+const int group_count = 100;
+const int pattern_count = 100;
+const int calls = 200000;
+
+bool PrefixMatch(std::string name, std::string pattern) {
+    return pattern.back() == '*' && name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+}
+
+bool IsPrefixPattern(const std::string& name) {
+    return !name.empty() && name.back() == '*';
+}
+
+// Links role_count users to group_count groups, and with patterns also links pattern_count
+// prefix patterns such as "user12*" to the groups.
+void Fill(caep::DefaultRoleManager& rm, bool patterns) {
+    for(int i = 0; i < role_count; ++i)
+        rm.AddLink("user" + std::to_string(i), "group" + std::to_string(i % group_count));
+    for(int i = 0; patterns && i < pattern_count; ++i)
+        rm.AddLink("user" + std::to_string(i) + "*", "group" + std::to_string(i % group_count));
+}
+
+// Returns the nanoseconds per HasLink call, cycling over the users.
+double NsPerHasLink(caep::DefaultRoleManager& rm) {
+    std::vector<std::string> users, groups;
+    for(int i = 0; i < role_count; ++i) {
+        users.push_back("user" + std::to_string(i));
+        groups.push_back("group" + std::to_string((i + 1) % group_count));
+    }
+
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < calls; ++i)
+        found += rm.HasLink(users[i % role_count], groups[i % role_count]);
+    auto stop = std::chrono::steady_clock::now();
+
+    if(found == size_t(calls) + 1)
+        std::cout << found << std::endl;
+    return std::chrono::duration<double, std::nano>(stop - start).count() / calls;
+}
+
+void BenchRoleManager(const std::string& name, bool patterns, caep::PatternFunc is_pattern, bool match) {
+    caep::DefaultRoleManager rm(10);
+    if(match)
+        rm.AddMatchingFunc(PrefixMatch, is_pattern);
+    Fill(rm, patterns);
+    std::cout << name << ": " << NsPerHasLink(rm) << " ns/HasLink" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    BenchRoleManager("no matching function", false, nullptr, false);
+    BenchRoleManager("matching function, no patterns", false, IsPrefixPattern, true);
+    BenchRoleManager("matching function, patterns", true, IsPrefixPattern, true);
+    BenchRoleManager("matching function, every role a pattern", true, nullptr, true);
+    return 0;
+}
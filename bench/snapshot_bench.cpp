@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <caep/caep.h>
+
+namespace {
+
+const std::string model = "../../example/basic_rbac_model.ini";
+const std::string policy = "snapshot_bench.csv";
+const std::string snapshot = "snapshot_bench.caep";
+
+// Writes rule_count rules, a tenth of them role links, with users in 50 roles under 5 groups.
+void WritePolicy(int rule_count) {
+    std::ofstream out(policy);
+    for(int i = 0; i < rule_count; ++i) {
+        if(i % 10 == 9)
+            out << "r, user" << i << ", role" << i % 50 << "\n";
+        else
+            out << "a, role" << i % 50 << ", data" << i % 1000 << ", " << (i % 2 ? "read" : "write") << "\n";
+    }
+    for(int i = 0; i < 50; ++i)
+        out << "r, role" << i << ", group" << i % 5 << "\n";
+}
+
+template<typename Func>
+double TimeMs(Func func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+int main() {
+    for(int rule_count : {10000, 100000, 500000}) {
+        WritePolicy(rule_count);
+
+        std::unique_ptr<caep::Caeper> from_csv;
+        double csv = TimeMs([&]() {
+            from_csv.reset(new caep::Caeper(model, policy));
+        });
+        from_csv->SaveSnapshotFile(snapshot);
+
+        caep::Caeper from_snapshot;
+        double mapped = TimeMs([&]() {
+            from_snapshot.LoadSnapshotFile(snapshot);
+        });
+
+        std::vector<std::string> req{"user9", "data9", "read"};
+        if(from_csv->Caep(req) != from_snapshot.Caep(req))
+            std::cout << "decisions differ" << std::endl;
+        std::cout << "rules: " << rule_count
+                  << "\tmodel + CSV: " << csv << " ms"
+                  << "\tsnapshot: " << mapped << " ms" << std::endl;
+    }
+    std::remove(policy.c_str());
+    std::remove(snapshot.c_str());
+    return 0;
+}
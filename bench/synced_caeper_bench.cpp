@@ -0,0 +1,62 @@
+#include <chrono>
+#include <iostream>
+#include <caep/caep.h>
+#include <caep/log/thread_util/thread.h>
+#include <caep/log/thread_util/mutex_lock.h>
+#include "./bench_util.h"
+
+namespace {
+
+const int rule_count = 10000;
+const int calls_per_thread = 20000;
+
+// Runs func calls_per_thread times on each of thread_count threads, returns calls per second.
+template<typename Func>
+double Throughput(int thread_count, Func func) {
+    std::vector<std::unique_ptr<caep::Thread>> threads;
+    for(int i = 0; i < thread_count; ++i) {
+        threads.emplace_back(new caep::Thread([&func, i]() {
+            std::vector<std::string> req{"user" + std::to_string(i), "data" + std::to_string(i % 100), "read"};
+            for(int j = 0; j < calls_per_thread; ++j)
+                func(req);
+        }));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(auto& thread : threads)
+        thread->Start();
+    for(auto& thread : threads)
+        thread->Join();
+    auto stop = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(stop - start).count();
+    return thread_count * calls_per_thread / seconds;
+}
+
+void BenchSyncedCaeper(int thread_count) {
+    auto synced = bench::NewCaeper<caep::SyncedCaeper>(rule_count);
+    double shared = Throughput(thread_count, [&](const std::vector<std::string>& req) {
+        synced->Caep(req);
+    });
+
+    auto plain = bench::NewCaeper<caep::Caeper>(rule_count);
+    caep::MutexLock mutex;
+    double exclusive = Throughput(thread_count, [&](const std::vector<std::string>& req) {
+        caep::MutexLockGuard guard(mutex);
+        plain->Caep(req);
+    });
+
+    std::cout << "threads: " << thread_count
+              << "\tSyncedCaeper: " << shared << " calls/s"
+              << "\tCaeper with a mutex: " << exclusive << " calls/s" << std::endl;
+}
+
+} // namespace
+
+int main() {
+    BenchSyncedCaeper(1);
+    BenchSyncedCaeper(2);
+    BenchSyncedCaeper(4);
+    BenchSyncedCaeper(8);
+    return 0;
+}
@@ -1,28 +1,241 @@
 #ifndef CAEP_ADAPTER_CPP
 #define CAEP_ADAPTER_CPP
 
+#include <exception>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
 #include "./adapter.h"
-#include "../util/caep_util.h"
+#include "../exception/adapter_exception.h"
+#include "../log/thread_util/thread.h"
 
 namespace caep {
 
+// Same characters as CaepUtil::Trim trims.
+static const std::string_view WHITESPACE = "\n\r\t\v\f ";
+
+static std::string_view TrimView(std::string_view str) {
+    size_t begin = str.find_first_not_of(WHITESPACE);
+    if(begin == std::string_view::npos)
+        return std::string_view();
+    size_t end = str.find_last_not_of(WHITESPACE);
+    return str.substr(begin, end - begin + 1);
+}
+
+// PolicySection returns the Section of a policy type, with a SymbolTable, or throws AdapterException.
+static Section* PolicySection(Model* model, std::string_view key) {
+    std::string sec(key.substr(0, 1));
+    if(model->m.find(sec) == model->m.end())
+        model->m[sec] = SectionMap();
+
+    auto it = model->m[sec].section_map.find(std::string(key));
+    if(it == model->m[sec].section_map.end() || it->second == nullptr)
+        throw AdapterException("unknown policy type: " + std::string(key));
+
+    Section* section = it->second.get();
+    if(section->symbols == nullptr)
+        section->symbols = std::make_shared<SymbolTable>();
+    return section;
+}
+
 // LoadPolicyLine loads a text line as a policy rule to model.
 void LoadPolicyLine(std::string line, Model* model) {
-    if(line == "" || line.find("#") == 0)
-        return;
+    LoadPolicyText(line, model);
+}
 
-    auto tokens = CaepUtil::Split(line, ",", -1);
-    for(auto& t : tokens)
-        t = CaepUtil::Trim(t);
+// TokenizePolicyLine cuts a line of a policy file into its trimmed fields, the policy type first,
+// as views of line. It returns false for a blank line or a comment, which hold no rule.
+bool TokenizePolicyLine(std::string_view line, std::vector<std::string_view>& tokens) {
+    tokens.clear();
+    line = TrimView(line);
+    if(line.empty() || line[0] == '#')
+        return false;
 
-    auto key = tokens[0];
-    auto sec = key.substr(0, 1);
-    std::vector<std::string> new_tokens(tokens.begin() + 1, tokens.end());
+    for(size_t comma = line.find(','); ; comma = line.find(',')) {
+        tokens.push_back(TrimView(line.substr(0, comma)));
+        if(comma == std::string_view::npos)
+            return true;
+        line = line.substr(comma + 1);
+    }
+}
 
-    if(model->m.find(sec) == model->m.end())
-        model->m[sec] = SectionMap();
+// LoadPolicyText loads every line of text as LoadPolicyLine does. The fields are cut out of text as
+// string_views and interned straight into the columns of their Section, no string is built for
+// a field already in the SymbolTable.
+void LoadPolicyText(std::string_view text, Model* model) {
+    std::string_view last_key;
+    Section* section = nullptr;
+    std::vector<std::string_view> tokens;
+    std::vector<symbol_t> ids;
+
+    while(!text.empty()) {
+        size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+
+        if(!TokenizePolicyLine(line, tokens))
+            continue;
+
+        // Lines of a file are mostly grouped by their type, the Section is only looked up on a change.
+        std::string_view key = tokens[0];
+        if(section == nullptr || key != last_key) {
+            section = PolicySection(model, key);
+            last_key = key;
+        }
+
+        ids.clear();
+        for(size_t i = 1; i < tokens.size(); ++i)
+            ids.push_back(section->symbols->Intern(tokens[i]));
+        section->AddRuleIds(ids);
+    }
+}
+
+namespace {
+
+// A PolicyChunk is a run of whole lines that a worker tokenizes. Its strings are numbered in the
+// order they first appear, and every rule is stored in cells as the number of its type, the count
+// of its fields and the numbers of its fields.
+class PolicyChunk {
+public:
+    std::string_view text;
+    std::vector<std::string_view> names;
+    std::vector<uint32_t> cells;
+    std::exception_ptr error;
+
+    void Tokenize() {
+        std::unordered_map<std::string_view, uint32_t> numbers;
+        std::vector<std::string_view> tokens;
+        auto number = [&](std::string_view name) {
+            auto it = numbers.emplace(name, uint32_t(names.size()));
+            if(it.second)
+                names.push_back(name);
+            return it.first->second;
+        };
+
+        std::string_view rest = text;
+        while(!rest.empty()) {
+            size_t eol = rest.find('\n');
+            std::string_view line = rest.substr(0, eol);
+            rest = eol == std::string_view::npos ? std::string_view() : rest.substr(eol + 1);
+
+            if(!TokenizePolicyLine(line, tokens))
+                continue;
+            cells.push_back(number(tokens[0]));
+            cells.push_back(uint32_t(tokens.size() - 1));
+            for(size_t i = 1; i < tokens.size(); ++i)
+                cells.push_back(number(tokens[i]));
+        }
+    }
+};
+
+} // namespace
+
+// LoadPolicyTextParallel loads text as LoadPolicyText does with thread_count threads, 0 for one per
+// core. The text is cut into chunks of whole lines that are tokenized in parallel, then the chunks
+// are merged in file order, so symbols get the ids and rules the rows that LoadPolicyText gives.
+void LoadPolicyTextParallel(std::string_view text, Model* model, size_t thread_count) {
+    if(thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    // A chunk below this size costs more to hand to a thread than to tokenize.
+    const size_t MIN_CHUNK_SIZE = 1 << 16;
+    thread_count = std::min(thread_count, text.size() / MIN_CHUNK_SIZE + 1);
+    if(thread_count <= 1)
+        return LoadPolicyText(text, model);
+
+    std::vector<PolicyChunk> chunks(thread_count);
+    size_t begin = 0;
+    for(size_t i = 0; i < thread_count; ++i) {
+        size_t end = i + 1 == thread_count ? text.size() : std::max(begin, text.size() * (i + 1) / thread_count);
+        end = end < text.size() ? text.find('\n', end) : text.size();
+        end = end == std::string_view::npos ? text.size() : end + 1;
+        chunks[i].text = text.substr(begin, end - begin);
+        begin = end;
+    }
+
+    std::vector<std::unique_ptr<Thread>> workers;
+    for(size_t i = 1; i < thread_count; ++i) {
+        PolicyChunk* chunk = &chunks[i];
+        workers.emplace_back(new Thread([chunk]() {
+            try {
+                chunk->Tokenize();
+            }
+            catch(...) {
+                chunk->error = std::current_exception();
+            }
+        }, "PolicyLoader"));
+        workers.back()->Start();
+    }
+    chunks[0].Tokenize();
+    for(auto& worker : workers)
+        worker->Join();
+
+    // The numbers of a chunk are mapped to the ids of every SymbolTable its rules go to, a string is
+    // interned when a rule first holds it, as LoadPolicyText interns it. The rules of every Section
+    // are gathered in columns and appended at once, so that the Section indexes them in parallel.
+    std::vector<Section*> sections;
+    std::unordered_map<Section*, std::pair<std::vector<std::vector<symbol_t>>, size_t>> rows;
+    auto append = [&]() {
+        for(Section* section : sections)
+            section->AppendRules(rows[section].first, rows[section].second, thread_count);
+    };
+
+    size_t name_count = 0;
+    for(const auto& chunk : chunks)
+        name_count += chunk.names.size();
+    model->symbols->Reserve(model->symbols->Size() + name_count);
+
+    try {
+        std::string_view last_key;
+        Section* section = nullptr;
+        std::vector<symbol_t>* ids = nullptr;
+        std::vector<std::vector<symbol_t>>* columns = nullptr;
+        size_t* row_count = nullptr;
+        for(auto& chunk : chunks) {
+            if(chunk.error)
+                std::rethrow_exception(chunk.error);
+
+            std::unordered_map<SymbolTable*, std::vector<symbol_t>> tables;
+            section = nullptr;
+            for(size_t cell = 0; cell < chunk.cells.size(); ) {
+                std::string_view key = chunk.names[chunk.cells[cell]];
+                uint32_t field_count = chunk.cells[cell + 1];
+                cell += 2;
+
+                if(section == nullptr || key != last_key) {
+                    section = PolicySection(model, key);
+                    last_key = key;
+                    ids = &tables[section->symbols.get()];
+                    ids->resize(chunk.names.size(), NO_SYMBOL);
+                    if(rows.count(section) == 0)
+                        sections.push_back(section);
+                    columns = &rows[section].first;
+                    row_count = &rows[section].second;
+                }
 
-    (model->m[sec].section_map[key]->policy).push_back(new_tokens);
+                if(columns->size() < field_count)
+                    columns->resize(field_count, std::vector<symbol_t>(*row_count, NO_SYMBOL));
+                for(size_t i = 0; i < columns->size(); ++i) {
+                    symbol_t id = NO_SYMBOL;
+                    if(i < field_count) {
+                        symbol_t& interned = (*ids)[chunk.cells[cell + i]];
+                        if(interned == NO_SYMBOL)
+                            interned = section->symbols->Intern(chunk.names[chunk.cells[cell + i]]);
+                        id = interned;
+                    }
+                    (*columns)[i].push_back(id);
+                }
+                cell += field_count;
+                ++*row_count;
+            }
+        }
+    }
+    catch(...) {
+        // The rules before a bad line are kept, as LoadPolicyText keeps them.
+        append();
+        throw;
+    }
+    append();
 }
 
 } // namespace caep 
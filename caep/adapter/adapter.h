@@ -2,6 +2,7 @@
 #define CAEP_ADAPTER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "../model/model.h"
@@ -10,6 +11,12 @@ namespace caep {
 
 void LoadPolicyLine(std::string line, Model* model);
 
+void LoadPolicyText(std::string_view text, Model* model);
+
+void LoadPolicyTextParallel(std::string_view text, Model* model, size_t thread_count = 0);
+
+bool TokenizePolicyLine(std::string_view line, std::vector<std::string_view>& tokens);
+
 class Adapter {
 public:
     std::string file_path;
@@ -1,20 +1,271 @@
 #ifndef CAEP_BATCH_FILE_ADAPTER_CPP
 #define CAEP_BATCH_FILE_ADAPTER_CPP
 
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+
 #include "./batch_file_adapter.h"
-#include "../../exception/unsupported_operation_exception.h"
+#include "../../exception/caep_exception.h"
+#include "../../util/caep_util.h"
+#include "../../util/mapped_file.h"
 
 namespace caep {
 
-BatchFileAdapter::BatchFileAdapter(std::string file_path) : FileAdapter(file_path) {
+namespace {
+
+void WriteAll(int fd, const char* data, size_t size) {
+    while(size > 0) {
+        ssize_t written = write(fd, data, size);
+        if(written < 0)
+            throw IOException("Cannot write file.");
+        data += written;
+        size -= size_t(written);
+    }
+}
+
+// RuleKey joins the policy type and the sorted fields of a rule by a byte no field holds, rules
+// are equal whatever the order of their fields as CaepUtil::ArrayEqual compares them.
+std::string RuleKey(std::string_view p_type, std::vector<std::string> rule) {
+    std::sort(rule.begin(), rule.end());
+    std::string key(p_type);
+    for(const auto& field : rule) {
+        key += '\x1f';
+        key += field;
+    }
+    return key;
+}
+
+// A Line is a line of the policy file, tokens is empty for a blank line or a comment.
+class Line {
+public:
+    std::string text;
+    std::vector<std::string> tokens;
+
+    bool Matches(const std::string& p_type, int field_index, const std::vector<std::string>& field_values) const {
+        if(tokens.empty() || tokens[0] != p_type)
+            return false;
+        for(size_t i = 0; i < field_values.size(); ++i) {
+            size_t at = 1 + field_index + i;
+            if(field_values[i] != "" && (at >= tokens.size() || tokens[at] != field_values[i]))
+                return false;
+        }
+        return true;
+    }
+
+    // Key is the RuleKey of the rule on the line.
+    std::string Key() const {
+        return RuleKey(tokens[0], std::vector<std::string>(tokens.begin() + 1, tokens.end()));
+    }
+};
+
+} // namespace
+
+BatchFileAdapter::BatchFileAdapter(std::string file_path, bool sync)
+    : FileAdapter(file_path), m_sync(sync), m_committed(m_lock), m_committing(false), m_groups(0) {
+}
+
+// Commit queues a change and returns once a commit wrote it, the caller leads that commit if no
+// other is running. The leader writes without the lock, so changes keep queuing for the next group.
+void BatchFileAdapter::Commit(Change change) {
+    if(this->file_path == "")
+        throw AdapterException("Invalid file path, file path cannot be empty");
+
+    auto ticket = std::make_shared<Ticket>();
+    MutexLockGuard guard(m_lock);
+    m_pending.emplace_back(std::move(change), ticket);
+
+    while(!ticket->done) {
+        if(m_committing) {
+            m_committed.Wait();
+            continue;
+        }
+
+        Group group;
+        group.swap(m_pending);
+        m_committing = true;
+        m_lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            WriteGroup(group);
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+
+        m_lock.lock();
+        for(auto& pending : group) {
+            pending.second->done = true;
+            pending.second->error = error;
+        }
+        ++m_groups;
+        m_committing = false;
+        m_committed.NotifyAll();
+    }
+
+    if(ticket->error)
+        std::rethrow_exception(ticket->error);
+}
+
+void BatchFileAdapter::WriteGroup(const Group& group) {
+    for(const auto& pending : group) {
+        if(pending.first.kind != Change::ADD)
+            return RewriteFile(group);
+    }
+    AppendRules(group);
+}
+
+// AppendRules writes the lines of every added rule of the group with a single write.
+void BatchFileAdapter::AppendRules(const Group& group) {
+    int fd = open(this->file_path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(fd < 0)
+        throw IOException("Cannot open file.");
+
+    // SavePolicy leaves no newline after the last line.
+    std::string text;
+    struct stat st;
+    char last = '\n';
+    if(fstat(fd, &st) == 0 && st.st_size > 0 && pread(fd, &last, 1, st.st_size - 1) == 1 && last != '\n')
+        text += '\n';
+
+    for(const auto& pending : group) {
+        for(const auto& rule : pending.first.rules) {
+            text += pending.first.p_type + ", ";
+            text += CaepUtil::ArrayToString(rule);
+            text += '\n';
+        }
+    }
+
+    try {
+        WriteAll(fd, text.data(), text.size());
+    }
+    catch(...) {
+        close(fd);
+        throw;
+    }
+    if(m_sync)
+        fdatasync(fd);
+    close(fd);
+}
+
+// RewriteFile applies the changes of the group in order to the lines of the policy file, then
+// replaces the file. Comments and blank lines are kept.
+void BatchFileAdapter::RewriteFile(const Group& group) {
+    std::vector<Line> lines;
+    struct stat st;
+    if(stat(this->file_path.c_str(), &st) == 0) {
+        MappedFile file(this->file_path);
+        std::string_view text = file.View();
+        std::vector<std::string_view> tokens;
+        while(!text.empty()) {
+            size_t eol = text.find('\n');
+            std::string_view line = text.substr(0, eol);
+            text = eol == std::string_view::npos ? std::string_view() : text.substr(eol + 1);
+
+            Line parsed;
+            parsed.text = std::string(line);
+            if(TokenizePolicyLine(line, tokens))
+                parsed.tokens.assign(tokens.begin(), tokens.end());
+            lines.push_back(std::move(parsed));
+        }
+    }
+
+    for(const auto& pending : group) {
+        const Change& change = pending.first;
+        if(change.kind == Change::ADD) {
+            for(const auto& rule : change.rules) {
+                Line added;
+                added.text = change.p_type + ", " + CaepUtil::ArrayToString(rule);
+                added.tokens.push_back(change.p_type);
+                added.tokens.insert(added.tokens.end(), rule.begin(), rule.end());
+                lines.push_back(std::move(added));
+            }
+            continue;
+        }
+
+        std::unordered_set<std::string> removed;
+        if(change.kind == Change::REMOVE) {
+            for(const auto& rule : change.rules)
+                removed.insert(RuleKey(change.p_type, rule));
+        }
+
+        size_t kept = 0;
+        for(size_t i = 0; i < lines.size(); ++i) {
+            bool drop = change.kind == Change::REMOVE
+                ? !lines[i].tokens.empty() && removed.count(lines[i].Key()) > 0
+                : lines[i].Matches(change.p_type, change.field_index, change.rules[0]);
+            if(!drop) {
+                if(kept != i)
+                    lines[kept] = std::move(lines[i]);
+                ++kept;
+            }
+        }
+        lines.resize(kept);
+    }
+
+    std::string text;
+    for(const auto& line : lines) {
+        text += line.text;
+        text += '\n';
+    }
+
+    std::string tmp_path = this->file_path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0)
+        throw IOException("Cannot open file.");
+    try {
+        WriteAll(fd, text.data(), text.size());
+    }
+    catch(...) {
+        close(fd);
+        throw;
+    }
+    if(m_sync)
+        fsync(fd);
+    close(fd);
+
+    if(std::rename(tmp_path.c_str(), this->file_path.c_str()) != 0)
+        throw IOException("Cannot replace policy file.");
+}
+
+void BatchFileAdapter::SavePolicy(Model* model) {
+    MutexLockGuard guard(m_lock);
+    while(m_committing)
+        m_committed.Wait();
+
+    // Changes queued meanwhile are committed over the saved file by their callers.
+    FileAdapter::SavePolicy(model);
+}
+
+void BatchFileAdapter::AddPolicy(std::string sec, std::string p_type, std::vector<std::string> rule) {
+    Commit({Change::ADD, p_type, 0, {rule}});
+}
+
+void BatchFileAdapter::RemovePolicy(std::string sec, std::string p_type, std::vector<std::string> rule) {
+    Commit({Change::REMOVE, p_type, 0, {rule}});
+}
+
+void BatchFileAdapter::RemoveFilteredPolicy(std::string sec, std::string p_type, int field_index, std::vector<std::string> field_values) {
+    Commit({Change::REMOVE_FILTERED, p_type, field_index, {field_values}});
 }
 
 void BatchFileAdapter::AddPolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules) {
-    throw UnsupportedOperationException("not implemented");
+    if(!rules.empty())
+        Commit({Change::ADD, p_type, 0, std::move(rules)});
 }
 
 void BatchFileAdapter::RemovePolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules) {
-    throw UnsupportedOperationException("not implemented");
+    if(!rules.empty())
+        Commit({Change::REMOVE, p_type, 0, std::move(rules)});
+}
+
+size_t BatchFileAdapter::GroupCount() {
+    MutexLockGuard guard(m_lock);
+    return m_groups;
 }
 
 } // namespace caep 
@@ -1,18 +1,83 @@
 #ifndef CAEP_BATCH_FILE_ADAPTER_H
 #define CAEP_BATCH_FILE_ADAPTER_H
 
+#include <exception>
+#include <memory>
+
 #include "./file_adapter.h"
 #include "../batch_adapter.h"
+#include "../../log/thread_util/condition.h"
+#include "../../log/thread_util/mutex_lock.h"
 
 namespace caep {
 
+// BatchFileAdapter is a FileAdapter whose auto-save works, a batch of added rules is appended to
+// the policy file with one write and one fsync.
+//
+// Changes of concurrent callers are committed in groups. The first caller to find no commit
+// running becomes the leader and writes every change queued so far, the others wait until their
+// change is written by a leader. A group of additions is appended to the file, a group holding
+// any removal rewrites the file once and renames it in place. Every caller of a group sees the
+// exception of its commit.
+//
+// Groups only form when threads share the adapter directly. SyncedCaeper saves every change under
+// its exclusive policy lock, so through an enforcer each change is a group of its own.
 class BatchFileAdapter : public BatchAdapter, public FileAdapter {
+protected:
+    class Change {
+    public:
+        enum Kind { ADD, REMOVE, REMOVE_FILTERED };
+
+        Kind kind;
+        std::string p_type;
+        int field_index;
+        std::vector<std::vector<std::string>> rules;
+    };
+
+    class Ticket {
+    public:
+        bool done = false;
+        std::exception_ptr error;
+    };
+
+    typedef std::vector<std::pair<Change, std::shared_ptr<Ticket>>> Group;
+
+    // WriteGroup writes the changes of a group to the file, the leader calls it without the lock.
+    virtual void WriteGroup(const Group& group);
+
+private:
+    bool m_sync;
+    MutexLock m_lock;
+    Condition m_committed;
+    bool m_committing;
+    Group m_pending;
+    size_t m_groups;
+
+    void Commit(Change change);
+
+    void AppendRules(const Group& group);
+
+    void RewriteFile(const Group& group);
+
 public:
-    BatchFileAdapter(std::string file_path);
+    // sync is whether every commit is flushed to the disk before it returns.
+    BatchFileAdapter(std::string file_path, bool sync = true);
+
+    // SavePolicy rewrites the policy file once the running commit is done.
+    void SavePolicy(Model* model);
+
+    void AddPolicy(std::string sec, std::string p_type, std::vector<std::string> rule);
+
+    void RemovePolicy(std::string sec, std::string p_type, std::vector<std::string> rule);
+
+    void RemoveFilteredPolicy(std::string sec, std::string p_type, int field_index, std::vector<std::string> field_values);
 
     void AddPolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules);
 
     void RemovePolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules);
+
+    // GroupCount returns the count of commits written, concurrent changes share one.
+    size_t GroupCount();
 };
 
 } // namespace caep 
@@ -5,6 +5,7 @@
 
 #include "./file_adapter.h"
 #include "../../util/caep_util.h"
+#include "../../util/mapped_file.h"
 #include "../../exception/caep_exception.h"
 
 namespace caep {
@@ -12,12 +13,14 @@ namespace caep {
 FileAdapter::FileAdapter() {
     this->file_path = "";
     this->filtered = false;
+    this->load_threads = 0;
 }
 
 // NewAdapter is the constructor for Adapter.
 FileAdapter::FileAdapter(std::string file_path) {
     this->file_path = file_path;
     this->filtered = false;
+    this->load_threads = 0;
 }
 
 // LoadPolicy loads all policy rules from the storage.
@@ -25,7 +28,9 @@ void FileAdapter::LoadPolicy(Model* model) {
     if (this->file_path == "")
         throw AdapterException("Invalid file path, file path cannot be empty");
 
-    this->LoadPolicyFile(model, LoadPolicyLine);
+    // The file is mapped and tokenized in place, LoadPolicyFile copies every line into a string.
+    MappedFile file(this->file_path);
+    LoadPolicyTextParallel(file.View(), model, this->load_threads);
 }
 
 // SavePolicy saves all policy rules to the storage.
@@ -34,34 +39,24 @@ void FileAdapter::SavePolicy(Model* model) {
         throw AdapterException("Invalid file path, file path cannot be empty");
     }
 
-    std::string tmp;
-
-
-    for (auto it = model->m["a"].section_map.begin() ; it != model->m["a"].section_map.end() ; it++){
-        for (size_t i = 0; i < it->second->policy.size(); i++){
-            tmp += it->first + ", ";
-            tmp += CaepUtil::ArrayToString(it->second->policy[i]);
-            tmp += "\n";
-        }
-    }
+    return this->SavePolicyFile(PolicyText(model));
+}
 
-    for (auto it = model->m["r"].section_map.begin() ; it != model->m["r"].section_map.end() ; it++){
-        for (size_t i = 0; i < it->second->policy.size(); i++){
-            tmp += it->first + ", ";
-            tmp += CaepUtil::ArrayToString(it->second->policy[i]);
-            tmp += "\n";
-        }
-    }
+// PolicyText writes the rules of sections 'a', 'r' and 'm' as lines of a policy file.
+std::string FileAdapter::PolicyText(Model* model) {
+    std::string tmp;
 
-    for (auto it = model->m["m"].section_map.begin() ; it != model->m["m"].section_map.end() ; it++){
-        for (size_t i = 0; i < it->second->policy.size(); i++){
-            tmp += it->first + ", ";
-            tmp += CaepUtil::ArrayToString(it->second->policy[i]);
-            tmp += "\n";
+    for (const std::string sec : {"a", "r", "m"}) {
+        for (auto it = model->m[sec].section_map.begin() ; it != model->m[sec].section_map.end() ; it++){
+            for (const auto& rule : it->second->GetRules()){
+                tmp += it->first + ", ";
+                tmp += CaepUtil::ArrayToString(rule);
+                tmp += "\n";
+            }
         }
     }
 
-    return this->SavePolicyFile(CaepUtil::RTrim(tmp, "\n"));
+    return CaepUtil::RTrim(tmp, "\n");
 }
 
 void FileAdapter::LoadPolicyFile(Model* model, void (*handler)(std::string, Model*)) {
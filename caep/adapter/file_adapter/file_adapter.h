@@ -9,6 +9,9 @@ namespace caep {
 // It can load policy from file or save policy to file.
 class FileAdapter : virtual public Adapter {
 public:
+    // load_threads is the count of threads LoadPolicy parses the file with, 0 for one per core.
+    size_t load_threads;
+
     FileAdapter();
 
     // NewAdapter is the constructor for Adapter.
@@ -20,6 +23,9 @@ public:
     // SavePolicy saves all policy rules to the storage.
     void SavePolicy(Model* model);
 
+    // PolicyText returns the policy rules of model as SavePolicy writes them.
+    static std::string PolicyText(Model* model);
+
     void LoadPolicyFile(Model* model, void (*handler)(std::string, Model*));
 
     void SavePolicyFile(std::string text);
@@ -2,10 +2,12 @@
 #define CAEP_FILTERED_FILE_ADAPTER_CPP
 
 #include <fstream>
+#include <sys/stat.h>
 
 #include "./filtered_file_adapter.h"
 #include "../../exception/caep_exception.h"
 #include "../../util/caep_util.h"
+#include "../../util/mapped_file.h"
 
 namespace caep {
 
@@ -33,7 +35,7 @@ bool FilteredFileAdapter::filterWords(std::vector<std::string> line, std::vector
     if(line.size() < filter.size() + 1)
         return true;
 
-    bool skip_line;
+    bool skip_line = false;
     for(size_t i = 0; i < filter.size(); ++i) {
         if(filter[i].length() > 0 && CaepUtil::Trim(filter[i]) != CaepUtil::Trim(line[i+1])) {
             skip_line = true;
@@ -64,8 +66,38 @@ void FilteredFileAdapter::loadFilteredPolicyFile(Model* model , Filter* filter,
     out_file.close();
 }
 
+namespace {
+
+void StatFile(const std::string& path, uint64_t& size, int64_t& mtime) {
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0)
+        throw IOException("Cannot open file.");
+    size = uint64_t(st.st_size);
+    mtime = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+// loadIndexedPolicyFile reads only the lines the index finds for filter. An index that does not
+// match the policy file is reloaded from IndexPath, or rebuilt if that one is stale too.
+void FilteredFileAdapter::loadIndexedPolicyFile(Model* model, Filter* filter) {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    StatFile(this->file_path, size, mtime);
+    MappedFile file(this->file_path);
+
+    if(!m_index.Matches(size, mtime) && !m_index.Load(this->IndexPath(), size, mtime)) {
+        m_index.Build(file.View(), size, mtime);
+        m_index.Save(this->IndexPath());
+    }
+
+    for(uint32_t line : m_index.Match(*filter))
+        LoadPolicyText(m_index.Line(file.View(), line), model);
+}
+
 // FilteredFileAdapter is the constructor for FilteredFileAdapter.
-FilteredFileAdapter::FilteredFileAdapter(std::string file_path) : FileAdapter(file_path) {
+FilteredFileAdapter::FilteredFileAdapter(std::string file_path, bool use_index)
+    : FileAdapter(file_path), m_use_index(use_index) {
     this->filtered = true;
 }
 
@@ -78,12 +110,15 @@ void FilteredFileAdapter::LoadPolicy(Model* model) {
 // LoadFilteredPolicy loads only policy rules that match the filter.
 void FilteredFileAdapter::LoadFilteredPolicy(Model* model, Filter* filter) {
     if(filter == nullptr)
-        this->LoadPolicy(model);
+        return this->LoadPolicy(model);
 
     if(!this->file_path.compare("")) 
         throw AdapterException("Invalid file path, file path cannot be empty.");
 
-    this->loadFilteredPolicyFile(model, filter, LoadPolicyLine);
+    if(m_use_index)
+        this->loadIndexedPolicyFile(model, filter);
+    else
+        this->loadFilteredPolicyFile(model, filter, LoadPolicyLine);
     this->filtered = true;
 }
 
@@ -97,7 +132,23 @@ void FilteredFileAdapter::SavePolicy(Model* model) {
     if(this->filtered)
         throw AdapterException("Cannot save a filtered policy");
 
-    this->SavePolicy(model);
+    this->FileAdapter::SavePolicy(model);
+    if(m_use_index)
+        this->BuildIndex();
+}
+
+// BuildIndex indexes the policy file as it is now and saves the index beside it.
+void FilteredFileAdapter::BuildIndex() {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    StatFile(this->file_path, size, mtime);
+    MappedFile file(this->file_path);
+    m_index.Build(file.View(), size, mtime);
+    m_index.Save(this->IndexPath());
+}
+
+std::string FilteredFileAdapter::IndexPath() const {
+    return this->file_path + ".idx";
 }
 
 } // namespace caep 
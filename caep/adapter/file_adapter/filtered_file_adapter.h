@@ -2,22 +2,30 @@
 #define CAEP_FILTERED_FILE_ADAPTER_H
 
 #include "./file_adapter.h"
+#include "./policy_file_index.h"
 #include "../filtered_adapter.h"
 
 namespace caep {
 
+// With use_index, FilteredFileAdapter keeps a PolicyFileIndex of the policy file beside it, at
+// file_path + ".idx". SavePolicy rebuilds it, LoadFilteredPolicy builds it on demand when it is
+// missing or stale, then reads only the lines that the filter keeps.
 class FilteredFileAdapter : public FileAdapter, public FilteredAdapter {
 private:
+    bool m_use_index;
+    PolicyFileIndex m_index;
+
     static bool filterLine(std::string line, Filter* filter);
 
     static bool filterWords(std::vector<std::string> line, std::vector<std::string> filter);
 
     void loadFilteredPolicyFile(Model* model, Filter* filter, void (*handle)(std::string, Model*));
 
+    void loadIndexedPolicyFile(Model* model, Filter* filter);
 
 public:
     // FilteredFileAdapter is the constructor for FilteredAdapter.
-    FilteredFileAdapter(std::string file_path);
+    FilteredFileAdapter(std::string file_path, bool use_index = false);
 
     // LoadPolicy loads all policy rules from the storage.
     void LoadPolicy(Model* model);
@@ -31,6 +39,10 @@ public:
     // SavePolicy saves all policy rules to the storage.
     void SavePolicy(Model* model);
 
+    // BuildIndex indexes the policy file as it is now and saves the index beside it.
+    void BuildIndex();
+
+    std::string IndexPath() const;
 };
 
 } // namespace caep 
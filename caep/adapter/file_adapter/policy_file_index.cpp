@@ -0,0 +1,301 @@
+#ifndef CAEP_POLICY_FILE_INDEX_CPP
+#define CAEP_POLICY_FILE_INDEX_CPP
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+#include "./policy_file_index.h"
+#include "../../exception/caep_exception.h"
+#include "../../util/caep_util.h"
+#include "../../util/snapshot_io.h"
+
+namespace caep {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'A', 'E', 'P', 'F', 'I', 'D', 'X'};
+
+// The header is the magic, the version, the count of lines, the size and the modification time of
+// the policy file, the count of keys, the count of policy types and the checksum of the header.
+const size_t HEADER_SIZE = 48;
+const size_t CHECKED_SIZE = 40;
+
+// A key entry is the position and the length of the key, the count of its lines and their position.
+const size_t ENTRY_SIZE = 24;
+
+// The filter of a policy type, types other than 'a', 'r' and 'm' are never filtered.
+const std::vector<std::string>* TypeFilter(const Filter& filter, std::string_view p_type) {
+    if(p_type == "a")
+        return &filter.A;
+    if(p_type == "r")
+        return &filter.R;
+    if(p_type == "m")
+        return &filter.M;
+    return nullptr;
+}
+
+} // namespace
+
+PolicyFileIndex::PolicyFileIndex()
+    : m_file_size(0), m_file_mtime(0), m_line_count(0), m_key_count(0), m_type_count(0) {
+}
+
+template<typename T>
+T PolicyFileIndex::At(size_t pos) const {
+    if(pos + sizeof(T) > m_data.size())
+        throw IOException("Corrupted policy file index.");
+    T value;
+    std::memcpy(&value, m_data.data() + pos, sizeof(T));
+    return value;
+}
+
+// Open checks the header and that the arrays and the key table fit in data, the keys and their
+// lines are checked as they are read.
+bool PolicyFileIndex::Open(std::string_view data) {
+    if(data.size() < HEADER_SIZE || data.substr(0, sizeof(MAGIC)) != std::string_view(MAGIC, sizeof(MAGIC)))
+        return false;
+
+    SnapshotReader in(data);
+    in.GetBytes(sizeof(MAGIC));
+    uint32_t version = in.Get<uint32_t>();
+    uint32_t line_count = in.Get<uint32_t>();
+    uint64_t file_size = in.Get<uint64_t>();
+    int64_t file_mtime = in.Get<int64_t>();
+    uint32_t key_count = in.Get<uint32_t>();
+    uint32_t type_count = in.Get<uint32_t>();
+    if(version != VERSION || in.Get<uint64_t>() != Checksum(data.substr(0, CHECKED_SIZE)))
+        return false;
+    if(data.size() < HEADER_SIZE + size_t(line_count) * 16 + size_t(key_count) * ENTRY_SIZE + size_t(type_count) * 4)
+        return false;
+
+    m_data = data;
+    m_line_count = line_count;
+    m_file_size = file_size;
+    m_file_mtime = file_mtime;
+    m_key_count = key_count;
+    m_type_count = type_count;
+    return true;
+}
+
+std::string_view PolicyFileIndex::Key(uint32_t entry) const {
+    size_t at = HEADER_SIZE + size_t(m_line_count) * 16 + size_t(entry) * ENTRY_SIZE;
+    uint64_t pos = At<uint64_t>(at);
+    uint32_t size = At<uint32_t>(at + 8);
+    if(pos + size > m_data.size())
+        throw IOException("Corrupted policy file index.");
+    return m_data.substr(pos, size);
+}
+
+// Find returns the lines of key, found by binary search in the sorted key table.
+std::vector<uint32_t> PolicyFileIndex::Find(std::string_view key) const {
+    uint32_t low = 0;
+    uint32_t high = m_key_count;
+    while(low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if(Key(mid) < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if(low == m_key_count || Key(low) != key)
+        return {};
+
+    size_t at = HEADER_SIZE + size_t(m_line_count) * 16 + size_t(low) * ENTRY_SIZE;
+    uint32_t count = At<uint32_t>(at + 12);
+    uint64_t pos = At<uint64_t>(at + 16);
+    if(pos + uint64_t(count) * sizeof(uint32_t) > m_data.size())
+        throw IOException("Corrupted policy file index.");
+
+    std::vector<uint32_t> lines(count);
+    std::memcpy(lines.data(), m_data.data() + pos, count * sizeof(uint32_t));
+    return lines;
+}
+
+// The key of the lines of a policy type is the type itself, no posting key is that short.
+std::string PolicyFileIndex::PostingKey(std::string_view p_type, size_t field, std::string_view value) {
+    std::string key(p_type);
+    key += '\x1f';
+    key += std::to_string(field);
+    key += '\x1f';
+    key += value;
+    return key;
+}
+
+void PolicyFileIndex::Build(std::string_view text, uint64_t file_size, int64_t file_mtime) {
+    std::vector<uint64_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> field_counts;
+    std::unordered_map<std::string, std::vector<uint32_t>> postings;
+
+    std::vector<std::string_view> tokens;
+    size_t offset = 0;
+    while(offset < text.size()) {
+        size_t eol = text.find('\n', offset);
+        if(eol == std::string_view::npos)
+            eol = text.size();
+        std::string_view line = text.substr(offset, eol - offset);
+
+        if(TokenizePolicyLine(line, tokens)) {
+            uint32_t number = uint32_t(offsets.size());
+            offsets.push_back(offset);
+            lengths.push_back(uint32_t(line.size()));
+            field_counts.push_back(uint32_t(tokens.size() - 1));
+
+            postings[std::string(tokens[0])].push_back(number);
+            if(TypeFilter(Filter(), tokens[0]) != nullptr) {
+                for(size_t i = 1; i < tokens.size(); ++i)
+                    postings[PostingKey(tokens[0], i - 1, tokens[i])].push_back(number);
+            }
+        }
+        offset = eol + 1;
+    }
+
+    std::vector<const std::pair<const std::string, std::vector<uint32_t>>*> keys;
+    keys.reserve(postings.size());
+    for(const auto& posting : postings)
+        keys.push_back(&posting);
+    std::sort(keys.begin(), keys.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+    std::vector<uint32_t> types;
+    for(size_t i = 0; i < keys.size(); ++i) {
+        if(keys[i]->first.find('\x1f') == std::string::npos)
+            types.push_back(uint32_t(i));
+    }
+
+    SnapshotWriter out;
+    out.PutBytes(MAGIC, sizeof(MAGIC));
+    out.Put(VERSION);
+    out.Put(uint32_t(offsets.size()));
+    out.Put(file_size);
+    out.Put(file_mtime);
+    out.Put(uint32_t(keys.size()));
+    out.Put(uint32_t(types.size()));
+    out.Put(Checksum(out.buffer));
+    out.PutBytes(offsets.data(), offsets.size() * sizeof(uint64_t));
+    out.PutBytes(lengths.data(), lengths.size() * sizeof(uint32_t));
+    out.PutBytes(field_counts.data(), field_counts.size() * sizeof(uint32_t));
+
+    // The keys follow the key table and the entries of the policy types, then the lines of every key.
+    uint64_t key_pos = out.buffer.size() + keys.size() * ENTRY_SIZE + types.size() * sizeof(uint32_t);
+    uint64_t lines_pos = key_pos;
+    for(const auto* key : keys)
+        lines_pos += key->first.size();
+    for(const auto* key : keys) {
+        out.Put(key_pos);
+        out.Put(uint32_t(key->first.size()));
+        out.Put(uint32_t(key->second.size()));
+        out.Put(lines_pos);
+        key_pos += key->first.size();
+        lines_pos += key->second.size() * sizeof(uint32_t);
+    }
+    for(uint32_t type : types)
+        out.Put(type);
+    for(const auto* key : keys)
+        out.PutBytes(key->first.data(), key->first.size());
+    for(const auto* key : keys)
+        out.PutBytes(key->second.data(), key->second.size() * sizeof(uint32_t));
+
+    m_file.reset();
+    m_buffer = std::move(out.buffer);
+    Open(m_buffer);
+}
+
+void PolicyFileIndex::Save(const std::string& path) const {
+    // The index is written aside and renamed, a reader never maps half of it.
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(m_data.data(), m_data.size());
+    out.close();
+    if(!out || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw IOException("Cannot write file.");
+    }
+}
+
+bool PolicyFileIndex::Load(const std::string& path, uint64_t file_size, int64_t file_mtime) {
+    std::unique_ptr<MappedFile> file;
+    try {
+        file.reset(new MappedFile(path));
+    }
+    catch(IOException&) {
+        return false;
+    }
+
+    PolicyFileIndex index;
+    if(!index.Open(file->View()) || !index.Matches(file_size, file_mtime))
+        return false;
+
+    *this = std::move(index);
+    m_buffer.clear();
+    m_file = std::move(file);
+    return true;
+}
+
+bool PolicyFileIndex::Matches(uint64_t file_size, int64_t file_mtime) const {
+    return !m_data.empty() && m_file_size == file_size && m_file_mtime == file_mtime;
+}
+
+// Match keeps the lines FilteredFileAdapter keeps when it reads the whole file: every line of a
+// type without a filter, and the lines of a filtered type that have a field for every value of the
+// filter and equal its non-empty values. The lists of those values are intersected from the
+// shortest one.
+std::vector<uint32_t> PolicyFileIndex::Match(const Filter& filter) const {
+    std::vector<uint32_t> matched;
+    size_t counts_at = HEADER_SIZE + size_t(m_line_count) * 12;
+
+    size_t types_at = HEADER_SIZE + size_t(m_line_count) * 16 + size_t(m_key_count) * ENTRY_SIZE;
+
+    for(uint32_t i = 0; i < m_type_count; ++i) {
+        uint32_t entry = At<uint32_t>(types_at + size_t(i) * 4);
+        if(entry >= m_key_count)
+            throw IOException("Corrupted policy file index.");
+        std::string_view type = Key(entry);
+
+        std::vector<uint32_t> candidates;
+        std::vector<std::vector<uint32_t>> postings;
+        const std::vector<std::string>* values = TypeFilter(filter, type);
+        if(values != nullptr) {
+            for(size_t i = 0; i < values->size(); ++i) {
+                if((*values)[i].length() > 0)
+                    postings.push_back(Find(PostingKey(type, i, CaepUtil::Trim((*values)[i]))));
+            }
+        }
+        if(postings.empty())
+            candidates = Find(type);
+        else {
+            std::sort(postings.begin(), postings.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+            candidates.swap(postings[0]);
+        }
+
+        size_t required = values == nullptr ? 0 : values->size();
+        for(uint32_t line : candidates) {
+            if(required > 0 && At<uint32_t>(counts_at + size_t(line) * 4) < required)
+                continue;
+            bool all = true;
+            for(size_t i = 1; i < postings.size() && all; ++i)
+                all = std::binary_search(postings[i].begin(), postings[i].end(), line);
+            if(all)
+                matched.push_back(line);
+        }
+    }
+
+    std::sort(matched.begin(), matched.end());
+    return matched;
+}
+
+std::string_view PolicyFileIndex::Line(std::string_view text, uint32_t line) const {
+    uint64_t offset = At<uint64_t>(HEADER_SIZE + size_t(line) * 8);
+    uint32_t length = At<uint32_t>(HEADER_SIZE + size_t(m_line_count) * 8 + size_t(line) * 4);
+    if(offset + length > text.size())
+        throw IOException("Policy file index does not match the policy file.");
+    return text.substr(offset, length);
+}
+
+size_t PolicyFileIndex::LineCount() const {
+    return m_line_count;
+}
+
+} // namespace caep
+
+#endif
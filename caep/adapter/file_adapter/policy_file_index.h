@@ -0,0 +1,72 @@
+#ifndef CAEP_POLICY_FILE_INDEX_H
+#define CAEP_POLICY_FILE_INDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../filtered_adapter.h"
+#include "../../util/mapped_file.h"
+
+namespace caep {
+
+// PolicyFileIndex locates the lines of a policy file that a Filter keeps without reading the file.
+// It holds the byte range and field count of every rule line, the lines of every policy type, and
+// for the types 'a', 'r' and 'm' that a Filter applies to, the lines of every value of every field.
+//
+// The index is laid out as the file it is saved to: the arrays of the lines, a table of keys sorted
+// for binary search, each pointing to its list of lines, and the entries of the policy types. A saved index is mapped and read
+// in place, so loading it and matching a filter cost what the matched lines cost, not the size of
+// the policy file. The file records the size and the modification time of the policy file it was
+// built from, an index that does not match them any longer is not loaded.
+class PolicyFileIndex {
+private:
+    static constexpr uint32_t VERSION = 1;
+
+    std::string m_buffer;
+    std::unique_ptr<MappedFile> m_file;
+    std::string_view m_data;
+    uint64_t m_file_size;
+    int64_t m_file_mtime;
+    uint32_t m_line_count;
+    uint32_t m_key_count;
+    uint32_t m_type_count;
+
+    template<typename T>
+    T At(size_t pos) const;
+
+    bool Open(std::string_view data);
+
+    std::string_view Key(uint32_t entry) const;
+
+    std::vector<uint32_t> Find(std::string_view key) const;
+
+    static std::string PostingKey(std::string_view p_type, size_t field, std::string_view value);
+
+public:
+    PolicyFileIndex();
+
+    // Build indexes text, the content of a policy file of the given size and modification time.
+    void Build(std::string_view text, uint64_t file_size, int64_t file_mtime);
+
+    // Save writes the index to path, Load maps it back and returns false if it is missing, corrupted
+    // or built from another version of the policy file than the one of file_size and file_mtime.
+    void Save(const std::string& path) const;
+
+    bool Load(const std::string& path, uint64_t file_size, int64_t file_mtime);
+
+    bool Matches(uint64_t file_size, int64_t file_mtime) const;
+
+    // Match returns the numbers of the lines that filter keeps, in file order.
+    std::vector<uint32_t> Match(const Filter& filter) const;
+
+    std::string_view Line(std::string_view text, uint32_t line) const;
+
+    size_t LineCount() const;
+};
+
+} // namespace caep
+
+#endif
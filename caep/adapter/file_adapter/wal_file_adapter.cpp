@@ -0,0 +1,361 @@
+#ifndef CAEP_WAL_FILE_ADAPTER_CPP
+#define CAEP_WAL_FILE_ADAPTER_CPP
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./wal_file_adapter.h"
+#include "../../exception/caep_exception.h"
+#include "../../util/mapped_file.h"
+#include "../../util/snapshot_io.h"
+
+namespace caep {
+
+namespace {
+
+enum RecordOp : uint8_t {
+    ADD = 1,
+    REMOVE = 2,
+    REMOVE_FILTERED = 3
+};
+
+// A record is its size, the checksum of its payload and the payload: the operation, the section,
+// the policy type, the field index of a filtered removal and the rules, or the field values.
+std::string EncodeRecord(RecordOp op, const std::string& sec, const std::string& p_type, int field_index,
+                         const std::vector<std::vector<std::string>>& rules) {
+    SnapshotWriter payload;
+    payload.Put(uint8_t(op));
+    payload.PutString(sec);
+    payload.PutString(p_type);
+    payload.Put(int32_t(field_index));
+    payload.Put(uint32_t(rules.size()));
+    for(const auto& rule : rules) {
+        payload.Put(uint32_t(rule.size()));
+        for(const auto& field : rule)
+            payload.PutString(field);
+    }
+
+    SnapshotWriter record;
+    record.Put(uint32_t(payload.buffer.size()));
+    record.Put(Checksum(payload.buffer));
+    record.PutBytes(payload.buffer.data(), payload.buffer.size());
+    return std::move(record.buffer);
+}
+
+void ApplyRecord(std::string_view payload, Model* model) {
+    SnapshotReader in(payload);
+    RecordOp op = RecordOp(in.Get<uint8_t>());
+    std::string sec(in.GetString());
+    std::string p_type(in.GetString());
+    int field_index = in.Get<int32_t>();
+    std::vector<std::vector<std::string>> rules(in.Get<uint32_t>());
+    for(auto& rule : rules) {
+        rule.resize(in.Get<uint32_t>());
+        for(auto& field : rule)
+            field = std::string(in.GetString());
+    }
+
+    auto it = model->m.find(sec);
+    if(it == model->m.end() || it->second.section_map.count(p_type) == 0)
+        throw AdapterException("unknown policy type in log: " + p_type);
+
+    if(op == ADD) {
+        for(const auto& rule : rules)
+            model->AddPolicy(sec, p_type, rule);
+    }
+    else if(op == REMOVE) {
+        for(const auto& rule : rules)
+            model->RemovePolicy(sec, p_type, rule);
+    }
+    else if(op == REMOVE_FILTERED && !rules.empty())
+        model->RemoveFilteredPolicy(sec, p_type, field_index, rules[0]);
+}
+
+bool FileExists(const std::string& path, size_t* size = nullptr) {
+    struct stat st;
+    if(stat(path.c_str(), &st) != 0)
+        return false;
+    if(size != nullptr)
+        *size = size_t(st.st_size);
+    return true;
+}
+
+void WriteAll(int fd, const char* data, size_t size) {
+    while(size > 0) {
+        ssize_t written = write(fd, data, size);
+        if(written < 0)
+            throw IOException("Cannot write file.");
+        data += written;
+        size -= size_t(written);
+    }
+}
+
+} // namespace
+
+WALFileAdapter::WALFileAdapter(std::string file_path, WALOptions options)
+    : FileAdapter(file_path), m_options(options), m_fd(-1), m_log_size(0), m_unsynced(0),
+      m_base_size(0), m_compacting(false) {
+    size_t base_size = 0;
+    FileExists(file_path, &base_size);
+    m_base_size = base_size;
+}
+
+WALFileAdapter::~WALFileAdapter() {
+    MutexLockGuard guard(m_lock);
+    JoinCompactor();
+    CloseLog();
+}
+
+std::string WALFileAdapter::LogPath() const {
+    return this->file_path + ".wal";
+}
+
+std::string WALFileAdapter::CompactingPath() const {
+    return this->file_path + ".wal.compacting";
+}
+
+void WALFileAdapter::OpenLog() {
+    m_fd = open(LogPath().c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(m_fd < 0)
+        throw IOException("Cannot open file.");
+    struct stat st;
+    fstat(m_fd, &st);
+    m_log_size = size_t(st.st_size);
+    m_unsynced = 0;
+}
+
+void WALFileAdapter::CloseLog() {
+    if(m_fd < 0)
+        return;
+    if(m_unsynced > 0)
+        fdatasync(m_fd);
+    close(m_fd);
+    m_fd = -1;
+}
+
+void WALFileAdapter::Append(const std::string& record) {
+    MutexLockGuard guard(m_lock);
+    if(m_fd < 0)
+        OpenLog();
+
+    // O_APPEND writes the record after whatever a crash left, replay stops at a torn record anyway.
+    WriteAll(m_fd, record.data(), record.size());
+    m_log_size += record.size();
+    if(++m_unsynced >= m_options.sync_every && m_options.sync_every > 0) {
+        fdatasync(m_fd);
+        m_unsynced = 0;
+    }
+
+    if(!m_compacting && m_defs != nullptr && m_log_size >= m_options.compact_min_bytes &&
+       m_log_size > m_options.compact_ratio * m_base_size)
+        StartCompaction();
+}
+
+void WALFileAdapter::JoinCompactor() {
+    if(m_compactor != nullptr && m_compactor->Started())
+        m_compactor->Join();
+    m_compactor.reset();
+}
+
+// StartCompaction runs with m_lock held. The log is renamed aside, appends go to a fresh log from now
+// on and the compactor folds the old one into the policy file.
+void WALFileAdapter::StartCompaction() {
+    // A compaction that failed left its log behind, LoadPolicy or Compact folds it, never overwrite it.
+    if(FileExists(CompactingPath()))
+        return;
+
+    CloseLog();
+    if(std::rename(LogPath().c_str(), CompactingPath().c_str()) != 0) {
+        OpenLog();
+        return;
+    }
+    OpenLog();
+
+    JoinCompactor();
+    m_compacting = true;
+    m_compactor.reset(new Thread([this]() { this->CompactLog(); }, "WALCompactor"));
+    m_compactor->Start();
+}
+
+// CompactLog runs on the compactor, it only touches the policy file and the log renamed aside.
+void WALFileAdapter::CompactLog() {
+    try {
+        std::shared_ptr<Model> model(Model::NewModelFromDefs(*m_defs));
+        if(FileExists(this->file_path))
+            FileAdapter::LoadPolicy(model.get());
+        Replay(CompactingPath(), model.get());
+        WriteBase(model.get());
+        std::remove(CompactingPath().c_str());
+    }
+    catch(...) {
+        // The log stays aside and is folded by the next LoadPolicy, SavePolicy or Compact.
+    }
+    m_compacting = false;
+}
+
+void WALFileAdapter::WriteBase(Model* model) {
+    std::string text = PolicyText(model);
+    std::string tmp_path = this->file_path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0)
+        throw IOException("Cannot open file.");
+    try {
+        WriteAll(fd, text.data(), text.size());
+    }
+    catch(...) {
+        close(fd);
+        throw;
+    }
+    fsync(fd);
+    close(fd);
+
+    if(std::rename(tmp_path.c_str(), this->file_path.c_str()) != 0)
+        throw IOException("Cannot replace policy file.");
+    m_base_size = text.size();
+
+    // The rename itself is durable once the directory is synced.
+    size_t slash = this->file_path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : this->file_path.substr(0, slash + 1);
+    int dir_fd = open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+    if(dir_fd >= 0) {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+}
+
+size_t WALFileAdapter::Replay(const std::string& path, Model* model) {
+    if(!FileExists(path))
+        return 0;
+
+    MappedFile file(path);
+    SnapshotReader in(file.View());
+    size_t intact = 0;
+    while(!in.AtEnd()) {
+        std::string_view payload;
+        try {
+            uint32_t size = in.Get<uint32_t>();
+            uint64_t checksum = in.Get<uint64_t>();
+            payload = in.GetBytes(size);
+            if(Checksum(payload) != checksum)
+                break;
+        }
+        catch(IOException&) {
+            break;
+        }
+        ApplyRecord(payload, model);
+        intact = in.Position();
+    }
+    return intact;
+}
+
+void WALFileAdapter::LoadPolicy(Model* model) {
+    if(this->file_path == "")
+        throw AdapterException("Invalid file path, file path cannot be empty");
+
+    MutexLockGuard guard(m_lock);
+    JoinCompactor();
+
+    size_t base_size = 0;
+    if(FileExists(this->file_path, &base_size))
+        FileAdapter::LoadPolicy(model);
+    m_base_size = base_size;
+
+    bool leftover = FileExists(CompactingPath());
+    Replay(CompactingPath(), model);
+    size_t intact = Replay(LogPath(), model);
+    m_defs.reset(Model::NewModelFromDefs(*model));
+
+    // A torn record at the end of the log is cut off, so that new records are not appended after it.
+    CloseLog();
+    OpenLog();
+    if(m_log_size > intact && ftruncate(m_fd, off_t(intact)) == 0)
+        m_log_size = intact;
+
+    if(leftover) {
+        WriteBase(model);
+        ftruncate(m_fd, 0);
+        m_log_size = 0;
+        std::remove(CompactingPath().c_str());
+    }
+}
+
+void WALFileAdapter::SavePolicy(Model* model) {
+    if(this->file_path == "")
+        throw AdapterException("Invalid file path, file path cannot be empty");
+
+    MutexLockGuard guard(m_lock);
+    JoinCompactor();
+
+    // The policy file holds every change once it is renamed in place, then the logs are dropped.
+    WriteBase(model);
+    if(m_fd < 0)
+        OpenLog();
+    if(ftruncate(m_fd, 0) == 0)
+        m_log_size = 0;
+    m_unsynced = 0;
+    std::remove(CompactingPath().c_str());
+    m_defs.reset(Model::NewModelFromDefs(*model));
+}
+
+void WALFileAdapter::AddPolicy(std::string sec, std::string p_type, std::vector<std::string> rule) {
+    Append(EncodeRecord(ADD, sec, p_type, 0, {rule}));
+}
+
+void WALFileAdapter::RemovePolicy(std::string sec, std::string p_type, std::vector<std::string> rule) {
+    Append(EncodeRecord(REMOVE, sec, p_type, 0, {rule}));
+}
+
+void WALFileAdapter::RemoveFilteredPolicy(std::string sec, std::string p_type, int field_index, std::vector<std::string> field_values) {
+    Append(EncodeRecord(REMOVE_FILTERED, sec, p_type, field_index, {field_values}));
+}
+
+void WALFileAdapter::AddPolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules) {
+    Append(EncodeRecord(ADD, sec, p_type, 0, rules));
+}
+
+void WALFileAdapter::RemovePolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules) {
+    Append(EncodeRecord(REMOVE, sec, p_type, 0, rules));
+}
+
+void WALFileAdapter::Sync() {
+    MutexLockGuard guard(m_lock);
+    if(m_fd >= 0 && m_unsynced > 0) {
+        fdatasync(m_fd);
+        m_unsynced = 0;
+    }
+}
+
+void WALFileAdapter::Compact() {
+    MutexLockGuard guard(m_lock);
+    JoinCompactor();
+    if(m_defs == nullptr)
+        throw AdapterException("the policy should be loaded before it is compacted");
+
+    // Appends wait for the lock, so the policy file and both logs are folded as they are now.
+    std::shared_ptr<Model> model(Model::NewModelFromDefs(*m_defs));
+    if(FileExists(this->file_path))
+        FileAdapter::LoadPolicy(model.get());
+    Replay(CompactingPath(), model.get());
+    if(m_fd >= 0 && m_unsynced > 0)
+        fdatasync(m_fd);
+    Replay(LogPath(), model.get());
+
+    WriteBase(model.get());
+    if(m_fd < 0)
+        OpenLog();
+    if(ftruncate(m_fd, 0) == 0)
+        m_log_size = 0;
+    m_unsynced = 0;
+    std::remove(CompactingPath().c_str());
+}
+
+size_t WALFileAdapter::LogSize() {
+    MutexLockGuard guard(m_lock);
+    return m_log_size;
+}
+
+} // namespace caep
+
+#endif
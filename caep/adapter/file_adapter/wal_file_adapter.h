@@ -0,0 +1,102 @@
+#ifndef CAEP_WAL_FILE_ADAPTER_H
+#define CAEP_WAL_FILE_ADAPTER_H
+
+#include <atomic>
+#include <memory>
+
+#include "./file_adapter.h"
+#include "../batch_adapter.h"
+#include "../../log/thread_util/mutex_lock.h"
+#include "../../log/thread_util/thread.h"
+
+namespace caep {
+
+class WALOptions {
+public:
+    // sync_every is the count of records appended between two fsyncs, 1 syncs every record and 0
+    // leaves syncing to Sync and to the operating system.
+    size_t sync_every = 1;
+
+    // The log is compacted once it is compact_ratio times as large as the policy file, and at
+    // least compact_min_bytes large.
+    double compact_ratio = 1.0;
+    size_t compact_min_bytes = 1 << 20;
+};
+
+// WALFileAdapter is a FileAdapter whose auto-save works. Every change is appended as a record to a
+// write-ahead log beside the policy file, file_path + ".wal", instead of rewriting the policy file,
+// and LoadPolicy replays the log over the policy file.
+//
+// A record is framed by its size and a checksum, a record torn by a crash is dropped on replay
+// together with the rest of the log. Once the log outgrows the policy file, it is renamed aside and
+// folded into a new policy file by a background thread while appends go to a fresh log. Replaying
+// a log twice yields the same policy, so a crash during compaction loses nothing.
+class WALFileAdapter : public BatchAdapter, public FileAdapter {
+private:
+    WALOptions m_options;
+    MutexLock m_lock;
+    int m_fd;
+    size_t m_log_size;
+    size_t m_unsynced;
+    std::atomic<size_t> m_base_size;
+    std::atomic<bool> m_compacting;
+    // m_defs holds the definitions of the loaded model, compaction parses the policy file with them.
+    std::shared_ptr<Model> m_defs;
+    std::unique_ptr<Thread> m_compactor;
+
+    std::string CompactingPath() const;
+
+    void OpenLog();
+
+    void CloseLog();
+
+    void Append(const std::string& record);
+
+    void JoinCompactor();
+
+    void StartCompaction();
+
+    void CompactLog();
+
+    // WriteBase replaces the policy file by the rules of model, the new file is synced before it is renamed in place.
+    void WriteBase(Model* model);
+
+    // Replay applies the records of the log at path to model, it returns the size of the records that were intact.
+    static size_t Replay(const std::string& path, Model* model);
+
+public:
+    WALFileAdapter(std::string file_path, WALOptions options = WALOptions());
+
+    ~WALFileAdapter();
+
+    // LoadPolicy loads the policy file and replays the log over it.
+    void LoadPolicy(Model* model);
+
+    // SavePolicy rewrites the policy file and empties the log.
+    void SavePolicy(Model* model);
+
+    void AddPolicy(std::string sec, std::string p_type, std::vector<std::string> rule);
+
+    void RemovePolicy(std::string sec, std::string p_type, std::vector<std::string> rule);
+
+    void RemoveFilteredPolicy(std::string sec, std::string p_type, int field_index, std::vector<std::string> field_values);
+
+    // AddPolicies and RemovePolicies append a whole batch as a single record.
+    void AddPolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules);
+
+    void RemovePolicies(std::string sec, std::string p_type, std::vector<std::vector<std::string>> rules);
+
+    // Sync flushes the records appended since the last fsync to the disk.
+    void Sync();
+
+    // Compact folds the log into the policy file now and waits for it.
+    void Compact();
+
+    std::string LogPath() const;
+
+    size_t LogSize();
+};
+
+} // namespace caep
+
+#endif
@@ -12,10 +12,12 @@
 #include "./exception/caep_exception.h"
 #include "./util/caep_util.h"
 #include "./util/built_in_functions.h"
+#include "./util/regex_cache.h"
 
 #include "./model/model.h"
 #include "./model/section.h"
 #include "./model/matcher.h"
+#include "./model/column_matcher.h"
 
 #include "./adapter/adapter.h"
 #include "./adapter/filtered_adapter.h"
@@ -23,6 +25,7 @@
 #include "./adapter/file_adapter/file_adapter.h"
 #include "./adapter/file_adapter/filtered_file_adapter.h"
 #include "./adapter/file_adapter/batch_file_adapter.h"
+#include "./adapter/file_adapter/wal_file_adapter.h"
 
 #include "./effect/effect.h"
 #include "./effect/effector.h"
@@ -30,5 +33,7 @@
 
 #include "./caep/caeper_interface.h"
 #include "./caep/caeper.h"
+#include "./caep/synced_caeper.h"
+#include "./caep/snapshot_file.h"
 
 #endif
@@ -4,120 +4,109 @@
 #include <algorithm>
 
 #include "./caeper.h"
+#include "./snapshot_file.h"
 #include "../adapter/file_adapter/file_adapter.h"
 #include "../rbac/default_role_manager.h"
 #include "../effect/default_effector.h"
 #include "../exception/caep_exception.h"
+#include "../exception/unsupported_operation_exception.h"
 #include "../util/caep_util.h"
 
 namespace caep {
 
-bool Caeper::m_caeper(const std::string& matcher, const std::vector<std::string>& req) {
-    if(!m_enabled)
+bool Caeper::m_caeper(const std::string& matcher, const std::vector<std::string>& req, Explanation* explanation) {
+    if(!m_enabled) {
+        if(explanation != nullptr)
+            explanation->decision = true;
         return true;
-
-    std::string exp_string;
-    if(!matcher.compare(""))
-        exp_string = m_model->m["c"].section_map["c"]->value;
-    else
-        exp_string = matcher;
-    
-    std::vector<std::vector<std::string>> condition_exp;
-    auto condition_or_strings = CaepUtil::Split(exp_string, "||");
-    for(size_t i = 0; i < condition_or_strings.size(); ++i) {
-        auto tmp = CaepUtil::Split(condition_or_strings[i], "&&");
-        condition_exp.push_back(tmp);
     }
 
-    for(auto& vc1 : condition_exp) {
-        for(auto& vc2 : vc1)
-            vc2 = CaepUtil::Trim(vc2);
-    }
-    
-    std::unordered_map<std::string, int> param_index({
-                                                     {"a.sub", 0},
-                                                     {"a.res", 1},
-                                                     {"a.act", 2},
-                                                     {"a.dom", 3}
-                                                     });
-    std::unordered_map<std::string, std::vector<std::string>> field_collection;
-
-    for(size_t i = 0; i < m_model->m["a"].section_map["a"]->policy[0].size(); ++i) {
-        std::vector<std::string> field_values = m_model->GetAllValuesForFieldInPolicy("a", "a", i);
-        switch(i) {
-            case 0 :
-                field_collection["a.sub"] = field_values;
-                break;
-            case 1 :
-                field_collection["a.res"] = field_values;
-                break;
-            case 2 :
-                field_collection["a.act"] = field_values;
-                break;
-            case 3 :
-                field_collection["a.dom"] = field_values;
+    // Pins the current snapshot, a reload that publishes a new one meanwhile does not affect this request.
+    std::shared_ptr<Model> model = m_model;
+    std::shared_ptr<RoleManager> role_manager = this->rm;
+    std::shared_ptr<const ConditionPlan> plan = m_plan;
+    if(matcher.compare(""))
+        plan = ConditionPlan::Compile(matcher, model.get(), m_matcher.get());
+
+    const auto& section = model->m.at("a").section_map.at("a");
+    // Rules are evaluated a column at a time over masks of rows, tombstones of removed rules are not live.
+    const std::vector<uint64_t>& live = section->GetLiveMask();
+
+    // Requests are looked up, not interned, an unknown value gets NO_SYMBOL and equals no rule.
+    std::vector<symbol_t> req_ids;
+    req_ids.reserve(req.size());
+    for(const auto& value : req)
+        req_ids.push_back(section->symbols->Find(value));
+
+    // Blocks of rows are evaluated in order and fed to the Effector, the rest is skipped once the decision is final.
+    const size_t BLOCK_WORDS = 16;
+    std::shared_ptr<Effector> eft = m_eft;
+    EffectStream stream;
+    eft->Begin(plan->effect, plan->effect_kind, section->RowCount(), stream);
+    std::vector<uint64_t> matched;
+
+    // Only the rules listed by the index may match, so only the words that hold them are evaluated and the Effector
+    // skips the others. All live rules are evaluated if the condition can not be indexed.
+    std::vector<size_t> rows;
+    if(plan->Candidates(section->policy_index, req, req_ids, rows)) {
+        if(!std::is_sorted(rows.begin(), rows.end()))
+            std::sort(rows.begin(), rows.end());
+
+        std::vector<uint64_t> scope;
+        size_t next = 0;
+        for(size_t r = 0; r < rows.size() && (rows[r] >> 6) < live.size() && !stream.final;) {
+            // A block runs from the word of the next candidate to the last candidate word within BLOCK_WORDS.
+            size_t begin = rows[r] >> 6;
+            size_t end = begin + 1;
+            scope.assign(BLOCK_WORDS, 0);
+            for(; r < rows.size() && (rows[r] >> 6) < std::min(begin + BLOCK_WORDS, live.size()); ++r) {
+                end = (rows[r] >> 6) + 1;
+                scope[end - 1 - begin] |= uint64_t(1) << (rows[r] & 63);
+            }
+            scope.resize(end - begin);
+            for(size_t i = begin; i < end; ++i)
+                scope[i - begin] &= live[i];
+
+            if(next < begin && eft->Skip(stream, live, next, begin))
                 break;
+            plan->Evaluate(req, req_ids, *section, role_manager.get(), scope, matched, begin, end, begin);
+            for(size_t i = begin; i < end; ++i) {
+                if(eft->Feed(stream, matched[i - begin], live[i]))
+                    break;
+            }
+            next = end;
         }
+        if(!stream.final && next < live.size())
+            eft->Skip(stream, live, next, live.size());
     }
-
-    size_t policy_count = m_model->m["a"].section_map["a"]->policy.size();
-    std::vector<Effect> policy_effects(policy_count, Effect::Indeterminate);
-    std::vector<float> matcher_results(policy_count, 0.0f);
-    bool logic_negation = false;
-    for(size_t i = 0; i < policy_count; ++i) {
-        bool single_effect = true;
-        for(size_t j = 0; j < condition_exp.size(); ++j) {
-            bool matcher_effect = true;
-            for(size_t k = 0; k < condition_exp[j].size(); ++k) {
-                auto left_parentheses_index = condition_exp[j][k].find("(");
-                auto right_parentheses_index = condition_exp[j][k].find(")");
-
-                std::string matcher_name = condition_exp[j][k].substr(0, left_parentheses_index);
-                std::string matcher_params = condition_exp[j][k].substr(left_parentheses_index + 1, right_parentheses_index - left_parentheses_index - 1);
-                if(matcher_name.find("!") != std::string::npos) {
-                    matcher_name = matcher_name.substr(1);
-                    logic_negation = true;
-                }
-
-                std::vector<std::string> matcher_param = CaepUtil::Split(matcher_params, ",");
-                for(auto& it : matcher_param)
-                    it = CaepUtil::Trim(it);
-
-                for(size_t h = 0; h < matcher_param.size(); ++h) {
-                    if(!matcher_name.compare("RoleMatcher")) {
-                        if(m_model->m["a"].section_map["a"]->policy[i].size() == 4) {
-                            std::vector<std::string> domain{field_collection["dom"][i]};
-                            matcher_effect = this->rm->HasLink(req[param_index[matcher_param[h]]], field_collection[matcher_param[h]][i], domain);
-                        }
-                        else  
-                            matcher_effect = this->rm->HasLink(req[param_index[matcher_param[h]]], field_collection[matcher_param[h]][i]);
-                    }
-                    else {
-                        matcher_effect = (this->m_matcher->matcher_map[matcher_name])(req[param_index[matcher_param[h]]], field_collection[matcher_param[h]][i]);
-                    }
-                    
-                    if(logic_negation)
-                        matcher_effect = !matcher_effect;
-                    if(!matcher_effect)
-                        break;
-                }
-                if(!matcher_effect)
+    else {
+        for(size_t begin = 0; begin < live.size() && !stream.final; begin += BLOCK_WORDS) {
+            size_t end = std::min(begin + BLOCK_WORDS, live.size());
+            plan->Evaluate(req, req_ids, *section, role_manager.get(), live, matched, begin, end);
+            for(size_t i = begin; i < end; ++i) {
+                if(eft->Feed(stream, matched[i - begin], live[i]))
                     break;
             }
-            single_effect = matcher_effect;
-            if(single_effect)
-                break;
         }
-        if(single_effect)
-            policy_effects[i] = Effect::Allow;
-        else
-            policy_effects[i] = Effect::Deny;
     }
-    
-    bool result = m_eft->MergeEffects(m_model->m["e"].section_map["e"]->value, policy_effects,  matcher_results);
+
+    bool result = eft->End(stream);
+    if(explanation != nullptr) {
+        explanation->decision = result;
+        if(stream.final && stream.row < section->RowCount()) {
+            explanation->row = stream.row;
+            explanation->rule = section->GetRule(stream.row);
+            plan->Explain(req, req_ids, *section, stream.row, role_manager.get(), explanation->terms);
+        }
+    }
     return result;
 }
 
+void Caeper::LoadPlanFromModel() {
+    m_plan = ConditionPlan::Compile(m_model->m["c"].section_map["c"]->value, m_model.get(), m_matcher.get());
+    ++m_generation;
+}
+
 Caeper::Caeper() {
 }
 
@@ -138,6 +127,7 @@ Caeper::Caeper(const std::string& model_path, const std::string& policy_path) {
         this->LoadPolicy();
 
     m_matcher->LoadMatcherFromModel(m_model.get());
+    this->LoadPlanFromModel();
 }
 
 //Caeper::Caeper(const std::string& model_path, const std::string& policy_path)
@@ -185,7 +175,10 @@ void Caeper::InitWithModelAndAdapter(std::shared_ptr<Model> m, std::shared_ptr<A
 void Caeper::Initialize() {
     this->rm = std::make_shared<DefaultRoleManager>(10);
     m_eft = std::make_shared<DefaultEffector>();
+    if(m_matcher == nullptr)
+        m_matcher = std::make_shared<Matcher>();
     m_matcher->LoadMatcherFromModel(m_model.get());
+    this->LoadPlanFromModel();
 
     m_enabled = true;
     m_auto_save = true;
@@ -205,9 +198,9 @@ std::shared_ptr<Model> Caeper::GetModel() {
 }
 
 void Caeper::SetModel(std::shared_ptr<Model> m) {
-    m_model = m;
-    m_matcher->LoadMatcherFromModel(m.get());
-    this->Initialize();
+    PolicySnapshot snapshot = this->NewPolicySnapshot(m);
+    this->BuildSnapshotRoleLinks(snapshot);
+    this->PublishPolicySnapshot(snapshot);
 }
 
 std::shared_ptr<Adapter> Caeper::GetAdapter() {
@@ -224,44 +217,100 @@ std::shared_ptr<RoleManager> Caeper::GetRoleManager() {
 
 void Caeper::SetRoleManager(std::shared_ptr<RoleManager> rm) {
     this->rm = rm;
+    ++m_generation;
 }
 
 void Caeper::SetEffector(std::shared_ptr<Effector> eft) {
     m_eft = eft;
+    ++m_generation;
+}
+
+void Caeper::EnableDecisionCache(size_t capacity) {
+    m_cache = capacity > 0 ? std::make_shared<DecisionCache>(capacity) : nullptr;
+}
+
+std::shared_ptr<DecisionCache> Caeper::GetDecisionCache() {
+    return m_cache;
+}
+
+void Caeper::SetThreadPool(std::shared_ptr<ThreadPool> pool) {
+    m_pool = pool;
 }
 
 void Caeper::ClearPolicy() {
     m_model->ClearPolicy();
+    ++m_generation;
 }
 
 void Caeper::LoadPolicy() {
-    this->ClearPolicy();
-    m_adapter->LoadPolicy(m_model.get());
-    
-    if(m_auto_build_role_links) {
-        this->BuildRoleLinks();
-    }
+    PolicySnapshot snapshot = this->NewPolicySnapshot(nullptr);
+    this->LoadPolicySnapshot(snapshot, nullptr);
+    this->PublishPolicySnapshot(snapshot);
 }
 
-template<typename Filter>
-void Caeper::LoadFilteredPolicy(Filter filter) {
-    this->ClearPolicy();
+void Caeper::LoadFilteredPolicy(Filter* filter) {
+    PolicySnapshot snapshot = this->NewPolicySnapshot(nullptr);
+    this->LoadPolicySnapshot(snapshot, filter);
+    this->PublishPolicySnapshot(snapshot);
+}
 
-    std::shared_ptr<FileAdapter> filtered_adapter;
+PolicySnapshot Caeper::NewPolicySnapshot(std::shared_ptr<Model> model) {
+    PolicySnapshot snapshot;
+    snapshot.model = model != nullptr ? model : std::shared_ptr<Model>(Model::NewModelFromDefs(*m_model));
+    snapshot.rm = this->NewSnapshotRoleManager();
+    return snapshot;
+}
 
-    if(m_adapter->IsFiltered()) {
-        filtered_adapter = std::dynamic_pointer_cast<FileAdapter>(m_adapter);
+std::shared_ptr<RoleManager> Caeper::NewSnapshotRoleManager() {
+    if(this->rm == nullptr)
+        return std::make_shared<DefaultRoleManager>(10);
+    try {
+        return this->rm->NewEmpty();
+    } catch(UnsupportedOperationException&) {
+        return this->rm;
+    }
+}
+
+void Caeper::LoadPolicySnapshot(PolicySnapshot& snapshot, Filter* filter) {
+    if(filter != nullptr) {
+        auto filtered_adapter = std::dynamic_pointer_cast<FilteredAdapter>(m_adapter);
+        if(filtered_adapter == nullptr)
+            throw AdapterException("filtered policies are not supported by this adapter");
+        filtered_adapter->LoadFilteredPolicy(snapshot.model.get(), filter);
     }
     else
-        throw AdapterException("filtered policies are not supported by this adapter");
+        m_adapter->LoadPolicy(snapshot.model.get());
 
-    filtered_adapter->LoadPolicyFile(m_model, filter);
+    this->BuildSnapshotRoleLinks(snapshot);
+}
 
+void Caeper::BuildSnapshotRoleLinks(PolicySnapshot& snapshot) {
     if(m_auto_build_role_links) {
-        this->BuildRoleLinks();
+        if(snapshot.rm == this->rm)
+            snapshot.rm->Clear();
+        snapshot.model->BuildRoleLinks(snapshot.rm);
     }
 }
 
+void Caeper::PublishPolicySnapshot(PolicySnapshot& snapshot) {
+    if(m_matcher == nullptr)
+        m_matcher = std::make_shared<Matcher>();
+    if(m_eft == nullptr)
+        m_eft = std::make_shared<DefaultEffector>();
+    m_matcher->LoadMatcherFromModel(snapshot.model.get());
+    snapshot.plan = ConditionPlan::Compile(snapshot.model->m.at("c").section_map.at("c")->value, snapshot.model.get(), m_matcher.get());
+
+    m_model = snapshot.model;
+    this->rm = snapshot.rm;
+    m_plan = snapshot.plan;
+    ++m_generation;
+}
+
+void Caeper::ReadSnapshotFile(const std::string& path, PolicySnapshot& snapshot) {
+    if(!SnapshotFile::Load(path, snapshot))
+        this->BuildSnapshotRoleLinks(snapshot);
+}
+
 bool Caeper::IsFiltered() {
     return m_adapter->IsFiltered();
 }
@@ -273,8 +322,23 @@ void Caeper::SavePolicy() {
     m_adapter->SavePolicy(m_model.get());
 }
 
+void Caeper::SaveSnapshotFile(const std::string& path) {
+    PolicySnapshot snapshot;
+    snapshot.model = m_model;
+    snapshot.rm = this->rm;
+    SnapshotFile::Save(path, snapshot);
+}
+
+void Caeper::LoadSnapshotFile(const std::string& path) {
+    PolicySnapshot snapshot;
+    snapshot.rm = this->NewSnapshotRoleManager();
+    this->ReadSnapshotFile(path, snapshot);
+    this->PublishPolicySnapshot(snapshot);
+}
+
 void Caeper::EnableCeaper(bool enable) {
     m_enabled = enable;
+    ++m_generation;
 }
 
 void Caeper::EnableAutoSave(bool auto_save) {
@@ -288,23 +352,59 @@ void Caeper::EnableAutoBuildRoleLinks(bool auto_build_role_links) {
 void Caeper::BuildRoleLinks() {
     this->rm->Clear();
     m_model->BuildRoleLinks(this->rm);
+    ++m_generation;
 }
 
 void Caeper::BuildIncrementalRoleLinks(policy_op op, const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
-    return m_model->BuildIncrementalRoleLinks(this->rm, op, "r", p_type, rules);
+    m_model->BuildIncrementalRoleLinks(this->rm, op, "r", p_type, rules);
+    ++m_generation;
 }
 
 bool Caeper::Caep(const std::vector<std::string>& params) {
-    return m_caeper("", params);
+    std::shared_ptr<DecisionCache> cache = m_cache;
+    if(cache == nullptr)
+        return m_caeper("", params);
+
+    // The generation is read first, a change during m_caeper leaves the stored decision stale.
+    uint64_t generation = m_generation;
+    bool decision;
+    if(cache->Get(params, generation, decision))
+        return decision;
+    decision = m_caeper("", params);
+    cache->Put(params, generation, decision);
+    return decision;
+}
+
+bool Caeper::CaepWithMatcher(const std::string& matcher, const std::vector<std::string>& params) {
+    return m_caeper(matcher, params);
+}
+
+Explanation Caeper::CaepEx(const std::vector<std::string>& params) {
+    Explanation explanation;
+    m_caeper("", params, &explanation);
+    return explanation;
 }
 
 std::vector<bool> Caeper::BatchCaeper(const std::vector<std::vector<std::string>>& reqs) {
-    std::vector<bool> results;
-    results.reserve(reqs.size());
-    for(auto req : reqs) {
-        results.push_back(this->Caep(req));
+    std::shared_ptr<ThreadPool> pool = m_pool;
+    if(pool == nullptr || pool->ThreadCount() == 0 || reqs.size() < 2) {
+        std::vector<bool> results;
+        results.reserve(reqs.size());
+        for(const auto& req : reqs) {
+            results.push_back(this->Caep(req));
+        }
+        return results;
     }
-    return results;
+
+    // std::vector<bool> packs its bits, so workers write one byte per request and the bits are packed afterwards.
+    // Ranges are a fraction of a worker's share, so that idle workers have some left to steal.
+    std::vector<char> decisions(reqs.size());
+    size_t grain = std::max<size_t>(1, reqs.size() / (size_t(pool->ThreadCount()) * 8));
+    pool->ParallelFor(reqs.size(), grain, [&](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; ++i)
+            decisions[i] = this->Caep(reqs[i]);
+    });
+    return std::vector<bool>(decisions.begin(), decisions.end());
 }
 
 } // namespace caep 
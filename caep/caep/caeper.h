@@ -1,15 +1,43 @@
 #ifndef CAEP_CAEPER_H
 #define CAEP_CAEPER_H
 
+#include <atomic>
 #include <tuple>
 #include <vector>
 
 #include "../rbac/role_manager.h"
 #include "../model/matcher.h"
+#include "../model/condition_plan.h"
+#include "../adapter/filtered_adapter.h"
+#include "../log/thread_util/thread_pool.h"
+#include "./decision_cache.h"
 #include "./caeper_interface.h"
 
 namespace caep {
 
+// PolicySnapshot is the state that enforcement reads: the model with its rules and indexes, the role
+// graph built from them and the compiled condition. A reload fills a new snapshot aside and
+// publishes it in one step, so a request never sees a half loaded policy.
+class PolicySnapshot {
+public:
+    std::shared_ptr<Model> model;
+    std::shared_ptr<RoleManager> rm;
+    std::shared_ptr<const ConditionPlan> plan;
+};
+
+// Explanation is the decision of CaepEx with the policy rule that decided it, found by the same
+// evaluation that made the decision.
+class Explanation {
+public:
+    bool decision = false;
+    // row is the row of the deciding rule in section 'a', NO_ROW if no rule decided, eg: no rule
+    // allowed the request under AllowPriority, or the Effector does not report rows.
+    size_t row = NO_ROW;
+    std::vector<std::string> rule;
+    // terms are the matcher terms that held for the deciding rule, eg: "DefaultMatcher(a.res, a.act)".
+    std::vector<std::string> terms;
+};
+
 // Caeper is the main interface for authorization enforcement and policy management.
 class Caeper {
 private:
@@ -18,15 +46,49 @@ private:
     std::shared_ptr<Matcher> m_matcher;
     std::shared_ptr<Effector> m_eft;
     std::shared_ptr<Adapter> m_adapter;
+    std::shared_ptr<const ConditionPlan> m_plan;
+    std::shared_ptr<ThreadPool> m_pool;
+    std::shared_ptr<DecisionCache> m_cache;
 
-    bool m_enabled;
-    bool m_auto_save;
-    bool m_auto_build_role_links;
+    // m_generation counts the changes that may alter a decision, cached decisions of an older generation are stale.
+    std::atomic<uint64_t> m_generation{0};
+
+    bool m_enabled = true;
+    bool m_auto_save = true;
+    bool m_auto_build_role_links = true;
 
     // Caep use a custom matcher to decides whether a "subject" can access a "resource"
     // with the operation "action", input parameters are usually (matcher, sub, res, act),
     // use model matcher by default when matcher is "".
-    bool m_caeper(const std::string& matcher, const std::vector<std::string>& req);
+    // The deciding rule is written to explanation unless it is null, explaining costs nothing otherwise.
+    bool m_caeper(const std::string& matcher, const std::vector<std::string>& req, Explanation* explanation = nullptr);
+
+    // LoadPlanFromModel compiles the model condition into m_plan, it runs whenever the model or the matchers change.
+    void LoadPlanFromModel();
+
+protected:
+    // NewPolicySnapshot starts a snapshot from model, or from the definitions of the current model
+    // without its rules when model is null, with an empty copy of the current role manager.
+    PolicySnapshot NewPolicySnapshot(std::shared_ptr<Model> model);
+
+    // NewSnapshotRoleManager gets the empty role manager of a snapshot. A role manager that does not
+    // support NewEmpty is shared with the snapshot instead, and cleared when its role links are built.
+    std::shared_ptr<RoleManager> NewSnapshotRoleManager();
+
+    // LoadPolicySnapshot loads the policy of the adapter into the snapshot and builds its role links,
+    // the current state is left untouched. A null filter loads the whole policy.
+    void LoadPolicySnapshot(PolicySnapshot& snapshot, Filter* filter);
+
+    // BuildSnapshotRoleLinks builds the role links of the snapshot if auto building is enabled, a
+    // shared role manager is cleared first.
+    void BuildSnapshotRoleLinks(PolicySnapshot& snapshot);
+
+    // PublishPolicySnapshot compiles the condition of the snapshot and makes it the current state.
+    void PublishPolicySnapshot(PolicySnapshot& snapshot);
+
+    // ReadSnapshotFile loads a snapshot file into the snapshot, whose rm is from NewSnapshotRoleManager, and
+    // builds its role links if the file could not restore them.
+    void ReadSnapshotFile(const std::string& path, PolicySnapshot& snapshot);
 
 public:
     std::shared_ptr<RoleManager> rm;
@@ -100,7 +162,7 @@ public:
     void LoadModel();
     // GetModel gets the current model.
     std::shared_ptr<Model> GetModel();
-    // SetModel sets the current model.
+    // SetModel sets the current model, its role links and condition are built before it replaces the old one.
     void SetModel(std::shared_ptr<Model> m);
     // GetAdapter gets the current adapter.
     std::shared_ptr<Adapter> GetAdapter();
@@ -112,18 +174,32 @@ public:
     void SetRoleManager(std::shared_ptr<RoleManager> rm);
     // SetEffector sets the current effector.
     void SetEffector(std::shared_ptr<Effector> eft);
+    // EnableDecisionCache caches the decisions of Caep for up to capacity requests, 0 disables the cache.
+    // Changes made to the role manager directly, not through Caeper, do not invalidate the cache.
+    void EnableDecisionCache(size_t capacity);
+    // GetDecisionCache gets the decision cache with its hit and miss counters, null if it is disabled.
+    std::shared_ptr<DecisionCache> GetDecisionCache();
+    // SetThreadPool sets the pool BatchCaeper spreads a batch over, a null pool runs batches on the calling thread.
+    void SetThreadPool(std::shared_ptr<ThreadPool> pool);
     // LoadPolicy reloads the policy from file or database.
+    // The policy is loaded into a new model that replaces the current one once it is complete.
     void LoadPolicy();
     // ClearPolicy clears all policies.
     void ClearPolicy();
 
     // LoadFilteredPolicy reloads a filtered policy from file or database.
-    template <typename Filter>
-    void LoadFilteredPolicy(Filter filter);
+    void LoadFilteredPolicy(Filter* filter);
     // IsFiltered returns true if the loaded policy has been filtered.
     bool IsFiltered();
     // SavePolicy saves the current policy (usually after changed with caep API) back to file or database.
     void SavePolicy();
+
+    // SaveSnapshotFile writes the model, the policy and the role graph to a binary snapshot file.
+    void SaveSnapshotFile(const std::string& path);
+
+    // LoadSnapshotFile replaces the model, the policy and the role graph by those of a snapshot file,
+    // which is mapped instead of parsed. The adapter is left as it is, SavePolicy still writes to it.
+    void LoadSnapshotFile(const std::string& path);
     // EnableCeaper changes the enforcing state of Caep, when Caep is disabled, all access will be allowed by the Ceap() function.
     void EnableCeaper(bool enable);
     // EnableAutoSave controls whether to save a policy rule automatically to the adapter when it is added or deleted.
@@ -136,7 +212,13 @@ public:
     void BuildIncrementalRoleLinks(policy_op op, const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
     // Caep with a vector param, whether a "subject" can access a "resource" with the operation "action", input parameters are usually: (sub, res, act).
     bool Caep(const std::vector<std::string>& params);
-    // BatchCaeper enforce in batchs.
+    // CaepWithMatcher use a custom matcher to decides whether a "subject" can access a "resource" with the operation "action".
+    // The matcher is compiled on every call, use Caep for the model condition.
+    bool CaepWithMatcher(const std::string& matcher, const std::vector<std::string>& params);
+    // CaepEx decides as Caep does and returns the rule that decided with the matcher terms that held for it.
+    // It bypasses the decision cache, the cache keeps no rules.
+    Explanation CaepEx(const std::vector<std::string>& params);
+    // BatchCaeper enforce in batchs, the results keep the order of the requests.
     std::vector<bool> BatchCaeper(const std::vector<std::vector<std::string>>& reqs);
 
     /**
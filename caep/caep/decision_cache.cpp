@@ -0,0 +1,128 @@
+#ifndef CAEP_DECISION_CACHE_CPP
+#define CAEP_DECISION_CACHE_CPP
+
+#include <algorithm>
+#include <functional>
+
+#include "./decision_cache.h"
+#include "../exception/caep_exception.h"
+
+namespace caep {
+
+DecisionCache::DecisionCache(size_t capacity, size_t shard_count) : m_capacity(capacity) {
+    if(capacity == 0)
+        throw IllegalArgumentException("the capacity of a decision cache should be at least 1");
+
+    shard_count = std::max<size_t>(1, std::min(shard_count, capacity));
+    m_shard_capacity = (capacity + shard_count - 1) / shard_count;
+    for(size_t i = 0; i < shard_count; ++i)
+        m_shards.emplace_back(new Shard());
+}
+
+std::string DecisionCache::Key(const std::vector<std::string>& req) {
+    size_t length = 0;
+    for(const auto& value : req)
+        length += value.size() + sizeof(uint32_t);
+
+    std::string key;
+    key.reserve(length);
+    for(const auto& value : req) {
+        uint32_t size = uint32_t(value.size());
+        key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        key.append(value);
+    }
+    return key;
+}
+
+DecisionCache::Shard& DecisionCache::ShardOf(const std::string& key) {
+    return *m_shards[std::hash<std::string>()(key) % m_shards.size()];
+}
+
+bool DecisionCache::Get(const std::vector<std::string>& req, uint64_t generation, bool& decision) {
+    std::string key = Key(req);
+    Shard& shard = ShardOf(key);
+    MutexLockGuard lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if(it == shard.index.end()) {
+        ++shard.misses;
+        return false;
+    }
+
+    // A decision made under an older policy is dropped right away.
+    if(it->second->generation != generation) {
+        shard.entries.erase(it->second);
+        shard.index.erase(it);
+        ++shard.misses;
+        return false;
+    }
+
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    decision = it->second->decision;
+    ++shard.hits;
+    return true;
+}
+
+void DecisionCache::Put(const std::vector<std::string>& req, uint64_t generation, bool decision) {
+    std::string key = Key(req);
+    Shard& shard = ShardOf(key);
+    MutexLockGuard lock(shard.mutex);
+
+    auto it = shard.index.find(key);
+    if(it != shard.index.end()) {
+        it->second->generation = generation;
+        it->second->decision = decision;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+
+    if(shard.entries.size() >= m_shard_capacity) {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+    }
+    shard.entries.push_front(Entry{key, generation, decision});
+    shard.index.emplace(std::move(key), shard.entries.begin());
+}
+
+void DecisionCache::Clear() {
+    for(auto& shard : m_shards) {
+        MutexLockGuard lock(shard->mutex);
+        shard->entries.clear();
+        shard->index.clear();
+    }
+}
+
+size_t DecisionCache::Capacity() const {
+    return m_capacity;
+}
+
+size_t DecisionCache::Size() const {
+    size_t size = 0;
+    for(auto& shard : m_shards) {
+        MutexLockGuard lock(shard->mutex);
+        size += shard->entries.size();
+    }
+    return size;
+}
+
+uint64_t DecisionCache::Hits() const {
+    uint64_t hits = 0;
+    for(auto& shard : m_shards) {
+        MutexLockGuard lock(shard->mutex);
+        hits += shard->hits;
+    }
+    return hits;
+}
+
+uint64_t DecisionCache::Misses() const {
+    uint64_t misses = 0;
+    for(auto& shard : m_shards) {
+        MutexLockGuard lock(shard->mutex);
+        misses += shard->misses;
+    }
+    return misses;
+}
+
+} // namespace caep
+
+#endif
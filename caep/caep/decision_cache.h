@@ -0,0 +1,68 @@
+#ifndef CAEP_DECISION_CACHE_H
+#define CAEP_DECISION_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../log/thread_util/mutex_lock.h"
+
+namespace caep {
+
+// DecisionCache remembers the decisions of Caep for recent requests. It is split into shards, each
+// one an LRU list behind its own mutex, so that concurrent readers rarely contend.
+//
+// Every decision is stored with the policy generation it was made at. Caeper bumps the generation
+// whenever the policy, the role links or the settings that affect a decision change, a decision of
+// an older generation is a miss, so the cache never has to be walked to be invalidated.
+class DecisionCache {
+private:
+    class Entry {
+    public:
+        std::string key;
+        uint64_t generation;
+        bool decision;
+    };
+
+    class Shard {
+    public:
+        MutexLock mutex;
+        std::list<Entry> entries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    size_t m_capacity;
+    size_t m_shard_capacity;
+
+    // Key encodes every field with its length, so that {"a,b", "c"} and {"a", "b,c"} differ.
+    static std::string Key(const std::vector<std::string>& req);
+
+    Shard& ShardOf(const std::string& key);
+
+public:
+    // DecisionCache keeps at most capacity decisions spread over shard_count shards.
+    DecisionCache(size_t capacity, size_t shard_count = 16);
+
+    // Get returns true and sets decision if req was decided at generation.
+    bool Get(const std::vector<std::string>& req, uint64_t generation, bool& decision);
+
+    // Put stores the decision made for req at generation, evicting the least recently used one if the shard is full.
+    void Put(const std::vector<std::string>& req, uint64_t generation, bool decision);
+
+    void Clear();
+
+    size_t Capacity() const;
+    size_t Size() const;
+    uint64_t Hits() const;
+    uint64_t Misses() const;
+};
+
+} // namespace caep
+
+#endif
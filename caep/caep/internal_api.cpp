@@ -13,6 +13,7 @@ bool Caeper::addPolicy(const std::string& sec, const std::string& p_type, const
     bool rule_added = m_model->AddPolicy(sec, p_type, rule);
     if(!rule_added)
         return rule_added;
+    ++m_generation;
 
     if (sec == "r") {
         std::vector<std::vector<std::string>> rules{rule};
@@ -35,6 +36,7 @@ bool Caeper::addPolicies(const std::string& sec, const std::string& p_type, cons
     bool rules_added = m_model->AddPolicies(sec, p_type, rules);
     if (!rules_added)
         return rules_added;
+    ++m_generation;
 
     if (sec == "r")
         this->BuildIncrementalRoleLinks(policy_add, p_type, rules);
@@ -42,7 +44,13 @@ bool Caeper::addPolicies(const std::string& sec, const std::string& p_type, cons
 
     if (m_adapter && m_auto_save) {
         try {
-            std::dynamic_pointer_cast<BatchAdapter>(m_adapter)->AddPolicies(sec, p_type, rules);
+            auto batch_adapter = std::dynamic_pointer_cast<BatchAdapter>(m_adapter);
+            if (batch_adapter != nullptr)
+                batch_adapter->AddPolicies(sec, p_type, rules);
+            else {
+                for (const auto& rule : rules)
+                    m_adapter->AddPolicy(sec, p_type, rule);
+            }
         }
         catch (UnsupportedOperationException e) {
         }
@@ -56,10 +64,11 @@ bool Caeper::removePolicy(const std::string& sec, const std::string& p_type, con
     bool rule_removed = m_model->RemovePolicy(sec, p_type, rule);
     if(!rule_removed)
         return rule_removed;
+    ++m_generation;
 
     if (sec == "r") {
         std::vector<std::vector<std::string>> rules{rule};
-        this->BuildIncrementalRoleLinks(policy_add, p_type, rules);
+        this->BuildIncrementalRoleLinks(policy_remove, p_type, rules);
     }
     
     if (m_adapter && m_auto_save) {
@@ -75,16 +84,23 @@ bool Caeper::removePolicy(const std::string& sec, const std::string& p_type, con
 
 // removePolicies removes rules from the current policy.
 bool Caeper::removePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
-    bool rules_removed = m_model->AddPolicies(sec, p_type, rules);
+    bool rules_removed = m_model->RemovePolicies(sec, p_type, rules);
     if (!rules_removed)
         return rules_removed;
+    ++m_generation;
 
     if (sec == "r")
-        this->BuildIncrementalRoleLinks(policy_add, p_type, rules);
+        this->BuildIncrementalRoleLinks(policy_remove, p_type, rules);
 
     if (m_adapter && m_auto_save) {
         try{
-            std::dynamic_pointer_cast<BatchAdapter>(m_adapter)->RemovePolicies(sec, p_type, rules);
+            auto batch_adapter = std::dynamic_pointer_cast<BatchAdapter>(m_adapter);
+            if (batch_adapter != nullptr)
+                batch_adapter->RemovePolicies(sec, p_type, rules);
+            else {
+                for (const auto& rule : rules)
+                    m_adapter->RemovePolicy(sec, p_type, rule);
+            }
         }
         catch (UnsupportedOperationException e){
         }
@@ -101,6 +117,7 @@ bool Caeper::removeFilteredPolicy(const std::string& sec, const std::string& p_t
 
     if(!rule_removed)
         return rule_removed;
+    ++m_generation;
 
     if (sec == "r")
         this->BuildIncrementalRoleLinks(policy_remove, p_type, effects);
@@ -120,11 +137,23 @@ bool Caeper::updatePolicy(const std::string& sec, const std::string& p_type, con
     bool is_rule_updated = m_model->UpdatePolicy(sec, p_type, oldRule, newRule);
     if(!is_rule_updated)
         return false;
+    ++m_generation;
     
     if(sec == "r") {
         this->BuildIncrementalRoleLinks(policy_remove, p_type, { oldRule });
         this->BuildIncrementalRoleLinks(policy_add, p_type, { newRule });
     }
+
+    // Adapters have no update, it is saved as the removal of the old rule and the addition of the new one.
+    if (m_adapter && m_auto_save) {
+        try {
+            m_adapter->RemovePolicy(sec, p_type, oldRule);
+            m_adapter->AddPolicy(sec, p_type, newRule);
+        }
+        catch (UnsupportedOperationException e) {
+        }
+    }
+
     return is_rule_updated;
 }
 
@@ -132,12 +161,24 @@ bool Caeper::updatePolicies(const std::string& sec, const std::string& p_type, c
     bool is_rules_updated = m_model->UpdatePolicies(sec, p_type, oldRules, newRules);
     if(!is_rules_updated)
         return false;
+    ++m_generation;
     
     if(sec == "r") {
         this->BuildIncrementalRoleLinks(policy_remove, p_type, oldRules);
         this->BuildIncrementalRoleLinks(policy_add, p_type, newRules);
     }
 
+    if (m_adapter && m_auto_save) {
+        try {
+            for (const auto& oldRule : oldRules)
+                m_adapter->RemovePolicy(sec, p_type, oldRule);
+            for (const auto& newRule : newRules)
+                m_adapter->AddPolicy(sec, p_type, newRule);
+        }
+        catch (UnsupportedOperationException e) {
+        }
+    }
+
     return is_rules_updated;
 }
 
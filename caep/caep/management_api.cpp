@@ -291,6 +291,7 @@ bool Caeper::RemoveFilteredNamedRolePolicy(const std::string& p_type, int field_
 // AddMatcher adds a customized matcher.
 void Caeper::AddMatcher(const std::string& name, MatcherFunc matcher_func) {
     m_matcher->matcher_map[name] = matcher_func;
+    this->LoadPlanFromModel();
 }
 
 
@@ -2,7 +2,11 @@
 #define CAEP_RBAC_API_CPP
 
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "./caeper.h"
+#include "../rbac/default_role_manager.h"
 #include "../exception/caep_enforcer_exception.h"
 #include "../util/caep_util.h"
 
@@ -154,6 +158,31 @@ std::vector<std::vector<std::string>> Caeper::GetImplicitPermissionsForUser(cons
     return res;
 }
 
+// UsersFollowRoleLinks determines whether the users allowed a permission are exactly the allowed
+// subjects of "a" rules and the users that inherit them. It holds only if the subject is matched by
+// RoleMatcher and DefaultMatcher alone, no allowed subject is a pattern and the role manager has no
+// matching function. Otherwise any subject of the policy may be allowed.
+static bool UsersFollowRoleLinks(const ConditionPlan* plan, RoleManager* rm, const std::vector<std::string>& allowed) {
+    DefaultRoleManager* drm = dynamic_cast<DefaultRoleManager*>(rm);
+    if(plan == nullptr || drm == nullptr || drm->HasMatchingFunc())
+        return false;
+
+    for(const auto& clause : plan->clauses) {
+        for(const auto& term : clause) {
+            if(term.kind == TermKind::Role || term.kind == TermKind::Default)
+                continue;
+            if(std::find(term.fields.begin(), term.fields.end(), 0) != term.fields.end())
+                return false;
+        }
+    }
+
+    for(const auto& subject : allowed) {
+        if(subject.find('*') != std::string::npos)
+            return false;
+    }
+    return true;
+}
+
 // GetImplicitUsersForPermission gets implicit users for a permission.
 // For example:
 // a, admin, data1, read
@@ -162,25 +191,50 @@ std::vector<std::vector<std::string>> Caeper::GetImplicitPermissionsForUser(cons
 //
 // GetImplicitUsersForPermission("data1", "read") will get: ["alice", "bob"].
 // Note: only users will be returned, roles (2nd arg in "r") will be excluded.
+// When only subjects of "a" rules and the users that inherit them can be allowed, the candidates are
+// read from the reverse links of the role manager instead of testing every subject of the policy.
 std::vector<std::string> Caeper::GetImplicitUsersForPermission(const std::vector<std::string>& permission) {
     std::vector<std::string> a_subjects = this->GetAllSubjects();
-    std::vector<std::string> r_inherit = m_model->GetValuesForFieldInPolicyAllTypes("r", 1);
-    std::vector<std::string> r_subjects = m_model->GetValuesForFieldInPolicyAllTypes("r", 0);
+    CaepUtil::ArrayRemoveDuplicates(a_subjects);
 
-    std::vector<std::string> subjects(a_subjects);
-    subjects.insert(subjects.end(), r_subjects.begin(), r_subjects.end());
-    CaepUtil::ArrayRemoveDuplicates(subjects);
+    std::vector<std::string> allowed;
+    for(const auto& subject : a_subjects) {
+        if(this->Caep({subject, permission[0], permission[1]}))
+            allowed.push_back(subject);
+    }
 
     std::vector<std::string> res;
-    for(size_t i = 0; i < subjects.size(); i++) {
-        bool allowed = this->Caep({subjects[i], permission[0], permission[1]});
+    if(!UsersFollowRoleLinks(m_plan.get(), this->rm.get(), allowed)) {
+        std::vector<std::string> r_inherit = m_model->GetValuesForFieldInPolicyAllTypes("r", 1);
+        std::vector<std::string> r_subjects = m_model->GetValuesForFieldInPolicyAllTypes("r", 0);
+        std::vector<std::string> subjects = allowed;
+        subjects.insert(subjects.end(), r_subjects.begin(), r_subjects.end());
+        CaepUtil::ArrayRemoveDuplicates(subjects);
+
+        std::unordered_set<std::string> allowed_set(allowed.begin(), allowed.end());
+        for(const auto& subject : subjects) {
+            if(allowed_set.count(subject) || this->Caep({subject, permission[0], permission[1]}))
+                res.push_back(subject);
+        }
+        return CaepUtil::SetSubtract(res, r_inherit);
+    }
 
-        if(allowed) {
-            res.push_back(subjects[i]);
+    std::unordered_set<std::string> visited;
+    for(const auto& subject : allowed) {
+        std::vector<std::string> candidates = this->rm->GetImplicitUsers(subject);
+        candidates.insert(candidates.begin(), subject);
+        for(const auto& candidate : candidates) {
+            if(!visited.insert(candidate).second)
+                continue;
+            // A name that others inherit is a role, roles are excluded.
+            if(this->rm->HasUsers(candidate))
+                continue;
+            // Checked again, a user may be denied what its role is allowed.
+            if(candidate == subject || this->Caep({candidate, permission[0], permission[1]}))
+                res.push_back(candidate);
         }
     }
 
-    res = CaepUtil::SetSubtract(res, r_inherit);
     return res;
 }
 
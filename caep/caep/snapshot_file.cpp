@@ -0,0 +1,218 @@
+#ifndef CAEP_SNAPSHOT_FILE_CPP
+#define CAEP_SNAPSHOT_FILE_CPP
+
+#include <cstdio>
+#include <fstream>
+
+#include "./snapshot_file.h"
+#include "../rbac/default_role_manager.h"
+#include "../exception/io_exception.h"
+#include "../util/mapped_file.h"
+#include "../util/snapshot_io.h"
+
+namespace caep {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'A', 'E', 'P', 'S', 'N', 'A', 'P'};
+const uint64_t BYTE_ORDER_MARK = 0x0102030405060708ULL;
+const size_t HEADER_SIZE = 40;
+
+enum BlockTag : uint32_t {
+    DEFS = 1,
+    SYMS = 2,
+    RULE = 3,
+    ROLE = 4
+};
+
+void PutBlock(SnapshotWriter& out, BlockTag tag, const std::string& payload) {
+    out.Put(uint32_t(tag));
+    out.Put(uint32_t(0));
+    out.Put(uint64_t(payload.size()));
+    out.Put(Checksum(payload));
+    out.PutBytes(payload.data(), payload.size());
+}
+
+void LoadRules(SnapshotReader& in, Model& model) {
+    std::string sec(in.GetString());
+    std::string key(in.GetString());
+    auto it = model.m[sec].section_map.find(key);
+    if(it == model.m[sec].section_map.end())
+        throw IOException("corrupted snapshot: rules of an undefined section " + key);
+
+    uint64_t row_count = in.Get<uint64_t>();
+    uint32_t column_count = in.Get<uint32_t>();
+    size_t symbol_count = model.symbols->Size();
+    std::vector<std::vector<symbol_t>> columns(column_count);
+    for(auto& column : columns) {
+        std::string_view bytes = in.GetBytes(row_count * sizeof(symbol_t));
+        column.resize(row_count);
+        std::memcpy(column.data(), bytes.data(), bytes.size());
+        for(symbol_t id : column) {
+            if(id >= symbol_count && id != NO_SYMBOL)
+                throw IOException("corrupted snapshot: unknown symbol");
+        }
+    }
+
+    it->second->symbols = model.symbols;
+    it->second->LoadColumns(std::move(columns), row_count);
+}
+
+} // namespace
+
+void SnapshotFile::Save(const std::string& path, const PolicySnapshot& snapshot) {
+    const Model& model = *snapshot.model;
+
+    SnapshotWriter defs;
+    uint32_t def_count = 0;
+    for(const auto& sec : model.m)
+        def_count += uint32_t(sec.second.section_map.size());
+    defs.Put(def_count);
+    for(const auto& sec : model.m) {
+        for(const auto& it : sec.second.section_map) {
+            defs.PutString(sec.first);
+            defs.PutString(it.first);
+            defs.PutString(it.second->value);
+        }
+    }
+
+    SnapshotWriter syms;
+    syms.Put(uint32_t(model.symbols->Size()));
+    for(symbol_t id = 0; id < model.symbols->Size(); ++id)
+        syms.PutString(model.symbols->Name(id));
+
+    std::vector<std::string> rules;
+    for(const auto& sec : model.m) {
+        for(const auto& it : sec.second.section_map) {
+            const Section& section = *it.second;
+            if(section.RuleCount() == 0)
+                continue;
+
+            SnapshotWriter out;
+            out.PutString(sec.first);
+            out.PutString(it.first);
+            out.Put(uint64_t(section.RuleCount()));
+            uint32_t column_count = 0;
+            while(section.GetColumn(column_count) != nullptr)
+                ++column_count;
+            out.Put(column_count);
+            for(uint32_t field = 0; field < column_count; ++field) {
+                const symbol_t* column = section.GetColumn(field);
+                if(section.RuleCount() == section.RowCount()) {
+                    out.PutBytes(column, section.RowCount() * sizeof(symbol_t));
+                    continue;
+                }
+                for(size_t row = 0; row < section.RowCount(); ++row) {
+                    if(section.IsLive(row))
+                        out.Put(column[row]);
+                }
+            }
+            rules.push_back(std::move(out.buffer));
+        }
+    }
+
+    SnapshotWriter role;
+    auto rm = std::dynamic_pointer_cast<DefaultRoleManager>(snapshot.rm);
+    bool has_role = rm != nullptr && rm->SaveGraphs(role);
+
+    SnapshotWriter body;
+    PutBlock(body, DEFS, defs.buffer);
+    PutBlock(body, SYMS, syms.buffer);
+    for(const auto& payload : rules)
+        PutBlock(body, RULE, payload);
+    if(has_role)
+        PutBlock(body, ROLE, role.buffer);
+
+    SnapshotWriter header;
+    header.PutBytes(MAGIC, sizeof(MAGIC));
+    header.Put(VERSION);
+    header.Put(uint32_t(2 + rules.size() + (has_role ? 1 : 0)));
+    header.Put(uint64_t(HEADER_SIZE + body.buffer.size()));
+    header.Put(BYTE_ORDER_MARK);
+    header.Put(Checksum(header.buffer));
+
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out_file(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!out_file)
+        throw IOException("Cannot open file.");
+    out_file.write(header.buffer.data(), header.buffer.size());
+    out_file.write(body.buffer.data(), body.buffer.size());
+    out_file.close();
+    if(!out_file || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw IOException("Cannot write snapshot.");
+    }
+}
+
+bool SnapshotFile::Load(const std::string& path, PolicySnapshot& snapshot) {
+    MappedFile file(path);
+    std::string_view data = file.View();
+
+    SnapshotReader header(data);
+    if(header.GetBytes(sizeof(MAGIC)) != std::string_view(MAGIC, sizeof(MAGIC)))
+        throw IOException("not a snapshot file");
+    uint32_t version = header.Get<uint32_t>();
+    uint32_t block_count = header.Get<uint32_t>();
+    uint64_t file_size = header.Get<uint64_t>();
+    uint64_t byte_order = header.Get<uint64_t>();
+    uint64_t checksum = header.Get<uint64_t>();
+    if(checksum != Checksum(data.substr(0, HEADER_SIZE - sizeof(checksum))))
+        throw IOException("corrupted snapshot: header checksum mismatch");
+    if(version != VERSION)
+        throw IOException("unsupported snapshot version " + std::to_string(version));
+    if(byte_order != BYTE_ORDER_MARK)
+        throw IOException("snapshot written on a host of another byte order");
+    if(file_size != data.size())
+        throw IOException("corrupted snapshot: truncated file");
+
+    // Every block is checked before any of them is used, a corrupted snapshot leaves snapshot as it is.
+    std::vector<std::pair<uint32_t, std::string_view>> blocks;
+    SnapshotReader body(data.substr(HEADER_SIZE));
+    for(uint32_t i = 0; i < block_count; ++i) {
+        uint32_t tag = body.Get<uint32_t>();
+        body.Get<uint32_t>();
+        uint64_t size = body.Get<uint64_t>();
+        uint64_t payload_checksum = body.Get<uint64_t>();
+        std::string_view payload = body.GetBytes(size);
+        if(payload_checksum != Checksum(payload))
+            throw IOException("corrupted snapshot: block checksum mismatch");
+        blocks.emplace_back(tag, payload);
+    }
+    if(!body.AtEnd() || blocks.size() < 2 || blocks[0].first != DEFS || blocks[1].first != SYMS)
+        throw IOException("corrupted snapshot: unexpected blocks");
+
+    std::shared_ptr<Model> model(Model::NewModel());
+    SnapshotReader defs(blocks[0].second);
+    for(uint32_t count = defs.Get<uint32_t>(); count > 0; --count) {
+        std::string sec(defs.GetString());
+        std::string key(defs.GetString());
+        model->AddDef(sec, key, std::string(defs.GetString()));
+    }
+
+    // Interned in the order of their ids, every string gets the id it was written with.
+    SnapshotReader syms(blocks[1].second);
+    uint32_t symbol_count = syms.Get<uint32_t>();
+    model->symbols->Reserve(symbol_count);
+    for(uint32_t id = 0; id < symbol_count; ++id) {
+        if(model->symbols->Intern(syms.GetString()) != id)
+            throw IOException("corrupted snapshot: duplicated symbol");
+    }
+
+    bool restored = false;
+    for(size_t i = 2; i < blocks.size(); ++i) {
+        SnapshotReader in(blocks[i].second);
+        if(blocks[i].first == RULE)
+            LoadRules(in, *model);
+        else if(blocks[i].first == ROLE) {
+            auto rm = std::dynamic_pointer_cast<DefaultRoleManager>(snapshot.rm);
+            restored = rm != nullptr && rm->LoadGraphs(in);
+        }
+    }
+
+    snapshot.model = model;
+    return restored;
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef CAEP_SNAPSHOT_FILE_H
+#define CAEP_SNAPSHOT_FILE_H
+
+#include <cstdint>
+#include <string>
+
+#include "./caeper.h"
+
+namespace caep {
+
+// SnapshotFile stores a PolicySnapshot in a binary file that is mapped back without parsing the
+// model or the policy and without replaying a single role link:
+//
+//  header -- "CAEPSNAP", version, count of blocks, size of the file, a byte order mark and the
+//            checksum of the header.
+//  blocks -- tag, size and checksum of the payload, then the payload:
+//            DEFS  the definitions of the model, (sec, key, value) as Model::AddDef takes them.
+//            SYMS  the strings of the SymbolTable in the order of their ids.
+//            RULE  a Section, its key and its rules column by column as symbols.
+//            ROLE  the role graph, as DefaultRoleManager::SaveGraphs writes it.
+//
+// Values are written in host byte order, a snapshot is read back on a host of the same byte order.
+// Tombstones are dropped when rules are written, the rows of a loaded Section are renumbered.
+class SnapshotFile {
+public:
+    static const uint32_t VERSION = 1;
+
+    // Save writes snapshot to path. The file is written aside and renamed over path, a reader never
+    // maps a half written snapshot.
+    static void Save(const std::string& path, const PolicySnapshot& snapshot);
+
+    // Load reads the snapshot at path into a new model of snapshot and restores the role graph into
+    // snapshot.rm, which must be empty. It returns false if the role graph was not restored, eg:
+    // snapshot.rm has a matching function, the role links have to be built from the rules then.
+    // A snapshot of another version, or whose checksums do not match, throws IOException.
+    static bool Load(const std::string& path, PolicySnapshot& snapshot);
+};
+
+} // namespace caep
+
+#endif
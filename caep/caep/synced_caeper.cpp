@@ -0,0 +1,609 @@
+#ifndef CAEP_SYNCED_CAEPER_CPP
+#define CAEP_SYNCED_CAEPER_CPP
+
+#include "./synced_caeper.h"
+#include "../rbac/default_role_manager.h"
+
+namespace caep {
+
+SyncedCaeper::PolicyWriteGuard::PolicyWriteGuard(SyncedCaeper& caeper) : caeper(caeper) {
+    nested = caeper.m_writer.load() == std::this_thread::get_id();
+    if(nested)
+        return;
+    caeper.m_reload_lock.lock();
+    caeper.m_policy_lock.write_lock();
+    caeper.m_writer.store(std::this_thread::get_id());
+}
+
+SyncedCaeper::PolicyWriteGuard::~PolicyWriteGuard() {
+    if(nested)
+        return;
+    caeper.m_writer.store(std::thread::id());
+    caeper.m_policy_lock.unlock();
+    caeper.m_reload_lock.unlock();
+}
+
+void SyncedCaeper::Initialize() {
+    PolicyWriteGuard guard(*this);
+    Caeper::Initialize();
+}
+
+void SyncedCaeper::InitWithFile(const std::string& model_path, const std::string& policy_path) {
+    PolicyWriteGuard guard(*this);
+    Caeper::InitWithFile(model_path, policy_path);
+}
+
+void SyncedCaeper::InitWithAdapter(const std::string& model_path, std::shared_ptr<Adapter> adapter) {
+    PolicyWriteGuard guard(*this);
+    Caeper::InitWithAdapter(model_path, adapter);
+}
+
+void SyncedCaeper::InitWithModelAndAdapter(std::shared_ptr<Model> m, std::shared_ptr<Adapter> adapter) {
+    PolicyWriteGuard guard(*this);
+    Caeper::InitWithModelAndAdapter(m, adapter);
+}
+
+void SyncedCaeper::LoadModel() {
+    PolicyWriteGuard guard(*this);
+    Caeper::LoadModel();
+}
+
+std::shared_ptr<Model> SyncedCaeper::GetModel() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetModel();
+}
+
+void SyncedCaeper::SetModel(std::shared_ptr<Model> m) {
+    MutexLockGuard reload_guard(m_reload_lock);
+    PolicySnapshot snapshot;
+    bool shared_rm;
+    {
+        ReadLockGuard guard(m_policy_lock);
+        snapshot = Caeper::NewPolicySnapshot(m);
+        shared_rm = snapshot.rm == this->rm;
+    }
+    // A shared role manager is rebuilt in place, so readers are kept out while it is.
+    if(!shared_rm)
+        Caeper::BuildSnapshotRoleLinks(snapshot);
+
+    WriteLockGuard guard(m_policy_lock);
+    if(shared_rm)
+        Caeper::BuildSnapshotRoleLinks(snapshot);
+    Caeper::PublishPolicySnapshot(snapshot);
+}
+
+std::shared_ptr<Adapter> SyncedCaeper::GetAdapter() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAdapter();
+}
+
+void SyncedCaeper::SetAdapter(std::shared_ptr<Adapter> adapter) {
+    PolicyWriteGuard guard(*this);
+    Caeper::SetAdapter(adapter);
+}
+
+std::shared_ptr<RoleManager> SyncedCaeper::GetRoleManager() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetRoleManager();
+}
+
+void SyncedCaeper::SetRoleManager(std::shared_ptr<RoleManager> rm) {
+    PolicyWriteGuard guard(*this);
+    Caeper::SetRoleManager(rm);
+}
+
+void SyncedCaeper::SetEffector(std::shared_ptr<Effector> eft) {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::SetEffector(eft);
+}
+
+void SyncedCaeper::EnableDecisionCache(size_t capacity) {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::EnableDecisionCache(capacity);
+}
+
+std::shared_ptr<DecisionCache> SyncedCaeper::GetDecisionCache() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetDecisionCache();
+}
+
+void SyncedCaeper::SetThreadPool(std::shared_ptr<ThreadPool> pool) {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::SetThreadPool(pool);
+}
+
+void SyncedCaeper::LoadPolicy() {
+    this->LoadFilteredPolicy(nullptr);
+}
+
+void SyncedCaeper::LoadFilteredPolicy(Filter* filter) {
+    MutexLockGuard reload_guard(m_reload_lock);
+    PolicySnapshot snapshot;
+    bool shared_rm;
+    {
+        ReadLockGuard guard(m_policy_lock);
+        snapshot = Caeper::NewPolicySnapshot(nullptr);
+        shared_rm = snapshot.rm == this->rm;
+    }
+    // Only the snapshot and the adapter are touched here, unless the role manager is shared.
+    if(!shared_rm)
+        Caeper::LoadPolicySnapshot(snapshot, filter);
+
+    WriteLockGuard guard(m_policy_lock);
+    if(shared_rm)
+        Caeper::LoadPolicySnapshot(snapshot, filter);
+    Caeper::PublishPolicySnapshot(snapshot);
+}
+
+void SyncedCaeper::ClearPolicy() {
+    PolicyWriteGuard guard(*this);
+    Caeper::ClearPolicy();
+}
+
+bool SyncedCaeper::IsFiltered() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::IsFiltered();
+}
+
+void SyncedCaeper::SavePolicy() {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::SavePolicy();
+}
+
+void SyncedCaeper::SaveSnapshotFile(const std::string& path) {
+    ReadLockGuard guard(m_policy_lock);
+    Caeper::SaveSnapshotFile(path);
+}
+
+void SyncedCaeper::LoadSnapshotFile(const std::string& path) {
+    MutexLockGuard reload_guard(m_reload_lock);
+    PolicySnapshot snapshot;
+    bool shared_rm;
+    {
+        ReadLockGuard guard(m_policy_lock);
+        snapshot.rm = Caeper::NewSnapshotRoleManager();
+        shared_rm = snapshot.rm == this->rm;
+    }
+    // The file is mapped and loaded without holding the policy lock, as LoadFilteredPolicy does.
+    if(!shared_rm)
+        Caeper::ReadSnapshotFile(path, snapshot);
+
+    WriteLockGuard guard(m_policy_lock);
+    if(shared_rm)
+        Caeper::ReadSnapshotFile(path, snapshot);
+    Caeper::PublishPolicySnapshot(snapshot);
+}
+
+void SyncedCaeper::EnableCeaper(bool enable) {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::EnableCeaper(enable);
+}
+
+void SyncedCaeper::EnableAutoSave(bool auto_save) {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::EnableAutoSave(auto_save);
+}
+
+void SyncedCaeper::EnableAutoBuildRoleLinks(bool auto_build_role_links) {
+    PolicyWriteGuard guard(*this);
+    Caeper::EnableAutoBuildRoleLinks(auto_build_role_links);
+}
+
+void SyncedCaeper::BuildRoleLinks() {
+    PolicyWriteGuard guard(*this);
+    Caeper::BuildRoleLinks();
+}
+
+void SyncedCaeper::BuildIncrementalRoleLinks(policy_op op, const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    Caeper::BuildIncrementalRoleLinks(op, p_type, rules);
+}
+
+bool SyncedCaeper::Caep(const std::vector<std::string>& params) {
+    ReadLockGuard guard(m_policy_lock);
+    return Caeper::Caep(params);
+}
+
+bool SyncedCaeper::CaepWithMatcher(const std::string& matcher, const std::vector<std::string>& params) {
+    ReadLockGuard guard(m_policy_lock);
+    return Caeper::CaepWithMatcher(matcher, params);
+}
+
+Explanation SyncedCaeper::CaepEx(const std::vector<std::string>& params) {
+    ReadLockGuard guard(m_policy_lock);
+    return Caeper::CaepEx(params);
+}
+
+std::vector<bool> SyncedCaeper::BatchCaeper(const std::vector<std::vector<std::string>>& reqs) {
+    ReadLockGuard guard(m_policy_lock);
+    return Caeper::BatchCaeper(reqs);
+}
+
+std::vector<std::string> SyncedCaeper::GetRolesForUser(const std::string& name, const std::vector<std::string>& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetRolesForUser(name, domain);
+}
+
+std::vector<std::string> SyncedCaeper::GetUsersForRole(const std::string& name, const std::vector<std::string>& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetUsersForRole(name, domain);
+}
+
+bool SyncedCaeper::HasRoleForUser(const std::string& name, const std::string& role) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::HasRoleForUser(name, role);
+}
+
+bool SyncedCaeper::AddRoleForUser(const std::string& user, const std::string& role) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddRoleForUser(user, role);
+}
+
+bool SyncedCaeper::AddRolesForUser(const std::string& user, const std::vector<std::string>& roles) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddRolesForUser(user, roles);
+}
+
+bool SyncedCaeper::AddPermissionForUser(const std::string& user, const std::vector<std::string>& permission) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddPermissionForUser(user, permission);
+}
+
+bool SyncedCaeper::DeletePermissionForUser(const std::string& user, const std::vector<std::string>& permission) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeletePermissionForUser(user, permission);
+}
+
+bool SyncedCaeper::DeletePermissionsForUser(const std::string& user) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeletePermissionsForUser(user);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetPermissionsForUser(const std::string& user) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetPermissionsForUser(user);
+}
+
+bool SyncedCaeper::HasPermissionForUser(const std::string& user, const std::vector<std::string>& permission) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::HasPermissionForUser(user, permission);
+}
+
+std::vector<std::string> SyncedCaeper::GetImplicitRolesForUser(const std::string& name, const std::vector<std::string>& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetImplicitRolesForUser(name, domain);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetImplicitPermissionsForUser(const std::string& user, const std::vector<std::string>& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetImplicitPermissionsForUser(user, domain);
+}
+
+std::vector<std::string> SyncedCaeper::GetImplicitUsersForPermission(const std::vector<std::string>& permission) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetImplicitUsersForPermission(permission);
+}
+
+bool SyncedCaeper::DeleteRoleForUser(const std::string& user, const std::string& role) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeleteRoleForUser(user, role);
+}
+
+bool SyncedCaeper::DeleteRolesForUser(const std::string& user) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeleteRolesForUser(user);
+}
+
+bool SyncedCaeper::DeleteUser(const std::string& user) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeleteUser(user);
+}
+
+bool SyncedCaeper::DeleteRole(const std::string& role) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeleteRole(role);
+}
+
+bool SyncedCaeper::DeletePermission(const std::vector<std::string>& permission) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeletePermission(permission);
+}
+
+std::vector<std::string> SyncedCaeper::GetAllSubjects() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllSubjects();
+}
+
+std::vector<std::string> SyncedCaeper::GetAllNamedSubjects(const std::string& p_type) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllNamedSubjects(p_type);
+}
+
+std::vector<std::string> SyncedCaeper::GetAllResources() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllResources();
+}
+
+std::vector<std::string> SyncedCaeper::GetAllNamedResources(const std::string& p_type) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllNamedResources(p_type);
+}
+
+std::vector<std::string> SyncedCaeper::GetAllActions() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllActions();
+}
+
+std::vector<std::string> SyncedCaeper::GetAllNamedActions(const std::string& p_type) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllNamedActions(p_type);
+}
+
+std::vector<std::string> SyncedCaeper::GetAllRoles() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllRoles();
+}
+
+std::vector<std::string> SyncedCaeper::GetAllNamedRoles(const std::string& p_type) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetAllNamedRoles(p_type);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetPolicy() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetPolicy();
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetFilteredPolicy(int field_index, const std::vector<std::string>& field_values) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetFilteredPolicy(field_index, field_values);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetNamedPolicy(const std::string& p_type) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetNamedPolicy(p_type);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetFilteredNamedPolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetFilteredNamedPolicy(p_type, field_index, field_values);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetRolePolicy() {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetRolePolicy();
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetFilteredRolePolicy(int field_index, const std::vector<std::string>& field_values) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetFilteredRolePolicy(field_index, field_values);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetNamedRolePolicy(const std::string& p_type) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetNamedRolePolicy(p_type);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetFilteredNamedRolePolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetFilteredNamedRolePolicy(p_type, field_index, field_values);
+}
+
+bool SyncedCaeper::HasPolicy(const std::vector<std::string>& params) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::HasPolicy(params);
+}
+
+bool SyncedCaeper::HasNamedPolicy(const std::string& p_type, const std::vector<std::string>& params) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::HasNamedPolicy(p_type, params);
+}
+
+bool SyncedCaeper::AddPolicy(const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddPolicy(params);
+}
+
+bool SyncedCaeper::AddPolicies(const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddPolicies(rules);
+}
+
+bool SyncedCaeper::AddNamedPolicy(const std::string& p_type, const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddNamedPolicy(p_type, params);
+}
+
+bool SyncedCaeper::AddNamedPolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddNamedPolicies(p_type, rules);
+}
+
+bool SyncedCaeper::RemovePolicy(const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemovePolicy(params);
+}
+
+bool SyncedCaeper::RemovePolicies(const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemovePolicies(rules);
+}
+
+bool SyncedCaeper::RemoveFilteredPolicy(int field_index, const std::vector<std::string>& field_values) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveFilteredPolicy(field_index, field_values);
+}
+
+bool SyncedCaeper::RemoveNamedPolicy(const std::string& p_type, const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveNamedPolicy(p_type, params);
+}
+
+bool SyncedCaeper::RemoveNamedPolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveNamedPolicies(p_type, rules);
+}
+
+bool SyncedCaeper::RemoveFilteredNamedPolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveFilteredNamedPolicy(p_type, field_index, field_values);
+}
+
+bool SyncedCaeper::HasRolePolicy(const std::vector<std::string>& params) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::HasRolePolicy(params);
+}
+
+bool SyncedCaeper::HasNamedRolePolicy(const std::string& p_type, const std::vector<std::string>& params) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::HasNamedRolePolicy(p_type, params);
+}
+
+bool SyncedCaeper::AddRolePolicy(const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddRolePolicy(params);
+}
+
+bool SyncedCaeper::AddRolePolicies(const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddRolePolicies(rules);
+}
+
+bool SyncedCaeper::AddNamedRolePolicy(const std::string& p_type, const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddNamedRolePolicy(p_type, params);
+}
+
+bool SyncedCaeper::AddNamedRolePolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddNamedRolePolicies(p_type, rules);
+}
+
+bool SyncedCaeper::RemoveRolePolicy(const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveRolePolicy(params);
+}
+
+bool SyncedCaeper::RemoveRolePolicies(const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveRolePolicies(rules);
+}
+
+bool SyncedCaeper::RemoveFilteredRolePolicy(int field_index, const std::vector<std::string>& field_values) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveFilteredRolePolicy(field_index, field_values);
+}
+
+bool SyncedCaeper::RemoveNamedRolePolicy(const std::string& p_type, const std::vector<std::string>& params) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveNamedRolePolicy(p_type, params);
+}
+
+bool SyncedCaeper::RemoveNamedRolePolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveNamedRolePolicies(p_type, rules);
+}
+
+bool SyncedCaeper::RemoveFilteredNamedRolePolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::RemoveFilteredNamedRolePolicy(p_type, field_index, field_values);
+}
+
+void SyncedCaeper::AddMatcher(const std::string& name, MatcherFunc matcher_func) {
+    WriteLockGuard guard(m_policy_lock);
+    Caeper::AddMatcher(name, matcher_func);
+}
+
+bool SyncedCaeper::UpdateRolePolicy(const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::UpdateRolePolicy(oldRule, newRule);
+}
+
+bool SyncedCaeper::UpdateNamedRolePolicy(const std::string& ptype, const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::UpdateNamedRolePolicy(ptype, oldRule, newRule);
+}
+
+bool SyncedCaeper::UpdatePolicy(const std::vector<std::string>& oldPolicy, const std::vector<std::string>& newPolicy) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::UpdatePolicy(oldPolicy, newPolicy);
+}
+
+bool SyncedCaeper::UpdateNamedPolicy(const std::string& ptype, const std::vector<std::string>& p1, const std::vector<std::string>& p2) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::UpdateNamedPolicy(ptype, p1, p2);
+}
+
+bool SyncedCaeper::UpdatePolicies(const std::vector<std::vector<std::string>>& oldPolices, const std::vector<std::vector<std::string>>& newPolicies) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::UpdatePolicies(oldPolices, newPolicies);
+}
+
+bool SyncedCaeper::UpdateNamedPolicies(const std::string& ptype, const std::vector<std::vector<std::string>>& p1, const std::vector<std::vector<std::string>>& p2) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::UpdateNamedPolicies(ptype, p1, p2);
+}
+
+bool SyncedCaeper::addPolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& rule) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::addPolicy(sec, p_type, rule);
+}
+
+bool SyncedCaeper::addPolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::addPolicies(sec, p_type, rules);
+}
+
+bool SyncedCaeper::removePolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& rule) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::removePolicy(sec, p_type, rule);
+}
+
+bool SyncedCaeper::removePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::removePolicies(sec, p_type, rules);
+}
+
+bool SyncedCaeper::removeFilteredPolicy(const std::string& sec, const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::removeFilteredPolicy(sec, p_type, field_index, field_values);
+}
+
+bool SyncedCaeper::updatePolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::updatePolicy(sec, p_type, oldRule, newRule);
+}
+
+bool SyncedCaeper::updatePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& p1, const std::vector<std::vector<std::string>>& p2) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::updatePolicies(sec, p_type, p1, p2);
+}
+
+std::vector<std::string> SyncedCaeper::GetUsersForRoleInDomain(const std::string& name, const std::string& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetUsersForRoleInDomain(name, domain);
+}
+
+std::vector<std::string> SyncedCaeper::GetRolesForUserInDomain(const std::string& name, const std::string& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetRolesForUserInDomain(name, domain);
+}
+
+std::vector<std::vector<std::string>> SyncedCaeper::GetPermissionsForUserInDomain(const std::string& user, const std::string& domain) {
+    WriteLockGuard guard(m_policy_lock);
+    return Caeper::GetPermissionsForUserInDomain(user, domain);
+}
+
+bool SyncedCaeper::AddRoleForUserInDomain(const std::string& user, const std::string& role, const std::string& domain) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::AddRoleForUserInDomain(user, role, domain);
+}
+
+bool SyncedCaeper::DeleteRoleForUserInDomain(const std::string& user, const std::string& role, const std::string& domain) {
+    PolicyWriteGuard guard(*this);
+    return Caeper::DeleteRoleForUserInDomain(user, role, domain);
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef CAEP_SYNCED_CAEPER_H
+#define CAEP_SYNCED_CAEPER_H
+
+#include <atomic>
+#include <thread>
+
+#include "./caeper.h"
+#include "../log/thread_util/rw_lock.h"
+#include "../log/thread_util/mutex_lock.h"
+
+namespace caep {
+
+// SyncedCaeper is a Caeper that can be shared by threads. Enforcement takes the policy lock in
+// shared mode, so concurrent Caep calls do not serialize, while policy management and the RBAC
+// API take it in exclusive mode. The public member rm is not guarded, reach it through the API.
+//
+// LoadPolicy, LoadFilteredPolicy and SetModel build the new policy without holding the policy lock
+// and only take it in exclusive mode to publish it, enforcement keeps running on the old policy
+// meanwhile. m_reload_lock keeps reloads apart from each other and from the calls that change what
+// a reload reads, so a rule added during a reload is not lost when the reload publishes.
+class SyncedCaeper : public Caeper {
+private:
+    RWLock m_policy_lock;
+    MutexLock m_reload_lock;
+
+    // The thread that holds both locks for a policy change, the management and RBAC APIs call each
+    // other and a nested change on that thread does not lock again.
+    std::atomic<std::thread::id> m_writer;
+
+    // PolicyWriteGuard takes m_reload_lock and then m_policy_lock in exclusive mode, unless the
+    // calling thread holds them already.
+    class PolicyWriteGuard : noncopyable {
+    private:
+        SyncedCaeper& caeper;
+        bool nested;
+
+    public:
+        explicit PolicyWriteGuard(SyncedCaeper& caeper);
+        ~PolicyWriteGuard();
+    };
+
+public:
+    using Caeper::Caeper;
+
+    // All of the others hold the policy alone, RBAC queries included since the RoleManager may
+    // change roles while answering them.
+    void Initialize();
+    void InitWithFile(const std::string& model_path, const std::string& policy_path);
+    void InitWithAdapter(const std::string& model_path, std::shared_ptr<Adapter> adapter);
+    void InitWithModelAndAdapter(std::shared_ptr<Model> m, std::shared_ptr<Adapter> adapter);
+    void LoadModel();
+    std::shared_ptr<Model> GetModel();
+    void SetModel(std::shared_ptr<Model> m);
+    std::shared_ptr<Adapter> GetAdapter();
+    void SetAdapter(std::shared_ptr<Adapter> adapter);
+    std::shared_ptr<RoleManager> GetRoleManager();
+    void SetRoleManager(std::shared_ptr<RoleManager> rm);
+    void SetEffector(std::shared_ptr<Effector> eft);
+    void EnableDecisionCache(size_t capacity);
+    std::shared_ptr<DecisionCache> GetDecisionCache();
+    void SetThreadPool(std::shared_ptr<ThreadPool> pool);
+    void LoadPolicy();
+    void LoadFilteredPolicy(Filter* filter);
+    void ClearPolicy();
+    bool IsFiltered();
+    void SavePolicy();
+    void SaveSnapshotFile(const std::string& path);
+    void LoadSnapshotFile(const std::string& path);
+    void EnableCeaper(bool enable);
+    void EnableAutoSave(bool auto_save);
+    void EnableAutoBuildRoleLinks(bool auto_build_role_links);
+    void BuildRoleLinks();
+    void BuildIncrementalRoleLinks(policy_op op, const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    // Caep, CaepWithMatcher, CaepEx and BatchCaeper share the policy, any number of them run at once.
+    bool Caep(const std::vector<std::string>& params);
+    bool CaepWithMatcher(const std::string& matcher, const std::vector<std::string>& params);
+    Explanation CaepEx(const std::vector<std::string>& params);
+    std::vector<bool> BatchCaeper(const std::vector<std::vector<std::string>>& reqs);
+
+    /**
+     * @breif Caep RBAC API.
+     */
+    std::vector<std::string> GetRolesForUser(const std::string& name, const std::vector<std::string>& domain = {});
+    std::vector<std::string> GetUsersForRole(const std::string& name, const std::vector<std::string>& domain = {});
+    bool HasRoleForUser(const std::string& name, const std::string& role);
+    bool AddRoleForUser(const std::string& user, const std::string& role);
+    bool AddRolesForUser(const std::string& user, const std::vector<std::string>& roles);
+    bool AddPermissionForUser(const std::string& user, const std::vector<std::string>& permission);
+    bool DeletePermissionForUser(const std::string& user, const std::vector<std::string>& permission);
+    bool DeletePermissionsForUser(const std::string& user);
+    std::vector<std::vector<std::string>> GetPermissionsForUser(const std::string& user);
+    bool HasPermissionForUser(const std::string& user, const std::vector<std::string>& permission);
+    std::vector<std::string> GetImplicitRolesForUser(const std::string& name, const std::vector<std::string>& domain = {});
+    std::vector<std::vector<std::string>> GetImplicitPermissionsForUser(const std::string& user, const std::vector<std::string>& domain = {});
+    std::vector<std::string> GetImplicitUsersForPermission(const std::vector<std::string>& permission);
+    bool DeleteRoleForUser(const std::string& user, const std::string& role);
+    bool DeleteRolesForUser(const std::string& user);
+    bool DeleteUser(const std::string& user);
+    bool DeleteRole(const std::string& role);
+    bool DeletePermission(const std::vector<std::string>& permission);
+
+    /**
+     * @breif Caep Management API.
+     */
+    std::vector<std::string> GetAllSubjects();
+    std::vector<std::string> GetAllNamedSubjects(const std::string& p_type);
+    std::vector<std::string> GetAllResources();
+    std::vector<std::string> GetAllNamedResources(const std::string& p_type);
+    std::vector<std::string> GetAllActions();
+    std::vector<std::string> GetAllNamedActions(const std::string& p_type);
+    std::vector<std::string> GetAllRoles();
+    std::vector<std::string> GetAllNamedRoles(const std::string& p_type);
+    std::vector<std::vector<std::string>> GetPolicy();
+    std::vector<std::vector<std::string>> GetFilteredPolicy(int field_index, const std::vector<std::string>& field_values);
+    std::vector<std::vector<std::string>> GetNamedPolicy(const std::string& p_type);
+    std::vector<std::vector<std::string>> GetFilteredNamedPolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values);
+    std::vector<std::vector<std::string>> GetRolePolicy();
+    std::vector<std::vector<std::string>> GetFilteredRolePolicy(int field_index, const std::vector<std::string>& field_values);
+    std::vector<std::vector<std::string>> GetNamedRolePolicy(const std::string& p_type);
+    std::vector<std::vector<std::string>> GetFilteredNamedRolePolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values);
+    bool HasPolicy(const std::vector<std::string>& params);
+    bool HasNamedPolicy(const std::string& p_type, const std::vector<std::string>& params);
+    bool AddPolicy(const std::vector<std::string>& params);
+    bool AddPolicies(const std::vector<std::vector<std::string>>& rules);
+    bool AddNamedPolicy(const std::string& p_type, const std::vector<std::string>& params);
+    bool AddNamedPolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    bool RemovePolicy(const std::vector<std::string>& params);
+    bool RemovePolicies(const std::vector<std::vector<std::string>>& rules);
+    bool RemoveFilteredPolicy(int field_index, const std::vector<std::string>& field_values);
+    bool RemoveNamedPolicy(const std::string& p_type, const std::vector<std::string>& params);
+    bool RemoveNamedPolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    bool RemoveFilteredNamedPolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values);
+    bool HasRolePolicy(const std::vector<std::string>& params);
+    bool HasNamedRolePolicy(const std::string& p_type, const std::vector<std::string>& params);
+    bool AddRolePolicy(const std::vector<std::string>& params);
+    bool AddRolePolicies(const std::vector<std::vector<std::string>>& rules);
+    bool AddNamedRolePolicy(const std::string& p_type, const std::vector<std::string>& params);
+    bool AddNamedRolePolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    bool RemoveRolePolicy(const std::vector<std::string>& params);
+    bool RemoveRolePolicies(const std::vector<std::vector<std::string>>& rules);
+    bool RemoveFilteredRolePolicy(int field_index, const std::vector<std::string>& field_values);
+    bool RemoveNamedRolePolicy(const std::string& p_type, const std::vector<std::string>& params);
+    bool RemoveNamedRolePolicies(const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    bool RemoveFilteredNamedRolePolicy(const std::string& p_type, int field_index, const std::vector<std::string>& field_values);
+    void AddMatcher(const std::string& name, MatcherFunc matcher_func);
+    bool UpdateRolePolicy(const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule);
+    bool UpdateNamedRolePolicy(const std::string& ptype, const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule);
+    bool UpdatePolicy(const std::vector<std::string>& oldPolicy, const std::vector<std::string>& newPolicy);
+    bool UpdateNamedPolicy(const std::string& ptype, const std::vector<std::string>& p1, const std::vector<std::string>& p2);
+    bool UpdatePolicies(const std::vector<std::vector<std::string>>& oldPolices, const std::vector<std::vector<std::string>>& newPolicies);
+    bool UpdateNamedPolicies(const std::string& ptype, const std::vector<std::vector<std::string>>& p1, const std::vector<std::vector<std::string>>& p2);
+
+    /**
+     * @breif Caep internal API member functions
+     */
+    bool addPolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& rule);
+    bool addPolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    bool removePolicy(const std::string& sec , const std::string& p_type , const std::vector<std::string>& rule);
+    bool removePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
+    bool removeFilteredPolicy(const std::string& sec, const std::string& p_type, int field_index, const std::vector<std::string>& field_values);
+    bool updatePolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule);
+    bool updatePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& p1, const std::vector<std::vector<std::string>>& p2);
+
+    /**
+     * @breif Caep RBAC API with domains.
+     */
+    std::vector<std::string> GetUsersForRoleInDomain(const std::string& name, const std::string& domain);
+    std::vector<std::string> GetRolesForUserInDomain(const std::string& name, const std::string& domain);
+    std::vector<std::vector<std::string>> GetPermissionsForUserInDomain(const std::string& user, const std::string& domain);
+    bool AddRoleForUserInDomain(const std::string& user, const std::string& role, const std::string& domain);
+    bool DeleteRoleForUserInDomain(const std::string& user, const std::string& role, const std::string& domain);
+};
+
+} // namespace caep
+
+#endif
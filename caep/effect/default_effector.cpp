@@ -3,6 +3,7 @@
 
 #include "./default_effector.h"
 #include "../exception/caep_exception.h"
+#include "../model/column_matcher.h"
 
 namespace caep {
 
@@ -31,7 +32,14 @@ bool DefaultEffector::MergeEffects(std::string expr, std::vector<Effect> effects
             }
     }
     else if(!expr.compare("FirstPriority")) {
-        result = effects[0] == Effect::Allow;
+        // Indeterminate effects are skipped, such as the ones of removed rules.
+        result = false;
+        for(size_t i = 0; i < effects.size(); ++i) {
+            if(effects[i] != Effect::Indeterminate) {
+                result = effects[i] == Effect::Allow;
+                break;
+            }
+        }
     }
     else {
         throw UnsupportedOperationException("Unsupported effect");
@@ -41,6 +49,112 @@ bool DefaultEffector::MergeEffects(std::string expr, std::vector<Effect> effects
 
 }
 
+/**
+ * @breif MergeMask decides from the masks of matched and live rules, a word at a time.
+ * @breif AllowPriority looks for any matched rule, DenyPriority for any live rule that did not match,
+ * @breif FirstPriority finds the first live rule and tests its bit.
+ */
+bool DefaultEffector::MergeMask(const std::string& /* expr */, EffectKind kind, const std::vector<uint64_t>& matched, const std::vector<uint64_t>& live, size_t /* row_count */) {
+    switch(kind) {
+    case EffectKind::AllowPriority:
+        for(size_t i = 0; i < live.size(); ++i) {
+            if(matched[i] & live[i])
+                return true;
+        }
+        return false;
+    case EffectKind::DenyPriority:
+        for(size_t i = 0; i < live.size(); ++i) {
+            if(live[i] & ~matched[i])
+                return false;
+        }
+        return true;
+    case EffectKind::FirstPriority: {
+        size_t row = ColumnMatcher::FirstRow(live);
+        return row != NO_ROW && (matched[row >> 6] >> (row & 63) & 1);
+    }
+    default:
+        break;
+    }
+
+    throw UnsupportedOperationException("Unsupported effect");
+}
+
+/**
+ * @breif Begin starts a decision, an unknown effect throws UnsupportedOperationException.
+ */
+void DefaultEffector::Begin(const std::string& expr, EffectKind kind, size_t row_count, EffectStream& stream) {
+    if(kind == EffectKind::Custom)
+        throw UnsupportedOperationException("Unsupported effect");
+
+    stream.expr = expr;
+    stream.kind = kind;
+    stream.row_count = row_count;
+    stream.final = false;
+    stream.result = false;
+    stream.fed = 0;
+    stream.row = SIZE_MAX;
+}
+
+/**
+ * @breif Feed decides from a word of rows, nothing is kept between words.
+ */
+bool DefaultEffector::Feed(EffectStream& stream, uint64_t matched, uint64_t live) {
+    // The rows that make the decision final, the lowest one decides.
+    uint64_t deciding = 0;
+    switch(stream.kind) {
+    case EffectKind::AllowPriority:
+        deciding = matched & live;
+        break;
+    case EffectKind::DenyPriority:
+        deciding = live & ~matched;
+        break;
+    case EffectKind::FirstPriority:
+        // Tombstones are skipped, the lowest live row decides.
+        deciding = live & (~live + 1);
+        break;
+    default:
+        break;
+    }
+
+    if(deciding != 0) {
+        int bit = __builtin_ctzll(deciding);
+        stream.final = true;
+        stream.result = (matched >> bit) & 1;
+        stream.row = stream.fed * 64 + size_t(bit);
+    }
+    ++stream.fed;
+    return stream.final;
+}
+
+/**
+ * @breif Skip passes over words without matched rows. No such row allows, so AllowPriority is not decided by them,
+ * @breif while the first live one denies for DenyPriority and FirstPriority.
+ */
+bool DefaultEffector::Skip(EffectStream& stream, const std::vector<uint64_t>& live, size_t begin_word, size_t end_word) {
+    if(stream.kind != EffectKind::AllowPriority) {
+        for(size_t i = begin_word; i < end_word; ++i) {
+            if(live[i] != 0) {
+                stream.final = true;
+                stream.result = false;
+                stream.row = i * 64 + size_t(__builtin_ctzll(live[i]));
+                stream.fed = i + 1;
+                return true;
+            }
+        }
+    }
+    stream.fed = end_word;
+    return false;
+}
+
+/**
+ * @breif End returns the decision, without a final word AllowPriority and FirstPriority deny and DenyPriority allows.
+ */
+bool DefaultEffector::End(EffectStream& stream) {
+    if(stream.final)
+        return stream.result;
+    return stream.kind == EffectKind::DenyPriority;
+}
+
 } // namespace ceap 
 
 
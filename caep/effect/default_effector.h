@@ -14,6 +14,29 @@ public:
     * @breif MergeEffects merges all matching results collected by the enforcer into a single decision.
     */
     bool MergeEffects(std::string expr, std::vector<Effect> effects, std::vector<float> results);
+
+    /**
+    * @breif MergeMask decides from the masks of matched and live rules, a word at a time.
+    */
+    bool MergeMask(const std::string& expr, EffectKind kind, const std::vector<uint64_t>& matched, const std::vector<uint64_t>& live, size_t row_count);
+
+    /**
+    * @breif Begin starts a decision, an unknown effect throws UnsupportedOperationException.
+    */
+    void Begin(const std::string& expr, EffectKind kind, size_t row_count, EffectStream& stream);
+
+    /**
+    * @breif Feed is final at the first allowed rule for AllowPriority, the first denied one for DenyPriority
+    * @breif and the first live one for FirstPriority.
+    */
+    bool Feed(EffectStream& stream, uint64_t matched, uint64_t live);
+
+    /**
+    * @breif Skip costs nothing for AllowPriority, DenyPriority and FirstPriority are final at the first live row.
+    */
+    bool Skip(EffectStream& stream, const std::vector<uint64_t>& live, size_t begin_word, size_t end_word);
+
+    bool End(EffectStream& stream);
 };
 
 } // namespace caep 
@@ -1,6 +1,8 @@
 #ifndef CAEP_EFFECT_H
 #define CAEP_EFFECT_H
 
+#include <string>
+
 namespace caep {
 
 enum class Effect {
@@ -9,6 +11,24 @@ enum class Effect {
 
 typedef enum Effect Effect;
 
+/**
+ * @breif EffectKind is the expression of [effector] resolved once when the model loads.
+ * @breif Custom stands for any other expression, only a custom Effector knows it.
+ */
+enum class EffectKind {
+    AllowPriority, DenyPriority, FirstPriority, Custom
+};
+
+inline EffectKind ParseEffectKind(const std::string& expr) {
+    if(!expr.compare("AllowPriority"))
+        return EffectKind::AllowPriority;
+    if(!expr.compare("DenyPriority"))
+        return EffectKind::DenyPriority;
+    if(!expr.compare("FirstPriority"))
+        return EffectKind::FirstPriority;
+    return EffectKind::Custom;
+}
+
 } 
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef CAEP_EFFECTOR_H
 #define CAEP_EFFECTOR_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -8,6 +9,28 @@
 
 namespace caep {
 
+/**
+* @breif EffectStream is the state of one decision while the evaluator feeds an Effector.
+* @breif Once final is set, result is the decision and the rest of the rules need not be evaluated.
+*/
+class EffectStream {
+public:
+    std::string expr;
+    EffectKind kind = EffectKind::Custom;
+    bool final = false;
+    bool result = false;
+
+    // Count of rows of the section, words fed so far, and the row of the rule that made the decision final,
+    // SIZE_MAX if unknown.
+    size_t row_count = 0;
+    size_t fed = 0;
+    size_t row = SIZE_MAX;
+
+    // The words fed so far, only kept by the default Feed for MergeMask.
+    std::vector<uint64_t> matched;
+    std::vector<uint64_t> live;
+};
+
 /**
 * @breif Effector is the abstract class for Caep effectors.
 */
@@ -23,6 +46,84 @@ public:
     * @return the final effect.
     */
     virtual bool MergeEffects(std::string expr, std::vector<Effect> effects, std::vector<float> results) = 0;
+
+    /**
+    * @breif MergeMask merges the rules that matched a request, given as masks with bit r % 64 of word r / 64 for row r.
+    * @breif By default the masks are expanded into effects for MergeEffects, override it to read the bits directly.
+    *
+    * @param expr the expression of [policy_effect].
+    * @param kind expr resolved by ParseEffectKind when the model was loaded.
+    * @param matched the rows of the rules that matched.
+    * @param live the rows that hold rules, the others are tombstones of removed rules.
+    * @param row_count the count of rows.
+    * @return the final effect.
+    */
+    virtual bool MergeMask(const std::string& expr, EffectKind /* kind */, const std::vector<uint64_t>& matched, const std::vector<uint64_t>& live, size_t row_count) {
+        std::vector<Effect> effects(row_count, Effect::Deny);
+        for(size_t row = 0; row < row_count; ++row) {
+            if(!(live[row >> 6] >> (row & 63) & 1))
+                effects[row] = Effect::Indeterminate;
+            else if(matched[row >> 6] >> (row & 63) & 1)
+                effects[row] = Effect::Allow;
+        }
+        return MergeEffects(expr, effects, std::vector<float>(row_count, 0.0f));
+    }
+
+    /**
+    * @breif Begin starts a decision, the evaluator then calls Feed with the rows of the rules in order and End at last.
+    *
+    * @param expr the expression of [policy_effect].
+    * @param kind expr resolved by ParseEffectKind when the model was loaded.
+    * @param row_count the count of rows of the section, the last word fed may hold fewer.
+    * @param stream the state of the decision, owned by the evaluator.
+    */
+    virtual void Begin(const std::string& expr, EffectKind kind, size_t row_count, EffectStream& stream) {
+        stream.expr = expr;
+        stream.kind = kind;
+        stream.row_count = row_count;
+        stream.final = false;
+        stream.result = false;
+        stream.fed = 0;
+        stream.row = SIZE_MAX;
+        stream.matched.clear();
+        stream.live.clear();
+    }
+
+    /**
+    * @breif Feed takes the next 64 rows, bit r % 64 of the words for row r as MergeMask.
+    * @breif By default the words are kept for MergeMask, override it to decide early.
+    *
+    * @return true if the decision is final, the evaluator stops feeding then.
+    */
+    virtual bool Feed(EffectStream& stream, uint64_t matched, uint64_t live) {
+        stream.matched.push_back(matched);
+        stream.live.push_back(live);
+        ++stream.fed;
+        return stream.final;
+    }
+
+    /**
+    * @breif Skip passes over the words from begin_word to end_word, none of their rows matched. The evaluator calls it
+    * @breif instead of Feed for the words without candidate rules of the index. By default the words are fed, override
+    * @breif it if rows that did not match can be passed over faster.
+    *
+    * @param live the live mask of all rows, only the words from begin_word to end_word are read.
+    * @return true if the decision is final, the evaluator stops feeding then.
+    */
+    virtual bool Skip(EffectStream& stream, const std::vector<uint64_t>& live, size_t begin_word, size_t end_word) {
+        for(size_t i = begin_word; i < end_word && !stream.final; ++i)
+            Feed(stream, 0, live[i]);
+        return stream.final;
+    }
+
+    /**
+    * @breif End returns the decision once every row was fed or the decision is final.
+    */
+    virtual bool End(EffectStream& stream) {
+        if(stream.final)
+            return stream.result;
+        return MergeMask(stream.expr, stream.kind, stream.matched, stream.live, stream.row_count);
+    }
 };
 
 } // namespace caep 
@@ -0,0 +1,87 @@
+#ifndef CAEP_IP_ADDR_H
+#define CAEP_IP_ADDR_H
+
+#include <cstdint>
+
+namespace caep {
+
+enum class IPFamily : uint8_t { None, IPv4, IPv6 };
+
+// IPAddr is an IP address as a fixed-size value, unlike IP it never allocates. An IPv4 address
+// is stored in the IPv4-mapped IPv6 space, 192.168.2.1 is ::ffff:192.168.2.1, and family tells
+// which one was parsed. Bit counts of masks are always out of 128, an IPv4 /24 is 120.
+class IPAddr {
+public:
+    static constexpr int IPv6bits = 128;
+    static constexpr int IPv4bits = 32;
+
+    uint8_t bytes[16];
+    IPFamily family;
+
+    constexpr IPAddr() : bytes{}, family(IPFamily::None) {}
+
+    static constexpr IPAddr From4(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+        IPAddr addr;
+        addr.bytes[10] = addr.bytes[11] = 0xFF;
+        addr.bytes[12] = a;
+        addr.bytes[13] = b;
+        addr.bytes[14] = c;
+        addr.bytes[15] = d;
+        addr.family = IPFamily::IPv4;
+        return addr;
+    }
+
+    constexpr bool IsValid() const {
+        return family != IPFamily::None;
+    }
+
+    constexpr bool Is4() const {
+        return family == IPFamily::IPv4;
+    }
+
+    // Bit returns a bit of the address, bit 0 is the highest bit of the first byte.
+    constexpr int Bit(int index) const {
+        return bytes[index >> 3] >> (7 - (index & 7)) & 1;
+    }
+
+    // Mask returns the address with every bit after the first bits cleared.
+    constexpr IPAddr Mask(int bits) const {
+        IPAddr out = *this;
+        for(int i = 0; i < 16; ++i) {
+            int ones = bits - 8 * i;
+            if(ones <= 0)
+                out.bytes[i] = 0;
+            else if(ones < 8)
+                out.bytes[i] &= uint8_t(0xFF << (8 - ones));
+        }
+        return out;
+    }
+
+    // PrefixEqual determines whether the first bits of both addresses are equal, that is, whether
+    // the network of the first bits of current address contains other.
+    constexpr bool PrefixEqual(const IPAddr& other, int bits) const {
+        int i = 0;
+        for(; 8 * (i + 1) <= bits; ++i) {
+            if(bytes[i] != other.bytes[i])
+                return false;
+        }
+        int rest = bits - 8 * i;
+        if(rest <= 0)
+            return true;
+        uint8_t mask = uint8_t(0xFF << (8 - rest));
+        return (bytes[i] & mask) == (other.bytes[i] & mask);
+    }
+
+    // As IP::Equal, 192.168.2.1 equals ::ffff:192.168.2.1 although their families differ.
+    constexpr bool operator==(const IPAddr& other) const {
+        return PrefixEqual(other, IPv6bits);
+    }
+
+    constexpr bool operator!=(const IPAddr& other) const {
+        return !(*this == other);
+    }
+};
+
+} // namespace caep
+
+#endif
@@ -6,31 +6,13 @@
 namespace caep {
 
 std::string IPNet :: NETIP_toString() {
-    std::string ip1, ip2, ip3, ip4;
-    std::stringstream ss1, ss2, ss3, ss4;
-    ss1 << net_ip.ip[0];
-    ss1 >> ip1;
-    ss2 << net_ip.ip[1];
-    ss2 >> ip2;
-    ss3 << net_ip.ip[2];
-    ss3 >> ip3;
-    ss4 << net_ip.ip[3];
-    ss4 >> ip4;
-    return ip1 + "." + ip2 + "." + ip3 + "." + ip4;
+    return std::to_string(net_ip.ip[0]) + "." + std::to_string(net_ip.ip[1]) + "." +
+           std::to_string(net_ip.ip[2]) + "." + std::to_string(net_ip.ip[3]);
 }
 
 std::string IPNet :: IPMask_toString() {
-    std::string mask1, mask2, mask3, mask4;
-    std::stringstream ss1, ss2, ss3, ss4;
-    ss1 << mask[0];
-    ss1 >> mask1;
-    ss2 << mask[1];
-    ss2 >>mask2;
-    ss3 << mask[2];
-    ss3 >>mask3;
-    ss4 << mask[3];
-    ss4 >>mask4;
-    return mask1 + "." + mask2 + "." + mask3 + "." + mask4;
+    return std::to_string(mask[0]) + "." + std::to_string(mask[1]) + "." +
+           std::to_string(mask[2]) + "." + std::to_string(mask[3]);
 }
 
 // Contains reports whether the network includes ip.
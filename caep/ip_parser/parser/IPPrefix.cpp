@@ -0,0 +1,39 @@
+#ifndef CAEP_IP_PREFIX_CPP
+#define CAEP_IP_PREFIX_CPP
+
+#include "./IPPrefix.h"
+#include "./parseIPAddr.h"
+
+namespace caep {
+
+bool IPPrefix::Parse(std::string_view s, IPPrefix& prefix) {
+    if(s.find_first_of(".:") == std::string_view::npos)
+        return false;
+
+    if(s.find('/') != std::string_view::npos) {
+        IPAddr addr;
+        int bits;
+        if(!parseCIDRAddr(s, addr, bits))
+            return false;
+        prefix.addr = addr.Mask(bits);
+        prefix.bits = bits;
+        return true;
+    }
+
+    if(!parseIPAddr(s, prefix.addr))
+        return false;
+    prefix.bits = IPAddr::IPv6bits;
+    return true;
+}
+
+int IPPrefix::Bit(int index) const {
+    return addr.Bit(index);
+}
+
+bool IPPrefix::Contains(const IPPrefix& other) const {
+    return other.bits >= bits && addr.PrefixEqual(other.addr, bits);
+}
+
+} // namespace caep
+
+#endif
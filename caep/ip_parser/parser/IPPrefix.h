@@ -0,0 +1,32 @@
+#ifndef CAEP_IP_PREFIX_H
+#define CAEP_IP_PREFIX_H
+
+#include <string_view>
+
+#include "./IPAddr.h"
+
+namespace caep {
+
+// IPPrefix is an IP address or a CIDR as a fixed-size 128-bit value. IPv4 is stored in the
+// IPv4-mapped IPv6 space, "192.168.2.0/24" is ::ffff:192.168.2.0/120, so that IPv4 and IPv6
+// prefixes can be compared. A single address has 128 bits.
+class IPPrefix {
+public:
+    IPAddr addr;
+    int bits;
+
+    // Parse parses an IP address, such as "192.168.2.1", or a CIDR, such as "192.168.2.0/24",
+    // with the host bits cleared. Strings without "." or ":" are rejected before parsing, as most
+    // policy values are not addresses. It returns false if s is neither.
+    static bool Parse(std::string_view s, IPPrefix& prefix);
+
+    // Bit returns a bit of the address, bit 0 is the highest bit of the first byte.
+    int Bit(int index) const;
+
+    // Contains determines whether other, a prefix or an address, lies within current prefix.
+    bool Contains(const IPPrefix& other) const;
+};
+
+} // namespace caep
+
+#endif
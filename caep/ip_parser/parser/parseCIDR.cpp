@@ -6,27 +6,18 @@
 namespace caep {
 
 CIDR parseCIDR(std::string s) {
-    size_t pos = s.find("/");
-    if(pos == std::string :: npos) {
+    IPAddr addr;
+    int bits;
+    if(!parseCIDRAddr(s, addr, bits)) {
         throw ParserException("Illegal CIDR address.");
     }
-    std::string addr = s.substr(0, pos);
-    std::string mask = s.substr(pos+1, s.length()-pos-1);
-    byte iplen = IP :: IPv4len;
-    IP ip;
-    ip = parseIPv4(addr);
-    if(ip.isLegal == false) {
-        iplen = IP :: IPv6len;
-        ip = parseIPv6(addr);
-    }
-    std::pair<int, int> p = dtoi(mask);
-    if(ip.isLegal == false || (p.first >= big || p.second==0) ||  p.second != mask.length() || p.first < 0 || p.first > 8*iplen) {
-        throw ParserException("Illegal CIDR address.");
-    }
-    IPMask m = CIDRMask(p.first, 8*iplen);
+    // An IPv4 CIDR keeps a 4-byte mask and network, as IP :: Mask gives for it.
+    byte iplen = addr.Is4() ? IP :: IPv4len : IP :: IPv6len;
+    IPMask m = CIDRMask(bits - 8*(IP :: IPv6len - iplen), 8*iplen);
+    IPAddr net = addr.Mask(bits);
     CIDR cidr_addr;
-    cidr_addr.ip = ip;
-    cidr_addr.net.net_ip = ip.Mask(m);
+    cidr_addr.ip.ip.assign(addr.bytes, addr.bytes + IP :: IPv6len);
+    cidr_addr.net.net_ip.ip.assign(net.bytes + IP :: IPv6len - iplen, net.bytes + IP :: IPv6len);
     cidr_addr.net.mask = m;
 
     return cidr_addr;
@@ -9,6 +9,7 @@
 #include "./parseIPv4.h"
 #include "./parseIPv6.h"
 #include "./CIDRMask.h"
+#include "./parseIPAddr.h"
 #include "../exception/parser_exception.h"
 
 namespace caep {
@@ -6,16 +6,13 @@
 namespace caep {
 
 IP parseIP(std::string s) {
-    for(int i = 0 ; i < s.length() ; i++) {
-        switch(s[i]) {
-        case '.':
-            return parseIPv4(s);
-        case ':':
-            return parseIPv6(s);
-        }
-    }
+    IPAddr addr;
     IP p;
-    p.isLegal = false;
+    if(!parseIPAddr(s, addr)) {
+        p.isLegal = false;
+        return p;
+    }
+    p.ip.assign(addr.bytes, addr.bytes + IP :: IPv6len);
     return p;
 }
 
@@ -4,6 +4,7 @@
 #include <string>
 
 #include "./IP.h"
+#include "./parseIPAddr.h"
 #include "./parseIPv4.h"
 #include "./parseIPv6.h"
 
@@ -0,0 +1,193 @@
+#ifndef CAEP_PARSE_IP_ADDR_CPP
+#define CAEP_PARSE_IP_ADDR_CPP
+
+#include "./parseIPAddr.h"
+
+namespace caep {
+
+namespace {
+
+int hexValue(char c) {
+    if('0' <= c && c <= '9')
+        return c - '0';
+    if('a' <= c && c <= 'f')
+        return c - 'a' + 10;
+    if('A' <= c && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Decimal number of at most max, as dtoi. Returns characters consumed, 0 if there is no number
+// or it is greater than max.
+size_t parseDecimal(std::string_view s, int max, int& n) {
+    size_t i = 0;
+    n = 0;
+    for(; i < s.length() && '0' <= s[i] && s[i] <= '9'; ++i) {
+        n = n * 10 + (s[i] - '0');
+        if(n > max)
+            return 0;
+    }
+    return i;
+}
+
+// Hexadecimal number of at most 0xFFFF, as xtoi.
+size_t parseHex(std::string_view s, int& n) {
+    size_t i = 0;
+    n = 0;
+    for(int d; i < s.length() && (d = hexValue(s[i])) >= 0; ++i) {
+        n = n * 16 + d;
+        if(n > 0xFFFF)
+            return 0;
+    }
+    return i;
+}
+
+} // namespace
+
+bool parseIPv4Addr(std::string_view s, IPAddr& addr) {
+    uint8_t pb[4];
+    for(int i = 0; i < 4; i++) {
+        if(i > 0) {
+            if(s.empty() || s[0] != '.')
+                return false;
+            s.remove_prefix(1);
+        }
+        int n;
+        size_t len = parseDecimal(s, 0xFF, n);
+        if(len == 0)
+            return false;
+        s.remove_prefix(len);
+        pb[i] = uint8_t(n);
+    }
+    if(!s.empty())
+        return false;
+    addr = IPAddr::From4(pb[0], pb[1], pb[2], pb[3]);
+    return true;
+}
+
+bool parseIPv6Addr(std::string_view s, IPAddr& addr) {
+    IPAddr ip;
+    int ellipsis = -1; // position of ellipsis in ip
+
+    // Might have leading ellipsis
+    if(s.length() >= 2 && s[0] == ':' && s[1] == ':') {
+        ellipsis = 0;
+        s.remove_prefix(2);
+        // Might be only ellipsis
+        if(s.empty()) {
+            ip.family = IPFamily::IPv6;
+            addr = ip;
+            return true;
+        }
+    }
+
+    // Loop, parsing hex numbers followed by colon.
+    int i = 0;
+    while(i < 16) {
+        int n;
+        size_t len = parseHex(s, n);
+        if(len == 0)
+            return false;
+
+        // If followed by dot, might be in trailing IPv4.
+        if(len < s.length() && s[len] == '.') {
+            if(ellipsis < 0 && i != 16 - 4)
+                return false;
+            // Not enough room.
+            if(i + 4 > 16)
+                return false;
+            IPAddr ip4;
+            if(!parseIPv4Addr(s, ip4))
+                return false;
+            for(int j = 0; j < 4; ++j)
+                ip.bytes[i + j] = ip4.bytes[12 + j];
+            s = std::string_view();
+            i += 4;
+            break;
+        }
+
+        // Save this 16-bit chunk.
+        ip.bytes[i] = uint8_t(n >> 8);
+        ip.bytes[i + 1] = uint8_t(n);
+        i += 2;
+
+        // Stop at end of string.
+        s.remove_prefix(len);
+        if(s.empty())
+            break;
+
+        // Otherwise must be followed by colon and more.
+        if(s[0] != ':' || s.length() == 1)
+            return false;
+        s.remove_prefix(1);
+
+        // Look for ellipsis.
+        if(s[0] == ':') {
+            if(ellipsis >= 0) // already have one
+                return false;
+            ellipsis = i;
+            s.remove_prefix(1);
+            if(s.empty()) // can be at end
+                break;
+        }
+    }
+
+    // Must have used entire string.
+    if(!s.empty())
+        return false;
+
+    // If didn't parse enough, expand ellipsis.
+    if(i < 16) {
+        if(ellipsis < 0)
+            return false;
+        int n = 16 - i;
+        for(int j = i - 1; j >= ellipsis; j--)
+            ip.bytes[j + n] = ip.bytes[j];
+        for(int j = ellipsis + n - 1; j >= ellipsis; j--)
+            ip.bytes[j] = 0;
+    }
+    else if(ellipsis >= 0) {
+        // Ellipsis must represent at least one 0 group.
+        return false;
+    }
+    ip.family = IPFamily::IPv6;
+    addr = ip;
+    return true;
+}
+
+bool parseIPAddr(std::string_view s, IPAddr& addr) {
+    for(char c : s) {
+        switch(c) {
+        case '.':
+            return parseIPv4Addr(s, addr);
+        case ':':
+            return parseIPv6Addr(s, addr);
+        }
+    }
+    return false;
+}
+
+bool parseCIDRAddr(std::string_view s, IPAddr& addr, int& bits) {
+    size_t pos = s.find('/');
+    if(pos == std::string_view::npos)
+        return false;
+    std::string_view ip = s.substr(0, pos);
+    std::string_view mask = s.substr(pos + 1);
+
+    int max = IPAddr::IPv4bits;
+    if(!parseIPv4Addr(ip, addr)) {
+        max = IPAddr::IPv6bits;
+        if(!parseIPv6Addr(ip, addr))
+            return false;
+    }
+    int n;
+    size_t len = parseDecimal(mask, max, n);
+    if(len == 0 || len != mask.length())
+        return false;
+    bits = n + IPAddr::IPv6bits - max;
+    return true;
+}
+
+} // namespace caep
+
+#endif
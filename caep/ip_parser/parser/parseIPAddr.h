@@ -0,0 +1,28 @@
+#ifndef CAEP_PARSE_IP_ADDR_H
+#define CAEP_PARSE_IP_ADDR_H
+
+#include <string_view>
+
+#include "./IPAddr.h"
+
+namespace caep {
+
+// These parsers accept the same strings as parseIPv4, parseIPv6, parseIP and parseCIDR, but work
+// in place over s and never touch the heap. They return false instead of an illegal IP.
+
+// parseIPv4Addr parses a dotted IPv4 address, such as "192.168.2.1".
+bool parseIPv4Addr(std::string_view s, IPAddr& addr);
+
+// parseIPv6Addr parses an IPv6 address, such as "2001:db8::1" or "::ffff:192.168.2.1".
+bool parseIPv6Addr(std::string_view s, IPAddr& addr);
+
+// parseIPAddr parses an IPv4 or an IPv6 address, told apart by the first "." or ":".
+bool parseIPAddr(std::string_view s, IPAddr& addr);
+
+// parseCIDRAddr parses a CIDR, such as "192.168.2.0/24". addr keeps its host bits, bits is out
+// of 128, so "192.168.2.0/24" gives 120, use addr.Mask(bits) for the network.
+bool parseCIDRAddr(std::string_view s, IPAddr& addr, int& bits);
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,111 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : rw_lock.h                                                    *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   RWLock::RWLock -- Constructor for RWLock.                                                 *
+ *   RWLock::~RWLock -- Destructor for RWLock.                                                 *
+ *   RWLock::ReadLock -- Locks current lock in shared mode.                                    *
+ *   RWLock::WriteLock -- Locks current lock in exclusive mode.                                *
+ *   RWLock::Unlock -- Unlocks current lock.                                                   *
+ *                                                                                             *
+ *   ReadLockGuard::ReadLockGuard -- Constructor for ReadLockGuard.                            *
+ *   ReadLockGuard::~ReadLockGuard -- Destructor for ReadLockGuard.                            *
+ *   WriteLockGuard::WriteLockGuard -- Constructor for WriteLockGuard.                         *
+ *   WriteLockGuard::~WriteLockGuard -- Destructor for WriteLockGuard.                         *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef CAEP_RW_LOCK_H
+#define CAEP_RW_LOCK_H
+
+#include <pthread.h>
+
+#include "./noncopyable.h"
+
+namespace caep {
+
+/*
+ * @breif Encapsulates the read-write lock, you can use it directly instead of pthread_rwlock_t.
+ * Any number of readers may hold it at the same time, a writer holds it alone. On glibc waiting
+ * writers are preferred, so that a steady stream of readers can not starve policy updates.
+ */
+class RWLock : noncopyable {
+private:
+    pthread_rwlock_t rwlock;
+
+public:
+    RWLock() {
+        pthread_rwlockattr_t attr;
+        pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+        pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        pthread_rwlock_init(&rwlock, &attr);
+        pthread_rwlockattr_destroy(&attr);
+    }
+
+    ~RWLock() {
+        pthread_rwlock_destroy(&rwlock);
+    }
+
+    void read_lock() {
+        pthread_rwlock_rdlock(&rwlock);
+    }
+
+    void write_lock() {
+        pthread_rwlock_wrlock(&rwlock);
+    }
+
+    void unlock() {
+        pthread_rwlock_unlock(&rwlock);
+    }
+};
+
+/*
+ * @brief Class ReadLockGuard holds RWLock in shared mode in RAII.
+ */
+class ReadLockGuard : noncopyable {
+private:
+    RWLock& rwlock;
+
+public:
+    explicit ReadLockGuard(RWLock& rwlock) : rwlock(rwlock) {
+        this->rwlock.read_lock();
+    }
+
+    ~ReadLockGuard() {
+        this->rwlock.unlock();
+    }
+};
+
+/*
+ * @brief Class WriteLockGuard holds RWLock in exclusive mode in RAII.
+ */
+class WriteLockGuard : noncopyable {
+private:
+    RWLock& rwlock;
+
+public:
+    explicit WriteLockGuard(RWLock& rwlock) : rwlock(rwlock) {
+        this->rwlock.write_lock();
+    }
+
+    ~WriteLockGuard() {
+        this->rwlock.unlock();
+    }
+};
+
+}
+#endif
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <exception>
+
+#include "./thread_pool.h"
+
+namespace caep {
+
+ThreadPool::ThreadPool(int thread_count, const std::string& name) :
+    mutex(), not_empty(mutex), pending(0), next_queue(0), running(true) {
+    for(int i = 0; i < thread_count; ++i)
+        queues.emplace_back(new WorkQueue());
+    for(int i = 0; i < thread_count; ++i) {
+        size_t queue_index = i;
+        threads.emplace_back(new Thread([this, queue_index]() { RunInThread(queue_index); }, name + std::to_string(i)));
+    }
+    for(auto& thread : threads)
+        thread->Start();
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        MutexLockGuard lock(mutex);
+        running = false;
+        not_empty.NotifyAll();
+    }
+    for(auto& thread : threads)
+        thread->Join();
+}
+
+void ThreadPool::Push(Task task) {
+    size_t queue_index;
+    {
+        MutexLockGuard lock(mutex);
+        queue_index = next_queue++ % queues.size();
+    }
+    {
+        WorkQueue& queue = *queues[queue_index];
+        MutexLockGuard lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    MutexLockGuard lock(mutex);
+    ++pending;
+    not_empty.Notify();
+}
+
+// A queue_index out of range owns no queue and only steals, the thread in ParallelFor does so.
+bool ThreadPool::Pop(size_t queue_index, Task& task) {
+    bool found = false;
+    if(queue_index < queues.size()) {
+        WorkQueue& queue = *queues[queue_index];
+        MutexLockGuard lock(queue.mutex);
+        if(!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    for(size_t i = 1; !found && i <= queues.size(); ++i) {
+        WorkQueue& queue = *queues[(queue_index + i) % queues.size()];
+        MutexLockGuard lock(queue.mutex);
+        if(!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if(found) {
+        MutexLockGuard lock(mutex);
+        --pending;
+    }
+    return found;
+}
+
+void ThreadPool::RunInThread(size_t queue_index) {
+    Task task;
+    while(true) {
+        if(Pop(queue_index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        MutexLockGuard lock(mutex);
+        while(running && pending <= 0)
+            not_empty.Wait();
+        if(!running && pending <= 0)
+            return;
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, const RangeFunc& func) {
+    if(count == 0)
+        return;
+    if(queues.empty()) {
+        func(0, count);
+        return;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    CountDownLatch latch(static_cast<int>((count + grain - 1) / grain));
+    MutexLock error_mutex;
+    std::exception_ptr error;
+    for(size_t begin = 0; begin < count; begin += grain) {
+        size_t end = std::min(count, begin + grain);
+        Push([&, begin, end]() {
+            try {
+                func(begin, end);
+            }
+            catch(...) {
+                MutexLockGuard lock(error_mutex);
+                if(!error)
+                    error = std::current_exception();
+            }
+            latch.CountDown();
+        });
+    }
+
+    // The waiting thread runs queued tasks too, then waits for the ones still running elsewhere.
+    Task task;
+    while(Pop(queues.size(), task)) {
+        task();
+        task = nullptr;
+    }
+    latch.Wait();
+
+    if(error)
+        std::rethrow_exception(error);
+}
+
+} // namespace caep
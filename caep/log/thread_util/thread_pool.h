@@ -0,0 +1,94 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : thread_pool.h                                                *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   ThreadPool::ThreadPool -- Constructor for ThreadPool, starts the worker threads.          *
+ *   ThreadPool::~ThreadPool -- Destructor for ThreadPool, stops and joins the worker threads. *
+ *   ThreadPool::ThreadCount -- Returns the count of worker threads.                           *
+ *   ThreadPool::ParallelFor -- Runs a function over a range of indices on all workers.        *
+ *   ThreadPool::Push -- Queues a task on a worker and wakes an idle worker up.                *
+ *   ThreadPool::Pop -- Takes a task from a worker's own queue or steals one from another.     *
+ *   ThreadPool::RunInThread -- Loop of a worker thread.                                       *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef CAEP_THREAD_POOL_H
+#define CAEP_THREAD_POOL_H
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "./thread.h"
+#include "./mutex_lock.h"
+#include "./condition.h"
+#include "./noncopyable.h"
+
+namespace caep {
+
+/*
+ * @breif Class ThreadPool runs tasks on a fixed count of worker threads. Every worker owns a task
+ * queue, it takes tasks from the back of its own queue and steals from the front of the others
+ * once its own queue runs dry, so that a worker that got cheap tasks helps the ones that got
+ * expensive tasks. A thread that waits in ParallelFor runs queued tasks as well, so ParallelFor
+ * may be called from inside a task without exhausting the workers.
+ */
+class ThreadPool : noncopyable {
+public:
+    typedef std::function<void()> Task;
+
+    /*
+     * @brief Function run by ParallelFor over the indices [begin, end).
+     */
+    typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+private:
+    class WorkQueue {
+    public:
+        MutexLock mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::unique_ptr<Thread>> threads;
+
+    MutexLock mutex;
+    Condition not_empty;
+    long pending;
+    size_t next_queue;
+    bool running;
+
+    void Push(Task task);
+    bool Pop(size_t queue_index, Task& task);
+    void RunInThread(size_t queue_index);
+
+public:
+    explicit ThreadPool(int thread_count, const std::string& name = std::string("ThreadPool"));
+    ~ThreadPool();
+
+    int ThreadCount() const {
+        return static_cast<int>(threads.size());
+    }
+
+    /*
+     * @brief Splits [0, count) into ranges of at most grain indices and runs func on every range,
+     * returns once all of them have finished. The first exception thrown by func is rethrown.
+     */
+    void ParallelFor(size_t count, size_t grain, const RangeFunc& func);
+};
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,199 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : cidr_trie.cpp                                                *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   CIDRTrie::NewNode -- Appends a node without children.                                     *
+ *   CIDRTrie::Clear -- Drops all prefixes of current CIDRTrie.                                *
+ *   CIDRTrie::Insert -- Adds the row of a PRM policy rule under a prefix.                     *
+ *   CIDRTrie::Lookup -- Returns the rows of all prefixes that contain an address.             *
+ *   CIDRTrie::Empty -- Determines whether current CIDRTrie holds no prefix.                   *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_CIDR_TRIE_CPP
+#define CAEP_CIDR_TRIE_CPP
+
+#include <algorithm>
+
+#include "./cidr_trie.h"
+
+namespace caep {
+
+/***********************************************************************************************
+ ***                                CIDRTrie::NewNode                                        ***
+ ***********************************************************************************************
+ * DESCRIPTION: Appends a node without children and rows to current CIDRTrie.                  *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   prefix -- Prefix of the node.                                                      *
+ *                                                                                             *
+ * OUTPUT:   Returns the index of the node.                                                    *
+ *                                                                                             *
+ * WARNINGS:    Invalidates references to the nodes, keep indices instead.                     *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+int32_t CIDRTrie::NewNode(const IPPrefix& prefix) {
+    Node node;
+    node.prefix = prefix;
+    node.child[0] = node.child[1] = -1;
+    m_nodes.push_back(node);
+    return int32_t(m_nodes.size() - 1);
+}
+
+/***********************************************************************************************
+ ***                                CIDRTrie::Clear                                          ***
+ ***********************************************************************************************
+ * DESCRIPTION: Drops all prefixes of current CIDRTrie.                                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void CIDRTrie::Clear() {
+    m_nodes.clear();
+}
+
+/***********************************************************************************************
+ ***                                CIDRTrie::Insert                                         ***
+ ***********************************************************************************************
+ * DESCRIPTION: Adds the row of a PRM policy rule under a prefix. The trie is walked down      *
+ *              while the nodes contain the prefix, a node whose prefix only shares some bits  *
+ *              with it is split by a new node holding the common bits.                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   prefix -- Prefix of the rule value.                                                *
+ *                                                                                             *
+ *          row -- Row of the rule.                                                            *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Costs O(128) at most. Rows of a node are kept in insertion order.              *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void CIDRTrie::Insert(const IPPrefix& prefix, size_t row) {
+    if(m_nodes.empty()) {
+        IPPrefix root;
+        root.bits = 0;
+        NewNode(root);
+    }
+
+    int32_t n = 0;
+    for(;;) {
+        if(m_nodes[n].prefix.bits == prefix.bits) {
+            m_nodes[n].rows.push_back(row);
+            return;
+        }
+
+        int b = prefix.Bit(m_nodes[n].prefix.bits);
+        int32_t c = m_nodes[n].child[b];
+        if(c < 0) {
+            int32_t leaf = NewNode(prefix);
+            m_nodes[leaf].rows.push_back(row);
+            m_nodes[n].child[b] = leaf;
+            return;
+        }
+
+        const IPPrefix& child = m_nodes[c].prefix;
+        int limit = std::min(child.bits, prefix.bits);
+        int common = m_nodes[n].prefix.bits;
+        while(common < limit && child.Bit(common) == prefix.Bit(common))
+            ++common;
+
+        if(common == child.bits) {
+            n = c;
+            continue;
+        }
+
+        // The child and the prefix part at bit common, a node of the common bits takes the child's place.
+        IPPrefix split;
+        split.addr = prefix.addr.Mask(common);
+        split.bits = common;
+        int child_bit = child.Bit(common);
+        int32_t middle = NewNode(split);
+        m_nodes[middle].child[child_bit] = c;
+        m_nodes[n].child[b] = middle;
+        if(common == prefix.bits) {
+            m_nodes[middle].rows.push_back(row);
+            return;
+        }
+        int32_t leaf = NewNode(prefix);
+        m_nodes[leaf].rows.push_back(row);
+        m_nodes[middle].child[1 - child_bit] = leaf;
+        return;
+    }
+}
+
+/***********************************************************************************************
+ ***                                CIDRTrie::Lookup                                         ***
+ ***********************************************************************************************
+ * DESCRIPTION: Appends the rows of all prefixes that contain an address, in a single walk     *
+ *              from the root.                                                                 *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   addr -- The address, a 128-bit IPPrefix.                                           *
+ *                                                                                             *
+ *          rows -- Receives the rows, they are not sorted.                                    *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Costs O(128) plus the count of rows found.                                     *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void CIDRTrie::Lookup(const IPPrefix& addr, std::vector<size_t>& rows) const {
+    int32_t n = m_nodes.empty() ? -1 : 0;
+    while(n >= 0) {
+        const Node& node = m_nodes[n];
+        if(!node.prefix.Contains(addr))
+            return;
+        rows.insert(rows.end(), node.rows.begin(), node.rows.end());
+        if(node.prefix.bits >= addr.bits)
+            return;
+        n = node.child[addr.Bit(node.prefix.bits)];
+    }
+}
+
+/***********************************************************************************************
+ ***                                CIDRTrie::Empty                                          ***
+ ***********************************************************************************************
+ * DESCRIPTION: Determines whether current CIDRTrie holds no prefix.                           *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   Returns true if no row was inserted.                                              *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool CIDRTrie::Empty() const {
+    return m_nodes.empty();
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,78 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : cidr_trie.h                                                  *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   CIDRTrie::Clear -- Drops all prefixes of current CIDRTrie.                                *
+ *   CIDRTrie::Insert -- Adds the row of a PRM policy rule under a prefix.                     *
+ *   CIDRTrie::Lookup -- Returns the rows of all prefixes that contain an address.             *
+ *   CIDRTrie::Empty -- Determines whether current CIDRTrie holds no prefix.                   *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_CIDR_TRIE_H
+#define CAEP_CIDR_TRIE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../ip_parser/parser/IPPrefix.h"
+
+namespace caep {
+
+/*------------------------------------------------------------------------------------------------
+ * @brief CIDRTrie is a path-compressed binary trie of IPPrefix, every node holds the rows of the
+ * PRM policy rules whose value is its prefix. One walk from the root to an address visits all of
+ * the prefixes that contain it, longest last.
+ *
+ *                  eg: # policy.csv
+ *                  a, 10.0.0.0/8, read
+ *                  a, 10.1.0.0/16, read
+ *                  a, 192.168.0.0/16, read
+ *
+ *  in this case:
+ *
+ *                  ::/0
+ *                 /    \
+ *      10.0.0.0/8 {0}   192.168.0.0/16 {2}
+ *           |
+ *      10.1.0.0/16 {1}
+ *
+ *  Lookup(10.1.2.3) -- {0, 1}
+ */
+class CIDRTrie {
+private:
+    class Node {
+    public:
+        IPPrefix prefix;
+        int32_t child[2];
+        std::vector<size_t> rows;
+    };
+
+    std::vector<Node> m_nodes;
+
+    int32_t NewNode(const IPPrefix& prefix);
+
+public:
+    void Clear();
+
+    void Insert(const IPPrefix& prefix, size_t row);
+
+    void Lookup(const IPPrefix& addr, std::vector<size_t>& rows) const;
+
+    bool Empty() const;
+};
+
+} // namespace caep
+
+#endif
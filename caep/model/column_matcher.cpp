@@ -0,0 +1,211 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : column_matcher.cpp                                           *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * ColumnMatcher::MaskWords -- Returns the count of words of a mask of some rows.              *
+ * ColumnMatcher::CountRows -- Returns the count of rows set in a mask.                        *
+ * ColumnMatcher::FirstRow -- Returns the lowest row set in a mask.                            *
+ * ColumnMatcher::MatchEqual -- Marks the rows of a column that hold a symbol.                 *
+ * ColumnMatcher::DefaultMatch -- Marks the rows whose field DefaultMatcher matches.           *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_COLUMN_MATCHER_CPP
+#define CAEP_COLUMN_MATCHER_CPP
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+
+#include "./column_matcher.h"
+
+namespace caep {
+
+/***********************************************************************************************
+ ***                                ColumnMatcher::MaskWords                                 ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the count of 64-bit words of a mask with a bit for each of some rows.  *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   row_count -- Count of rows, usually Section::RowCount.                             *
+ *                                                                                             *
+ * OUTPUT:   The count of words.                                                               *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t ColumnMatcher::MaskWords(size_t row_count) {
+    return (row_count + 63) / 64;
+}
+
+/***********************************************************************************************
+ ***                                ColumnMatcher::CountRows                                 ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the count of rows set in a mask, a word at a time.                     *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   mask -- The mask.                                                                  *
+ *                                                                                             *
+ * OUTPUT:   The count of set bits.                                                            *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t ColumnMatcher::CountRows(const std::vector<uint64_t>& mask) {
+    size_t count = 0;
+    for(uint64_t word : mask)
+        count += size_t(__builtin_popcountll(word));
+    return count;
+}
+
+/***********************************************************************************************
+ ***                                ColumnMatcher::FirstRow                                  ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the lowest row set in a mask, the first nonzero word is found and its  *
+ *              lowest set bit is taken by a find-first-set instruction.                       *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   mask -- The mask.                                                                  *
+ *                                                                                             *
+ * OUTPUT:   The row, NO_ROW if no bit is set.                                                 *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t ColumnMatcher::FirstRow(const std::vector<uint64_t>& mask) {
+    for(size_t i = 0; i < mask.size(); ++i) {
+        if(mask[i] != 0)
+            return i * 64 + size_t(__builtin_ctzll(mask[i]));
+    }
+    return NO_ROW;
+}
+
+/***********************************************************************************************
+ ***                                ColumnMatcher::MatchEqual                                ***
+ ***********************************************************************************************
+ * DESCRIPTION: Sets the bit of every row of a column that holds a symbol. The column is       *
+ *              compared with AVX2 or SSE2 when the build targets them, the compare results    *
+ *              are packed into the mask with movemask, the rows after the last full block are *
+ *              compared one at a time.                                                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   column -- The symbols of a field, from Section::GetColumn.                         *
+ *                                                                                             *
+ *          row_count -- Count of symbols in column.                                           *
+ *                                                                                             *
+ *          id -- The symbol to be found.                                                      *
+ *                                                                                             *
+ *          mask -- At least MaskWords(row_count) words, bits are only set, never cleared.     *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    NO_SYMBOL pads the rules without the field, it is never looked for.            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void ColumnMatcher::MatchEqual(const symbol_t* column, size_t row_count, symbol_t id, uint64_t* mask) {
+    if(id == NO_SYMBOL)
+        return;
+
+    size_t row = 0;
+#if defined(__AVX2__)
+    __m256i key8 = _mm256_set1_epi32(int(id));
+    for(; row + 8 <= row_count; row += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + row));
+        uint64_t bits = uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(values, key8))));
+        mask[row >> 6] |= bits << (row & 63);
+    }
+#endif
+#if defined(__SSE2__)
+    __m128i key4 = _mm_set1_epi32(int(id));
+    for(; row + 4 <= row_count; row += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + row));
+        uint64_t bits = uint64_t(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(values, key4))));
+        mask[row >> 6] |= bits << (row & 63);
+    }
+#endif
+    for(; row < row_count; ++row) {
+        if(column[row] == id)
+            mask[row >> 6] |= uint64_t(1) << (row & 63);
+    }
+}
+
+/***********************************************************************************************
+ ***                                ColumnMatcher::DefaultMatch                              ***
+ ***********************************************************************************************
+ * DESCRIPTION: Marks the rows whose field DefaultMatcher matches a request value. Rows that   *
+ *              hold the symbol of the value are found by MatchEqual, the rows that hold a     *
+ *              wildcard match if the value starts with the part before its "*".               *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   section -- The Section that stores the PRM policy rules.                           *
+ *                                                                                             *
+ *          field_index -- Index of the field, eg: 1 for "res" of "a = sub, res, act".         *
+ *                                                                                             *
+ *          value -- The request value.                                                        *
+ *                                                                                             *
+ *          id -- Symbol of value, NO_SYMBOL if the SymbolTable does not know it.              *
+ *                                                                                             *
+ *          mask -- Receives the words from begin_word to end_word, bit r % 64 of word         *
+ *                  r / 64 - begin_word is set if row r matches.                               *
+ *                                                                                             *
+ *          begin_word -- First word of the rows to be matched, 0 for all rows.                *
+ *                                                                                             *
+ *          end_word -- Word after the rows to be matched, clamped to MaskWords(RowCount).     *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Tombstones are not skipped, their bits have to be cleared by the caller.       *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Matches a range of words of rows.                                     *
+ *=============================================================================================*/
+void ColumnMatcher::DefaultMatch(const Section& section, size_t field_index, std::string_view value, symbol_t id, std::vector<uint64_t>& mask, size_t begin_word, size_t end_word) {
+    size_t row_count = section.RowCount();
+    end_word = std::min(end_word, MaskWords(row_count));
+    begin_word = std::min(begin_word, end_word);
+    mask.assign(end_word - begin_word, 0);
+
+    const symbol_t* column = section.GetColumn(field_index);
+    if(column == nullptr)
+        return;
+    size_t begin_row = begin_word * 64;
+    size_t end_row = std::min(end_word * 64, row_count);
+    MatchEqual(column + begin_row, end_row - begin_row, id, mask.data());
+
+    auto wildcards = section.policy_index.Wildcards(int(field_index));
+    if(wildcards == nullptr)
+        return;
+    const SymbolTable& symbols = *section.symbols;
+    for(auto it = std::lower_bound(wildcards->begin(), wildcards->end(), begin_row); it != wildcards->end() && *it < end_row; ++it) {
+        size_t row = *it;
+        std::string_view prefix = symbols.PatternPrefix(column[row]);
+        if(value.compare(0, prefix.length(), prefix) == 0)
+            mask[(row >> 6) - begin_word] |= uint64_t(1) << (row & 63);
+    }
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,66 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : column_matcher.h                                             *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * ColumnMatcher::MaskWords -- Returns the count of words of a mask of some rows.              *
+ * ColumnMatcher::CountRows -- Returns the count of rows set in a mask.                        *
+ * ColumnMatcher::FirstRow -- Returns the lowest row set in a mask.                            *
+ * ColumnMatcher::MatchEqual -- Marks the rows of a column that hold a symbol.                 *
+ * ColumnMatcher::DefaultMatch -- Marks the rows whose field DefaultMatcher matches.           *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_COLUMN_MATCHER_H
+#define CAEP_COLUMN_MATCHER_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "./section.h"
+
+namespace caep {
+
+/*------------------------------------------------------------------------------------------------
+ * @brief ColumnMatcher matches one request value against a field of all PRM policy rules at
+ * once, and returns a mask with a bit per row: bit r % 64 of word r / 64 is set when row r
+ * matches. Masks of several terms are combined word by word.
+ *
+ *                  eg: # policy.csv                  DefaultMatch(field 1, "data1")
+ *                  a, Alice, data1, read             row 0 -- equal
+ *                  a, Bob, data2, write              row 1 -- no
+ *                  a, Cathy, data*, read             row 2 -- prefix "data" of "data*"
+ *
+ *  mask -- {0b101}
+ *
+ *  Symbols are compared 8 at a time with AVX2 or 4 at a time with SSE2, whichever the build
+ *  targets, else one at a time. Only the rows listed by PolicyIndex::Wildcards compare strings,
+ *  against the prefix SymbolTable keeps before their "*".
+ */
+class ColumnMatcher {
+public:
+    static size_t MaskWords(size_t row_count);
+
+    static size_t CountRows(const std::vector<uint64_t>& mask);
+
+    static size_t FirstRow(const std::vector<uint64_t>& mask);
+
+    static void MatchEqual(const symbol_t* column, size_t row_count, symbol_t id, uint64_t* mask);
+
+    static void DefaultMatch(const Section& section, size_t field_index, std::string_view value, symbol_t id, std::vector<uint64_t>& mask, size_t begin_word = 0, size_t end_word = NO_ROW);
+};
+
+} // namespace caep
+
+#endif
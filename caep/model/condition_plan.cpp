@@ -0,0 +1,464 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : condition_plan.cpp                                           *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   ConditionPlan::Compile -- Compiles a condition expression into an evaluation plan.        *
+ *   ConditionPlan::Match -- Evaluates the plan against a request and a PRM policy rule.       *
+ *   ConditionPlan::Candidates -- Looks up the PRM policy rules that may match a request.      *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_CONDITION_PLAN_CPP
+#define CAEP_CONDITION_PLAN_CPP
+
+#include <algorithm>
+
+#include "./condition_plan.h"
+#include "../util/built_in_functions.h"
+#include "../exception/caep_exception.h"
+
+namespace caep {
+
+/***********************************************************************************************
+ ***                              ConditionPlan::Compile                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Splits the condition expression on "||" and "&&", parses every matcher call    *
+ *              and resolves its Matcher Function and field indices. The field indices come    *
+ *              from the tokens of CONF section 'a', eg: "a = sub, res, act" resolves "a.res"  *
+ *              to 1. A clause is indexed by the first field of its first DefaultMatcher term, *
+ *              for such a field only equal values and wildcards can match. Without one, the   *
+ *              first field of its first IPMatcher term is used, only rules holding an address *
+ *              or a CIDR containing the request address can match it.                         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   exp -- The condition expression, usually the value of CONF section 'c'.            *
+ *                                                                                             *
+ *          model -- Pointer to Model, the tokens of CONF section 'a' are loaded from it.      *
+ *                                                                                             *
+ *          matcher -- Pointer to Matcher, Matcher Functions are resolved by their names.      *
+ *                                                                                             *
+ * OUTPUT:   The immutable plan.                                                               *
+ *                                                                                             *
+ * WARNINGS:    An unknown matcher or field throws IllegalArgumentException. The plan keeps    *
+ *              raw Matcher Function pointers, compile it again once Matcher changes.          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Resolves IPMatcher terms and indexes clauses by them.                 *
+ *     10/17/2026 ARZR : Resolves the effect of CONF section 'e'.                              *
+ *     10/17/2026 ARZR : Keeps the text of every term.                                         *
+ *=============================================================================================*/
+std::shared_ptr<const ConditionPlan> ConditionPlan::Compile(const std::string& exp, Model* model, Matcher* matcher) {
+    auto plan = std::make_shared<ConditionPlan>();
+    plan->domain_index = -1;
+
+    std::vector<std::string> tokens;
+    auto a_it = model->m.find("a");
+    if(a_it != model->m.end()) {
+        auto sec_it = a_it->second.section_map.find("a");
+        if(sec_it != a_it->second.section_map.end())
+            tokens = sec_it->second->tokens;
+    }
+
+    for(size_t i = 0; i < tokens.size(); ++i) {
+        if(tokens[i] == "a.dom")
+            plan->domain_index = int(i);
+    }
+
+    // A model without CONF section 'e' fails on the first request, as the Effector is asked for Custom.
+    plan->effect_kind = EffectKind::Custom;
+    auto e_it = model->m.find("e");
+    if(e_it != model->m.end()) {
+        auto sec_it = e_it->second.section_map.find("e");
+        if(sec_it != e_it->second.section_map.end()) {
+            plan->effect = sec_it->second->value;
+            plan->effect_kind = ParseEffectKind(plan->effect);
+        }
+    }
+
+    for(const auto& or_string : CaepUtil::Split(exp, "||")) {
+        std::vector<MatcherTerm> clause;
+        int index_field = -1;
+        TermKind index_kind = TermKind::Default;
+        for(const auto& and_string : CaepUtil::Split(or_string, "&&")) {
+            std::string term_string = CaepUtil::Trim(and_string);
+            auto left_parentheses_index = term_string.find("(");
+            auto right_parentheses_index = term_string.rfind(")");
+            if(left_parentheses_index == std::string::npos || right_parentheses_index == std::string::npos || right_parentheses_index < left_parentheses_index)
+                throw IllegalArgumentException("invalid matcher call in condition: " + term_string);
+
+            MatcherTerm term;
+            term.text = term_string;
+            term.name = CaepUtil::Trim(term_string.substr(0, left_parentheses_index));
+            term.negated = false;
+            if(term.name.find("!") == 0) {
+                term.name = CaepUtil::Trim(term.name.substr(1));
+                term.negated = true;
+            }
+
+            if(!term.name.compare("RoleMatcher")) {
+                term.kind = TermKind::Role;
+                term.func = nullptr;
+            }
+            else {
+                auto func_it = matcher->matcher_map.find(term.name);
+                if(func_it == matcher->matcher_map.end() || func_it->second == nullptr)
+                    throw IllegalArgumentException("unknown matcher in condition: " + term.name);
+                if(func_it->second == DefaultMatcher)
+                    term.kind = TermKind::Default;
+                else if(func_it->second == IPMatcher)
+                    term.kind = TermKind::IP;
+                else
+                    term.kind = TermKind::Func;
+                term.func = func_it->second;
+            }
+
+            std::string params = term_string.substr(left_parentheses_index + 1, right_parentheses_index - left_parentheses_index - 1);
+            for(const auto& param : CaepUtil::Split(params, ",")) {
+                std::string field = CaepUtil::Trim(param);
+                auto field_it = std::find(tokens.begin(), tokens.end(), field);
+                if(field_it == tokens.end())
+                    throw IllegalArgumentException("unknown field in condition: " + field);
+                term.fields.push_back(int(field_it - tokens.begin()));
+            }
+
+            bool indexable = !term.negated && !term.fields.empty() && (term.kind == TermKind::Default || term.kind == TermKind::IP);
+            if(indexable && (index_field < 0 || (index_kind == TermKind::IP && term.kind == TermKind::Default))) {
+                index_field = term.fields[0];
+                index_kind = term.kind;
+            }
+
+            clause.push_back(term);
+        }
+        plan->clauses.push_back(clause);
+        plan->index_fields.push_back(index_field);
+        plan->index_kinds.push_back(index_kind);
+    }
+
+    return plan;
+}
+
+/***********************************************************************************************
+ ***                                ConditionPlan::Match                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Evaluates the plan against a request and one PRM policy rule. A clause holds   *
+ *              when every parameter of every term holds, and the plan holds when any of its   *
+ *              clauses holds.                                                                 *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   req -- The request, eg: {"Alice", "data1", "read"}.                                *
+ *                                                                                             *
+ *          req_ids -- Symbols of the request, NO_SYMBOL for unknown values.                   *
+ *                                                                                             *
+ *          section -- The Section that stores the PRM policy rules.                           *
+ *                                                                                             *
+ *          row -- Row of the PRM policy rule to be matched.                                   *
+ *                                                                                             *
+ *          rm -- The RoleManager that answers RoleMatcher terms.                              *
+ *                                                                                             *
+ * OUTPUT:   Returns true if the rule matches the request, else returns false.                 *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Moves the test of a term to ConditionPlan::TermHolds.                 *
+ *=============================================================================================*/
+bool ConditionPlan::Match(const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, size_t row, RoleManager* rm) const {
+    for(const auto& clause : clauses) {
+        bool clause_effect = true;
+        for(const auto& term : clause) {
+            for(int field : term.fields) {
+                if(!TermHolds(term, field, req, req_ids, section, row, rm)) {
+                    clause_effect = false;
+                    break;
+                }
+            }
+            if(!clause_effect)
+                break;
+        }
+        if(clause_effect)
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************************
+ ***                                ConditionPlan::Evaluate                                  ***
+ ***********************************************************************************************
+ * DESCRIPTION: Evaluates the plan against a request and every PRM policy rule of a mask at    *
+ *              once. A clause starts from the rows of the mask that no earlier clause         *
+ *              matched, every term clears the rows it does not hold for, and the rows left    *
+ *              are added to the result, so that "&&" is a word-wide AND and "||" a word-wide  *
+ *              OR. A DefaultMatcher term is matched against its whole column by ColumnMatcher *
+ *              while the clause keeps many rows, the other terms and sparse clauses are       *
+ *              tested row by row.                                                             *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   req -- The request, eg: {"Alice", "data1", "read"}.                                *
+ *                                                                                             *
+ *          req_ids -- Symbols of the request, NO_SYMBOL for unknown values.                   *
+ *                                                                                             *
+ *          section -- The Section that stores the PRM policy rules.                           *
+ *                                                                                             *
+ *          rm -- The RoleManager that answers RoleMatcher terms.                              *
+ *                                                                                             *
+ *          scope -- A bit per row as ColumnMatcher masks, only these rules are evaluated, eg: *
+ *          the live rows.                                                                     *
+ *                                                                                             *
+ *          matched -- Receives the words from begin_word to end_word of a mask of the rules   *
+ *                     of scope that match the request.                                        *
+ *                                                                                             *
+ *          begin_word -- First word of the rows to be evaluated, 0 for all rows.              *
+ *                                                                                             *
+ *          end_word -- Word after the rows to be evaluated, clamped to the end of scope.      *
+ *                                                                                             *
+ *          scope_word -- Word of the rows that scope starts at, 0 for a mask of all rows. It  *
+ *                        must not be after begin_word.                                        *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Rows outside of scope are never tested, leave the tombstones out of it.        *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Evaluates a range of words of rows.                                   *
+ *     10/18/2026 ARZR : Takes a scope that starts at scope_word.                              *
+ *=============================================================================================*/
+void ConditionPlan::Evaluate(const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, RoleManager* rm, const std::vector<uint64_t>& scope, std::vector<uint64_t>& matched, size_t begin_word, size_t end_word, size_t scope_word) const {
+    // A column is scanned for a DefaultMatcher term unless the clause keeps fewer than 1/SPARSE_RATIO of the rows.
+    const size_t SPARSE_RATIO = 32;
+    end_word = std::min(end_word, scope_word + scope.size());
+    begin_word = std::min(begin_word, end_word);
+    size_t words = end_word - begin_word;
+    size_t row_count = std::min(section.RowCount(), end_word * 64) - std::min(section.RowCount(), begin_word * 64);
+    matched.assign(words, 0);
+
+    std::vector<uint64_t> clause_mask, term_mask;
+    for(const auto& clause : clauses) {
+        clause_mask.resize(words);
+        for(size_t i = 0; i < words; ++i)
+            clause_mask[i] = scope[begin_word - scope_word + i] & ~matched[i];
+        size_t rows = ColumnMatcher::CountRows(clause_mask);
+
+        for(const auto& term : clause) {
+            for(int field : term.fields) {
+                if(rows == 0)
+                    break;
+
+                if(term.kind == TermKind::Default && !term.negated && size_t(field) < req.size() && rows * SPARSE_RATIO >= row_count) {
+                    ColumnMatcher::DefaultMatch(section, size_t(field), req[field], req_ids[field], term_mask, begin_word, end_word);
+                    for(size_t i = 0; i < words; ++i)
+                        clause_mask[i] &= term_mask[i];
+                    rows = ColumnMatcher::CountRows(clause_mask);
+                    continue;
+                }
+
+                for(size_t i = 0; i < words; ++i) {
+                    for(uint64_t word = clause_mask[i]; word != 0; word &= word - 1) {
+                        size_t row = (begin_word + i) * 64 + size_t(__builtin_ctzll(word));
+                        if(!TermHolds(term, field, req, req_ids, section, row, rm)) {
+                            clause_mask[i] &= ~(uint64_t(1) << (row & 63));
+                            --rows;
+                        }
+                    }
+                }
+            }
+        }
+
+        for(size_t i = 0; i < words; ++i)
+            matched[i] |= clause_mask[i];
+    }
+}
+
+/***********************************************************************************************
+ ***                                ConditionPlan::TermHolds                                 ***
+ ***********************************************************************************************
+ * DESCRIPTION: Evaluates one parameter of a matcher term against a request and one PRM policy *
+ *              rule. DefaultMatcher compares symbols, the strings are only needed by          *
+ *              wildcards, RoleMatcher and the other Matcher Functions.                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   term -- The matcher term.                                                          *
+ *                                                                                             *
+ *          field -- One of the fields of term.                                                *
+ *                                                                                             *
+ *          req -- The request, eg: {"Alice", "data1", "read"}.                                *
+ *                                                                                             *
+ *          req_ids -- Symbols of the request, NO_SYMBOL for unknown values.                   *
+ *                                                                                             *
+ *          section -- The Section that stores the PRM policy rules.                           *
+ *                                                                                             *
+ *          row -- Row of the PRM policy rule to be matched.                                   *
+ *                                                                                             *
+ *          rm -- The RoleManager that answers RoleMatcher terms.                              *
+ *                                                                                             *
+ * OUTPUT:   Returns true if the term holds, negation applied.                                 *
+ *                                                                                             *
+ * WARNINGS:    A field missing from the request or the rule never holds, negated or not.      *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool ConditionPlan::TermHolds(const MatcherTerm& term, int field, const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, size_t row, RoleManager* rm) const {
+    symbol_t rule_id = section.GetId(row, field);
+    if(size_t(field) >= req.size() || rule_id == NO_SYMBOL)
+        return false;
+
+    const SymbolTable& symbols = *section.symbols;
+    bool matcher_effect;
+    if(term.kind == TermKind::Role) {
+        symbol_t domain_id = domain_index >= 0 ? section.GetId(row, domain_index) : NO_SYMBOL;
+        if(domain_id != NO_SYMBOL)
+            matcher_effect = rm->HasLink(req[field], symbols.Name(rule_id), {symbols.Name(domain_id)});
+        else
+            matcher_effect = rm->HasLink(req[field], symbols.Name(rule_id));
+    }
+    else if(term.kind == TermKind::Default && !symbols.IsPattern(rule_id))
+        matcher_effect = req_ids[field] == rule_id;
+    else
+        matcher_effect = term.func(req[field], symbols.Name(rule_id));
+
+    return term.negated ? !matcher_effect : matcher_effect;
+}
+
+/***********************************************************************************************
+ ***                            ConditionPlan::Candidates                                    ***
+ ***********************************************************************************************
+ * DESCRIPTION: Looks up the PRM policy rules that may match a request. For every clause, the  *
+ *              rules holding the request value or a wildcard in its index field are listed,   *
+ *              the rest of the rules can not satisfy that clause. For an IPMatcher field, the *
+ *              rules holding an address or a CIDR that contains the request address are       *
+ *              listed.                                                                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   index -- PolicyIndex of the PRM policy rules.                                      *
+ *                                                                                             *
+ *          req -- The request, the address of an IPMatcher field is parsed from it.           *
+ *                                                                                             *
+ *          req_ids -- Symbols of the request, NO_SYMBOL for unknown values.                   *
+ *                                                                                             *
+ *          rows -- Receives the ascending rows of the candidate rules.                        *
+ *                                                                                             *
+ * OUTPUT:   Returns false if a clause has no index field, all rules have to be scanned then.  *
+ *                                                                                             *
+ * WARNINGS:    The candidates still have to be checked by ConditionPlan::Match.               *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Looks up IPMatcher fields in their CIDRTrie.                          *
+ *=============================================================================================*/
+bool ConditionPlan::Candidates(const PolicyIndex& index, const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, std::vector<size_t>& rows) const {
+    rows.clear();
+
+    std::vector<const std::vector<size_t>*> lists;
+    std::vector<std::vector<size_t>> ip_lists;
+    ip_lists.reserve(index_fields.size());
+    for(size_t i = 0; i < index_fields.size(); ++i) {
+        int field = index_fields[i];
+        if(field < 0)
+            return false;
+        if(size_t(field) >= req_ids.size())
+            continue;
+
+        if(index_kinds[i] == TermKind::IP) {
+            // An invalid request address is left to IPMatcher, which throws for it.
+            IPPrefix addr;
+            if(!IPPrefix::Parse(req[field], addr) || addr.bits != 128)
+                return false;
+            ip_lists.emplace_back();
+            index.FindIP(field, addr, ip_lists.back());
+            lists.push_back(&ip_lists.back());
+            continue;
+        }
+
+        auto exact = index.Find(field, req_ids[field]);
+        if(exact != nullptr)
+            lists.push_back(exact);
+        auto wildcards = index.Wildcards(field);
+        if(wildcards != nullptr)
+            lists.push_back(wildcards);
+    }
+
+    for(auto list : lists)
+        rows.insert(rows.end(), list->begin(), list->end());
+
+    if(lists.size() > 1) {
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    }
+
+    return true;
+}
+
+/***********************************************************************************************
+ ***                                ConditionPlan::Explain                                   ***
+ ***********************************************************************************************
+ * DESCRIPTION: Lists the matcher terms that hold for a request and one PRM policy rule, such  *
+ *              as the rule that decided a request. If a clause holds, its terms are listed,   *
+ *              else every term that holds in any clause is.                                   *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   req -- The request, eg: {"Alice", "data1", "read"}.                                *
+ *                                                                                             *
+ *          req_ids -- Symbols of the request, NO_SYMBOL for unknown values.                   *
+ *                                                                                             *
+ *          section -- The Section that stores the PRM policy rules.                           *
+ *                                                                                             *
+ *          row -- Row of the PRM policy rule.                                                 *
+ *                                                                                             *
+ *          rm -- The RoleManager that answers RoleMatcher terms.                              *
+ *                                                                                             *
+ *          terms -- Receives the text of the terms, eg: "DefaultMatcher(a.res, a.act)".       *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It evaluates the plan on one rule only, call it once the rule is known.        *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void ConditionPlan::Explain(const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, size_t row, RoleManager* rm, std::vector<std::string>& terms) const {
+    terms.clear();
+    std::vector<std::string> held;
+    for(const auto& clause : clauses) {
+        std::vector<std::string> clause_held;
+        for(const auto& term : clause) {
+            bool term_holds = true;
+            for(int field : term.fields) {
+                if(!TermHolds(term, field, req, req_ids, section, row, rm)) {
+                    term_holds = false;
+                    break;
+                }
+            }
+            if(term_holds)
+                clause_held.push_back(term.text);
+        }
+
+        if(clause_held.size() == clause.size()) {
+            terms = clause_held;
+            return;
+        }
+        for(const auto& text : clause_held) {
+            if(std::find(held.begin(), held.end(), text) == held.end())
+                held.push_back(text);
+        }
+    }
+    terms = held;
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,107 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : condition_plan.h                                             *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   ConditionPlan::Compile -- Compiles a condition expression into an evaluation plan.        *
+ *   ConditionPlan::Match -- Evaluates the plan against a request and a PRM policy rule.       *
+ *   ConditionPlan::Candidates -- Looks up the PRM policy rules that may match a request.      *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_CONDITION_PLAN_H
+#define CAEP_CONDITION_PLAN_H
+
+#include "./matcher.h"
+#include "./column_matcher.h"
+#include "../effect/effect.h"
+
+namespace caep {
+
+/*------------------------------------------------------------------------------------------------
+ * @brief Kinds of matcher terms in a condition. RoleMatcher is answered by the RoleManager,
+ * DefaultMatcher by comparing symbols unless the rule value holds a wildcard, IPMatcher by its
+ * Matcher Function on the rules that the CIDRTrie of its field lists, all of the others are
+ * answered by a Matcher Function.
+ */
+enum class TermKind {
+    Role, Default, IP, Func
+};
+
+/*------------------------------------------------------------------------------------------------
+ * @brief MatcherTerm is a single call in a condition, such as "!DefaultMatcher(a.res, a.act)".
+ *
+ *  in this case:
+ *
+ *  text -- "!DefaultMatcher(a.res, a.act)"
+ *  name -- "DefaultMatcher"
+ *  func -- pointer to DefaultMatcher
+ *  negated -- true
+ *  fields -- {1, 2}, indices of "a.res" and "a.act" in both request and policy rule.
+ */
+class MatcherTerm {
+public:
+    std::string text;
+    std::string name;
+    TermKind kind;
+    MatcherFunc func;
+    bool negated;
+    std::vector<int> fields;
+};
+
+/*------------------------------------------------------------------------------------------------
+ * @brief ConditionPlan is the compiled form of the CONF section 'c'. The expression is split,
+ * trimmed and resolved only once, Caeper then runs the plan on every request.
+ *
+ *                  eg: c = RoleMatcher(a.sub) && DefaultMatcher(a.res, a.act) || ...
+ *
+ *  clauses -- {{RoleMatcher(a.sub), DefaultMatcher(a.res, a.act)}, {...}}, the OR of ANDs.
+ *  index_fields -- {1, ...}, per clause the field looked up in PolicyIndex, -1 if the clause
+ *                  has no DefaultMatcher or IPMatcher field and its rules have to be scanned.
+ *  index_kinds -- {TermKind::Default, ...}, per clause how its index field is looked up, a
+ *                 DefaultMatcher field is preferred to an IPMatcher field.
+
+ *  effect -- "AllowPriority", the value of CONF section 'e', and effect_kind, the same resolved
+ *            when the plan is compiled, so that no request compares effect names.
+ */
+class ConditionPlan {
+public:
+    std::vector<std::vector<MatcherTerm>> clauses;
+    std::vector<int> index_fields;
+    std::vector<TermKind> index_kinds;
+
+    /*
+     * @brief Index of "a.dom" in the policy rule, -1 if the model has no domain.
+     */
+    int domain_index;
+
+    std::string effect;
+    EffectKind effect_kind;
+
+    static std::shared_ptr<const ConditionPlan> Compile(const std::string& exp, Model* model, Matcher* matcher);
+
+    bool Match(const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, size_t row, RoleManager* rm) const;
+
+    void Evaluate(const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, RoleManager* rm, const std::vector<uint64_t>& scope, std::vector<uint64_t>& matched, size_t begin_word = 0, size_t end_word = NO_ROW, size_t scope_word = 0) const;
+
+    bool Candidates(const PolicyIndex& index, const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, std::vector<size_t>& rows) const;
+
+    void Explain(const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, size_t row, RoleManager* rm, std::vector<std::string>& terms) const;
+
+private:
+    bool TermHolds(const MatcherTerm& term, int field, const std::vector<std::string>& req, const std::vector<symbol_t>& req_ids, const Section& section, size_t row, RoleManager* rm) const;
+};
+
+} // namespace caep
+
+#endif
@@ -51,7 +51,11 @@ void Matcher::LoadMatcherFromModel(Model* model) {
 
     auto matchers = CaepUtil::Split(model->m["m"].section_map["m"]->value, ",");
 
-    auto matcher_option = model->m["m"].section_map["m"]->policy[0];
+    auto section = model->m["m"].section_map["m"];
+    if(section->RuleCount() == 0)
+        return;
+
+    auto matcher_option = section->GetRules()[0];
     
     auto matcher_count = matchers.size();
     auto option_count = matcher_option.size();
@@ -111,6 +115,7 @@ bool Matcher::AddMatcher(std::string matcher_name, MatcherFunc mf) {
     if(found)
         return false;
     matcher_map[matcher_name] = mf;
+    return true;
 }
 
 } // namespace caep
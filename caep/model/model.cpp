@@ -18,6 +18,7 @@
  *   Model::LoadSection -- Loads all types of a CONF section from Config into Model.           *
  *   Model::LoadNamedSection -- Loads a type of a CONF section from Config into Model.         *
  *   Model::GetKeySuffix -- Transforms int-Type into string-Type.                              *
+ *   Model::FilterRows -- Returns the rows of filtered policy rules.                           *
  *                                                                                             *
  *   Model::Model -- Constructor for Model object.                                             *
  *   Model::Model -- Constructor for Model object, and initialize Model::path.                 *
@@ -26,6 +27,7 @@
  *   Model::LoadModelFromFile -- Loads PEM configurations from a CONF file into current Model. *
  *   Model::LoadModelFromText -- Loads PEM configurations from a CONF text into current Model. *
  *   Model::LoadModelFromConfig -- Loads PEM configurations from Config into current Model.    *
+ *   Model::NewModelFromDefs -- Copies the PEM configurations of a Model into a new Model.     *
  *                                                                                             *
  *   Model::BuildIncrementalRoleLinks -- Adds or deletes inheritance links for all roles.      *
  *   Model::BuildRoleLinks -- Adds inheritance links for all roles.                            *
@@ -172,6 +174,59 @@ std::string Model::GetKeySuffix(int i) {
     return s;
 }
 
+/***********************************************************************************************
+ ***                                Model::FilterRows                                        ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the rows of the PRM policy rules whose fields, starting from           *
+ *              field_index, equal field_values. An empty value matches any field. The values  *
+ *              are looked up in the SymbolTable once, the rules are compared by symbols.      *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   section -- The Section that stores a type of PRM policy rules.                     *
+ *                                                                                             *
+ *          field_index -- Index of the first field to be compared.                            *
+ *                                                                                             *
+ *          field_values -- Values to be compared, eg: {"", "data1"}.                          *
+ *                                                                                             *
+ * OUTPUT:   The ascending rows of the matched rules.                                          *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::vector<size_t> Model::FilterRows(const Section& section, int field_index, const std::vector<std::string>& field_values) {
+    std::vector<size_t> rows;
+    std::vector<symbol_t> ids;
+    for(const auto& value : field_values) {
+        if(value == "") {
+            ids.push_back(NO_SYMBOL);
+            continue;
+        }
+        symbol_t id = section.symbols ? section.symbols->Find(value) : NO_SYMBOL;
+        if(id == NO_SYMBOL)
+            return rows;
+        ids.push_back(id);
+    }
+
+    for(size_t i = 0; i < section.RowCount(); ++i) {
+        if(!section.IsLive(i))
+            continue;
+
+        bool matched = true;
+        for(size_t j = 0; j < ids.size(); ++j) {
+            if(ids[j] != NO_SYMBOL && section.GetId(i, field_index + j) != ids[j]) {
+                matched = false;
+                break;
+            }
+        }
+        if(matched)
+            rows.push_back(i);
+    }
+
+    return rows;
+}
+
 /***********************************************************************************************
  ***                                 Model::LoadNamedSection                                 ***
  ***********************************************************************************************
@@ -240,7 +295,7 @@ bool Model::AddDef(const std::string& sec, const std::string& key, const std::st
     
     if(m.find(sec) == m.end())
         m[sec] = SectionMap();
-    ast->policy = {};
+    ast->symbols = symbols;
 
     m[sec].section_map[key] = ast;
 
@@ -388,6 +443,32 @@ Model* Model::NewModelFromText(const std::string& text) {
     return m;
 }
 
+/***********************************************************************************************
+ ***                                Model::NewModelFromDefs                                  ***
+ ***********************************************************************************************
+ * DESCRIPTION: Gets a pointer to Model that holds the PEM configurations of another Model but *
+ *              none of its PRM policy rules, and a SymbolTable of its own. Policy reloads     *
+ *              fill such a Model aside while the other one still answers requests.            *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   model -- The Model whose CONF sections are copied.                                 *
+ *                                                                                             *
+ * OUTPUT:   Pointer to Model.                                                                 *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+Model* Model::NewModelFromDefs(const Model& model) {
+    auto m = NewModel();
+    for(const auto& sec : model.m) {
+        for(const auto& it : sec.second.section_map)
+            m->AddDef(sec.first, it.first, it.second->value);
+    }
+    return m;
+}
+
 /***********************************************************************************************
  ***                            Model::BuildIncrementalRoleLinks                             ***
  ***********************************************************************************************
@@ -448,30 +529,13 @@ void Model::BuildRoleLinks(std::shared_ptr<RoleManager> rm) {
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Drops the rules instead of leaving empty ones, resets PolicyIndex.    *
  *=============================================================================================*/
 void Model::ClearPolicy() {
-    auto& a_section_map = this->m["a"].section_map;
-    for(auto& it : a_section_map) {
-        if((it.second)->policy.size() > 0) {
-            for(auto& p : (it.second)->policy)
-                std::vector<std::string>().swap(p);
-        }
-    }
-
-    auto& r_section_map = this->m["r"].section_map;
-    for(auto& it : r_section_map) {
-        if((it.second)->policy.size() > 0) {
-            for(auto& p : (it.second)->policy)
-                std::vector<std::string>().swap(p);
-        }
-    }
-
-    auto& m_section_map = this->m["m"].section_map;
-    for(auto& it : m_section_map) {
-        if((it.second)->policy.size() > 0) {
-            for(auto& p : (it.second)->policy)
-                std::vector<std::string>().swap(p);
-        }
+    for(const auto& sec : {"a", "r", "m"}) {
+        auto& section_map = this->m[sec].section_map;
+        for(auto& it : section_map)
+            (it.second)->ClearRules();
     }
 }
 
@@ -493,23 +557,14 @@ void Model::ClearPolicy() {
  *     08/22/2019 ARZR : Created.                                                              *
  *=============================================================================================*/
 std::vector<std::vector<std::string>> Model::GetPolicy(const std::string& sec, const std::string& p_type) {
-    return this->m[sec].section_map[p_type]->policy;
+    return this->m[sec].section_map[p_type]->GetRules();
 }
 
 std::vector<std::vector<std::string>> Model::GetFilteredPolicy(const std::string& sec, const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
     std::vector<std::vector<std::string>> res;
-    std::vector<std::vector<std::string>> policy(m[sec].section_map[p_type]->policy);
-    for(size_t i = 0; i < policy.size(); ++i) {
-        bool matched = true;
-        for(size_t j = 0; j < field_values.size(); ++j) {
-            if(field_values[j] != "" && (policy[i])[field_index + j] != field_values[j]) {
-                matched = false;
-                break;
-            }
-        }
-        if(matched)
-            res.push_back(policy[i]);
-    }
+    auto section = m[sec].section_map[p_type];
+    for(size_t row : FilterRows(*section, field_index, field_values))
+        res.push_back(section->GetRule(row));
 
     return res;
 }
@@ -537,12 +592,8 @@ std::vector<std::vector<std::string>> Model::GetFilteredPolicy(const std::string
  *     08/22/2019 ARZR : Created.                                                              *
  *=============================================================================================*/
 bool Model::HasPolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& rule) {
-    auto& policy = this->m[sec].section_map[p_type]->policy;
-    for(const auto& policy_it : policy)
-        if(CaepUtil::ArrayEqual(rule, policy_it))
-            return true;
-
-    return false;
+    auto section = this->m[sec].section_map[p_type];
+    return section->FindRule(rule) != NO_ROW;
 }
 
 /***********************************************************************************************
@@ -566,7 +617,7 @@ bool Model::HasPolicy(const std::string& sec, const std::string& p_type, const s
  *=============================================================================================*/
 bool Model::AddPolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& rule) {
     if(!this->HasPolicy(sec, p_type, rule)) {
-        m[sec].section_map[p_type]->policy.push_back(rule);
+        m[sec].section_map[p_type]->AddRule(rule);
         return true;
     }
 
@@ -598,7 +649,7 @@ bool Model::AddPolicies(const std::string& sec, const std::string& p_type, const
             return false;
 
     for(const auto& rule : rules)
-        this->m[sec].section_map[p_type]->policy.push_back(rule);
+        this->m[sec].section_map[p_type]->AddRule(rule);
 
     return true;
 }
@@ -626,30 +677,19 @@ bool Model::AddPolicies(const std::string& sec, const std::string& p_type, const
  *     08/22/2019 ARZR : Created.                                                              *
  *=============================================================================================*/
 bool Model::UpdatePolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& oldRule, const std::vector<std::string>& newRule) {
-    auto& policy = m[sec].section_map[p_type]->policy;
-
-    bool is_oldRule_deleted = false, is_newRule_added = false;
+    auto section = m[sec].section_map[p_type];
 
-    for(auto it = policy.begin(); it != policy.end(); ++it) {
-        if(CaepUtil::ArrayEqual(oldRule, *it)) {
-            policy.erase(it);
-            is_oldRule_deleted = true;
-            break;
-        }
-    } 
-
-    if(!is_oldRule_deleted)
+    size_t row = section->FindRule(oldRule);
+    if(row == NO_ROW)
         return false;
 
-    if(!this->HasPolicy(sec, p_type, newRule)) {
-        policy.push_back(newRule);
-        is_newRule_added = true;
-    }
+    section->RemoveRules({row});
 
-    if(!is_newRule_added)
+    if(this->HasPolicy(sec, p_type, newRule))
         return false;
 
-    return is_oldRule_deleted && is_newRule_added;
+    section->AddRule(newRule);
+    return true;
 }
 
 /***********************************************************************************************
@@ -675,20 +715,13 @@ bool Model::UpdatePolicy(const std::string& sec, const std::string& p_type, cons
  *     08/22/2019 ARZR : Created.                                                              *
  *=============================================================================================*/
 bool Model::UpdatePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& oldRules, const std::vector<std::vector<std::string>>& newRules) {
-    auto& policy = this->m[sec].section_map[p_type]->policy;
+    auto section = this->m[sec].section_map[p_type];
 
-    bool is_oldRule_deleted;
     for(const auto& oldRule : oldRules) {
-        is_oldRule_deleted = false;
-        for(auto it = policy.begin(); it != policy.end(); ++it) {
-            if(CaepUtil::ArrayEqual(oldRule, *it)) {
-                policy.erase(it);
-                is_oldRule_deleted = true;
-                break;
-            }
-        }
-        if(!is_oldRule_deleted)
+        size_t row = section->FindRule(oldRule);
+        if(row == NO_ROW)
             return false;
+        section->RemoveRules({row});
     }
 
     for(const auto& newRule : newRules) {
@@ -699,7 +732,7 @@ bool Model::UpdatePolicies(const std::string& sec, const std::string& p_type, co
     }
 
     for(const auto& newRule : newRules)
-        policy.push_back(newRule);
+        section->AddRule(newRule);
 
     return true;
 }
@@ -725,15 +758,14 @@ bool Model::UpdatePolicies(const std::string& sec, const std::string& p_type, co
  *     08/22/2019 ARZR : Created.                                                              *
  *=============================================================================================*/
 bool Model::RemovePolicy(const std::string& sec, const std::string& p_type, const std::vector<std::string>& rule) {
-    auto& policy = this->m[sec].section_map[p_type]->policy;
+    auto section = this->m[sec].section_map[p_type];
 
-    for(auto it = policy.begin(); it != policy.end(); ++it) {
-        if(CaepUtil::ArrayEqual(rule, *it)) {
-            policy.erase(it);
-            return true;
-        }
-    }
-    return false;
+    size_t row = section->FindRule(rule);
+    if(row == NO_ROW)
+        return false;
+
+    section->RemoveRules({row});
+    return true;
 }
 
 /***********************************************************************************************
@@ -758,25 +790,18 @@ bool Model::RemovePolicy(const std::string& sec, const std::string& p_type, cons
  *=============================================================================================*/
 
 bool Model::RemovePolicies(const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules) {
-    auto& policy = this->m[sec].section_map[p_type]->policy;
+    auto section = this->m[sec].section_map[p_type];
 
-    bool is_equal;
     for(const auto& rule : rules) {
-        is_equal = false;
-        for(const auto& policy_it : policy) {
-            if(CaepUtil::ArrayEqual(rule, policy_it))
-                is_equal = true;
-        }
-        if(!is_equal)
+        if(section->FindRule(rule) == NO_ROW)
             return false;
     }
     
-    for(const auto& rule : rules)
-        policy.erase(remove_if(policy.begin(), policy.end(),
-                               [&](const auto& p) {
-                                    return CaepUtil::ArrayEqual(rule, p);     
-                               }),
-                     policy.end());
+    // Every equal rule is removed, as the former remove_if did.
+    for(const auto& rule : rules) {
+        for(size_t row = section->FindRule(rule); row != NO_ROW; row = section->FindRule(rule))
+            section->RemoveRules({row});
+    }
 
     return true;
 }
@@ -805,27 +830,14 @@ bool Model::RemovePolicies(const std::string& sec, const std::string& p_type, co
  *     08/22/2019 ARZR : Created.                                                              *
  *=============================================================================================*/
 std::pair<bool, std::vector<std::vector<std::string>>> Model::RemoveFilteredPolicy(const std::string& sec, const std::string& p_type, int field_index, const std::vector<std::string>& field_values) {
-    std::vector<std::vector<std::string>> tmp, effects;
-    std::vector<std::vector<std::string>> policy(m[sec].section_map[p_type]->policy);
-    bool res = false;
-    for(size_t i = 0; i < policy.size(); ++i) {
-        bool matched = true;
-        for(int j = 0; j < field_index; ++j) {
-            if(field_values[j] != "" && (policy[i])[field_index + j] != field_values[j]) {
-                matched = false;
-                break;
-            }
-        }
-        if(matched) {
-            effects.push_back(policy[i]);
-            res = true;
-        }
-        else
-            tmp.push_back(policy[i]);
-    }
-
-    m[sec].section_map[p_type]->policy = tmp;
-    std::pair<bool, std::vector<std::vector<std::string>>> result(res, effects);
+    std::vector<std::vector<std::string>> effects;
+    auto section = m[sec].section_map[p_type];
+    std::vector<size_t> rows = FilterRows(*section, field_index, field_values);
+    for(size_t row : rows)
+        effects.push_back(section->GetRule(row));
+
+    section->RemoveRules(rows);
+    std::pair<bool, std::vector<std::vector<std::string>>> result(!rows.empty(), effects);
     return result;
 }
 
@@ -891,9 +903,12 @@ std::vector<std::string> Model::GetValuesForFieldInPolicy(const std::string& sec
  *=============================================================================================*/
 std::vector<std::string> Model::GetAllValuesForFieldInPolicy(const std::string& sec, const std::string& p_type, int field_index) {
     std::vector<std::string> values;
-    std::vector<std::vector<std::string>> policy(m[sec].section_map[p_type]->policy);
-    for(const auto& p : policy)
-        values.push_back(p[field_index]);
+    auto section = m[sec].section_map[p_type];
+    for(size_t i = 0; i < section->RowCount(); ++i) {
+        symbol_t id = section->GetId(i, field_index);
+        if(section->IsLive(i) && id != NO_SYMBOL)
+            values.push_back(section->symbols->Name(id));
+    }
 
     return values;
 }
@@ -18,6 +18,7 @@
  *   Model::LoadSection -- Loads all types of a CONF section from Config into Model.           *
  *   Model::LoadNamedSection -- Loads a type of a CONF section from Config into Model.         *
  *   Model::GetKeySuffix -- Transforms int-Type into string-Type.                              *
+ *   Model::FilterRows -- Returns the rows of filtered policy rules.                           *
  *                                                                                             *
  *   Model::Model -- Constructor for Model object.                                             *
  *   Model::Model -- Constructor for Model object, and initialize Model::path.                 *
@@ -81,6 +82,8 @@ private:
 
     static bool LoadNamedSection(Model* model, std::shared_ptr<ConfigInterface> cfg, const std::string& sec, const std::string& key);
 
+    static std::vector<size_t> FilterRows(const Section& section, int field_index, const std::vector<std::string>& field_values);
+
 public:
 
 
@@ -96,6 +99,11 @@ public:
      */
     std::unordered_map<std::string, SectionMap> m;
 
+    /*
+     * @brief Interns the PRM policy rules of all sections.
+     */
+    std::shared_ptr<SymbolTable> symbols = std::make_shared<SymbolTable>();
+
     /*
      * @brief Minimum required sections for a model to be valid.
      */
@@ -118,6 +126,8 @@ public:
 
     static Model* NewModelFromText(const std::string& text);
 
+    static Model* NewModelFromDefs(const Model& model);
+
 
     void BuildIncrementalRoleLinks(std::shared_ptr<RoleManager> rm, policy_op op, const std::string& sec, const std::string& p_type, const std::vector<std::vector<std::string>>& rules);
 
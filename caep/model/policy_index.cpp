@@ -0,0 +1,267 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : policy_index.cpp                                             *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   PolicyIndex::Clear -- Drops all postings of current PolicyIndex.                          *
+ *   PolicyIndex::Build -- Rebuilds current PolicyIndex from PRM policy rules.                 *
+ *   PolicyIndex::Add -- Indexes a PRM policy rule stored at the given row.                    *
+ *   PolicyIndex::Widen -- Makes room for the postings of a count of fields.                   *
+ *   PolicyIndex::AddColumn -- Indexes a field of the PRM policy rules from a row on.          *
+ *   PolicyIndex::Find -- Returns the rows whose field equals the given value.                 *
+ *   PolicyIndex::Wildcards -- Returns the rows whose field holds a wildcard.                  *
+ *   PolicyIndex::FindIP -- Returns the rows whose IP or CIDR field contains an address.       *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_POLICY_INDEX_CPP
+#define CAEP_POLICY_INDEX_CPP
+
+#include <algorithm>
+
+#include "./policy_index.h"
+#include "./section.h"
+
+namespace caep {
+
+/***********************************************************************************************
+ ***                                PolicyIndex::Clear                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Drops all postings of current PolicyIndex.                                     *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void PolicyIndex::Clear() {
+    m_postings.clear();
+    m_wildcards.clear();
+    m_ip_tries.clear();
+}
+
+/***********************************************************************************************
+ ***                                PolicyIndex::Build                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Rebuilds current PolicyIndex from PRM policy rules, the row of a rule is its   *
+ *              position in the columns of the Section.                                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   section -- The Section that stores a type of PRM policy rules.                     *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void PolicyIndex::Build(const Section& section) {
+    Clear();
+    for(size_t i = 0; i < section.RowCount(); ++i) {
+        if(section.IsLive(i))
+            Add(i, section.GetRuleIds(i), *section.symbols);
+    }
+}
+
+/***********************************************************************************************
+ ***                                 PolicyIndex::Add                                        ***
+ ***********************************************************************************************
+ * DESCRIPTION: Indexes every field of a PRM policy rule. A value holding "*" is a wildcard    *
+ *              for DefaultMatcher, it is listed in Wildcards instead of the postings.         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   row -- Position of the rule in its PRM policy rules.                               *
+ *                                                                                             *
+ *          rule -- Symbols of the PRM policy rule, eg: ids of {"Alice", "data1", "read"}.     *
+ *                                                                                             *
+ *          symbols -- The SymbolTable that interned the rule.                                 *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Rows should be added in ascending order.                                       *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Parses IP and CIDR values into the CIDRTrie of the field.             *
+ *=============================================================================================*/
+void PolicyIndex::Add(size_t row, const std::vector<symbol_t>& rule, const SymbolTable& symbols) {
+    Widen(rule.size());
+
+    IPPrefix prefix;
+    for(size_t i = 0; i < rule.size(); ++i) {
+        if(rule[i] == NO_SYMBOL)
+            continue;
+        if(symbols.IsPattern(rule[i]))
+            m_wildcards[i].push_back(row);
+        else
+            m_postings[i][rule[i]].push_back(row);
+        if(IPPrefix::Parse(symbols.Name(rule[i]), prefix))
+            m_ip_tries[i].Insert(prefix, row);
+    }
+}
+
+/***********************************************************************************************
+ ***                                PolicyIndex::Widen                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Makes room for the postings, wildcards and CIDRTrie of a count of fields, so   *
+ *              that AddColumn can index the fields concurrently.                              *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   field_count -- Count of fields of the widest PRM policy rule.                      *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It never narrows current PolicyIndex.                                          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void PolicyIndex::Widen(size_t field_count) {
+    if(m_postings.size() < field_count) {
+        m_postings.resize(field_count);
+        m_wildcards.resize(field_count);
+        m_ip_tries.resize(field_count);
+    }
+}
+
+/***********************************************************************************************
+ ***                                PolicyIndex::AddColumn                                   ***
+ ***********************************************************************************************
+ * DESCRIPTION: Indexes a field of the PRM policy rules at first_row and after, as Add indexes *
+ *              it rule by rule. Every field has postings of its own, so AddColumn of          *
+ *              different fields may run on different threads.                                 *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   field -- Index of the field, Widen made room for it.                               *
+ *                                                                                             *
+ *          first_row -- First row to be indexed.                                              *
+ *                                                                                             *
+ *          column -- Symbols of the field of every row.                                       *
+ *                                                                                             *
+ *          symbols -- The SymbolTable of the symbols, only read.                              *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Rows should be added in ascending order. Two threads should never add to the   *
+ *              same field.                                                                    *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void PolicyIndex::AddColumn(size_t field, size_t first_row, const std::vector<symbol_t>& column, const SymbolTable& symbols) {
+    IPPrefix prefix;
+    for(size_t row = first_row; row < column.size(); ++row) {
+        symbol_t id = column[row];
+        if(id == NO_SYMBOL)
+            continue;
+        if(symbols.IsPattern(id))
+            m_wildcards[field].push_back(row);
+        else
+            m_postings[field][id].push_back(row);
+        if(IPPrefix::Parse(symbols.Name(id), prefix))
+            m_ip_tries[field].Insert(prefix, row);
+    }
+}
+
+/***********************************************************************************************
+ ***                                 PolicyIndex::Find                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the rows whose field equals the given value.                           *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   field_index -- Index of the field, eg: 1 for "res" of "a = sub, res, act".         *
+ *                                                                                             *
+ *          value -- Symbol of the value to be searched for.                                   *
+ *                                                                                             *
+ * OUTPUT:   Pointer to the ascending rows, nullptr if no row holds the value.                 *
+ *                                                                                             *
+ * WARNINGS:    The pointer is invalidated once current PolicyIndex changes. Removed rules     *
+ *              stay listed until Section::Compact, skip the rows that are not live.           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+const std::vector<size_t>* PolicyIndex::Find(int field_index, symbol_t value) const {
+    if(field_index < 0 || size_t(field_index) >= m_postings.size())
+        return nullptr;
+
+    auto it = m_postings[field_index].find(value);
+    if(it == m_postings[field_index].end())
+        return nullptr;
+
+    return &it->second;
+}
+
+/***********************************************************************************************
+ ***                               PolicyIndex::Wildcards                                    ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the rows whose field holds a wildcard, such as "data*".                *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   field_index -- Index of the field, eg: 1 for "res" of "a = sub, res, act".         *
+ *                                                                                             *
+ * OUTPUT:   Pointer to the ascending rows, nullptr if no row holds a wildcard.                *
+ *                                                                                             *
+ * WARNINGS:    The pointer is invalidated once current PolicyIndex changes. Removed rules     *
+ *              stay listed until Section::Compact, skip the rows that are not live.           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+const std::vector<size_t>* PolicyIndex::Wildcards(int field_index) const {
+    if(field_index < 0 || size_t(field_index) >= m_wildcards.size() || m_wildcards[field_index].empty())
+        return nullptr;
+
+    return &m_wildcards[field_index];
+}
+
+/***********************************************************************************************
+ ***                                PolicyIndex::FindIP                                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the rows whose field holds an IP address or a CIDR that contains an    *
+ *              address, such as "192.168.2.0/24" for 192.168.2.1. The CIDRTrie of the field   *
+ *              is walked once, no rule value is parsed.                                       *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   field_index -- Index of the field, eg: 0 for "ip" of "a = ip, act".                *
+ *                                                                                             *
+ *          addr -- The address, parsed by IPPrefix::Parse.                                    *
+ *                                                                                             *
+ *          rows -- Receives the ascending rows.                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Values that are neither IP addresses nor CIDRs are never listed. Removed rules *
+ *              are listed as well, check Section::IsLive.                                     *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void PolicyIndex::FindIP(int field_index, const IPPrefix& addr, std::vector<size_t>& rows) const {
+    rows.clear();
+    if(field_index < 0 || size_t(field_index) >= m_ip_tries.size())
+        return;
+
+    m_ip_tries[field_index].Lookup(addr, rows);
+    std::sort(rows.begin(), rows.end());
+}
+
+} // namespace caep
+
+#endif
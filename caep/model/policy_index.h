@@ -0,0 +1,84 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : policy_index.h                                               *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   PolicyIndex::Clear -- Drops all postings of current PolicyIndex.                          *
+ *   PolicyIndex::Build -- Rebuilds current PolicyIndex from PRM policy rules.                 *
+ *   PolicyIndex::Add -- Indexes a PRM policy rule stored at the given row.                    *
+ *   PolicyIndex::Widen -- Makes room for the postings of a count of fields.                   *
+ *   PolicyIndex::AddColumn -- Indexes a field of the PRM policy rules from a row on.          *
+ *   PolicyIndex::Find -- Returns the rows whose field equals the given value.                 *
+ *   PolicyIndex::Wildcards -- Returns the rows whose field holds a wildcard.                  *
+ *   PolicyIndex::FindIP -- Returns the rows whose IP or CIDR field contains an address.       *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_POLICY_INDEX_H
+#define CAEP_POLICY_INDEX_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "./symbol_table.h"
+#include "./cidr_trie.h"
+
+namespace caep {
+
+class Section;
+
+/*------------------------------------------------------------------------------------------------
+ * @brief PolicyIndex maps every field symbol of a type of PRM policy rules to the rows that hold
+ * it, so that enforcement only visits the rules that can match a request.
+ *
+ *                  eg: # policy.csv
+ *                  a, Alice, data1, read
+ *                  a, Bob, data*, write
+ *
+ *  in this case, for the field "res":
+ *
+ *  Find(1, id of "data1") -- {0}
+ *  Wildcards(1) -- {1}, "data*" may match any resource, it is kept aside and visited always.
+ *
+ *  Rows are listed in ascending order.
+ *
+ *  Values that are IP addresses or CIDRs, such as "192.168.2.0/24", are also parsed once into a
+ *  CIDRTrie of their field, so that IPMatcher finds its rows with FindIP in a single walk.
+ */
+class PolicyIndex {
+private:
+    std::vector<std::unordered_map<symbol_t, std::vector<size_t>>> m_postings;
+    std::vector<std::vector<size_t>> m_wildcards;
+    std::vector<CIDRTrie> m_ip_tries;
+
+public:
+    void Clear();
+
+    void Build(const Section& section);
+
+    void Add(size_t row, const std::vector<symbol_t>& rule, const SymbolTable& symbols);
+
+    void Widen(size_t field_count);
+
+    void AddColumn(size_t field, size_t first_row, const std::vector<symbol_t>& column, const SymbolTable& symbols);
+
+    const std::vector<size_t>* Find(int field_index, symbol_t value) const;
+
+    const std::vector<size_t>* Wildcards(int field_index) const;
+
+    void FindIP(int field_index, const IPPrefix& addr, std::vector<size_t>& rows) const;
+};
+
+} // namespace caep
+
+#endif
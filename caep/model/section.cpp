@@ -17,15 +17,36 @@
  * Functions:                                                                                  *
  *   Section::BuildIncrementalRoleLinks -- Adds or deletes inheritance links for all Roles.    *
  *   Section::BuildRoleLinks -- Adds inheritance links for all Roles.                          *
+ *   Section::RuleCount -- Returns the count of PRM policy rules.                              *
+ *   Section::RowCount -- Returns the count of rows, tombstones included.                      *
+ *   Section::IsLive -- Determines whether a row holds a PRM policy rule.                      *
+ *   Section::GetId -- Returns the symbol of a field of a PRM policy rule.                     *
+ *   Section::GetRuleIds -- Returns the symbols of a PRM policy rule.                          *
+ *   Section::GetRule -- Returns a PRM policy rule.                                            *
+ *   Section::GetRules -- Returns all PRM policy rules.                                        *
+ *   Section::FindRule -- Returns the row of a PRM policy rule.                                *
+ *   Section::AddRule -- Appends a PRM policy rule and indexes it.                             *
+ *   Section::AddRuleIds -- Appends a PRM policy rule of symbols and indexes it.               *
+ *   Section::LoadColumns -- Replaces all PRM policy rules by columns of symbols.              *
+ *   Section::AppendRules -- Appends PRM policy rules given as columns and indexes them.       *
+ *   Section::RemoveRules -- Removes PRM policy rules by their rows.                           *
+ *   Section::ClearRules -- Removes all PRM policy rules.                                      *
+ *   Section::BuildIndex -- Rebuilds the PolicyIndex from the PRM policy rules.                *
+ *   Section::Compact -- Drops the tombstones of removed PRM policy rules.                     *
+ *   Section::Reindex -- Rebuilds the live mask, fingerprints and index of all rows.           *
+ *   Section::Fingerprint -- Hashes the symbols of a PRM policy rule in any order.             *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #ifndef CAEP_SECTION_CPP
 #define CAEP_SECTION_CPP
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 
 #include "./section.h"
 #include "../exception/illegal_argument_exception.h"
+#include "../log/thread_util/thread.h"
 
 namespace caep {
 
@@ -97,7 +118,7 @@ void Section::BuildRoleLinks(std::shared_ptr<RoleManager> rm) {
     if(role_count < 2)
         throw IllegalArgumentException("the number of \"$\" in role section should be at least 2");
    
-    for(const auto& p : policy) {
+    for(const auto& p : GetRules()) {
         std::vector<std::string> rule = p;
 
         if(rule.size() < role_count)
@@ -110,6 +131,626 @@ void Section::BuildRoleLinks(std::shared_ptr<RoleManager> rm) {
     }
 }
 
+/***********************************************************************************************
+ ***                                Section::RuleCount                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the count of live PRM policy rules in current Section.                 *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   The count of PRM policy rules.                                                    *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t Section::RuleCount() const {
+    return m_row_count - m_removed_count;
+}
+
+/***********************************************************************************************
+ ***                                Section::RowCount                                        ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the count of rows in current Section, the tombstones of removed rules  *
+ *              included. Rows range from 0 to RowCount() - 1.                                 *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   The count of rows.                                                                *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t Section::RowCount() const {
+    return m_row_count;
+}
+
+/***********************************************************************************************
+ ***                                Section::IsLive                                          ***
+ ***********************************************************************************************
+ * DESCRIPTION: Determines whether a row holds a PRM policy rule, or the tombstone of a        *
+ *              removed one.                                                                   *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   row -- Row to be checked.                                                          *
+ *                                                                                             *
+ * OUTPUT:   Returns true if the row holds a rule, else returns false.                         *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Reads the mask of live rows instead of a flag per row.                *
+ *=============================================================================================*/
+bool Section::IsLive(size_t row) const {
+    return row < m_row_count && (m_live[row >> 6] >> (row & 63) & 1);
+}
+
+/***********************************************************************************************
+ ***                                Section::GetLiveMask                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns a mask with a bit per row, bit r % 64 of word r / 64 is set if row r   *
+ *              holds a PRM policy rule rather than a tombstone.                               *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   The mask, (RowCount() + 63) / 64 words, the bits after RowCount() are clear.      *
+ *                                                                                             *
+ * WARNINGS:    The reference is invalidated once a rule is added or removed.                  *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+const std::vector<uint64_t>& Section::GetLiveMask() const {
+    return m_live;
+}
+
+/***********************************************************************************************
+ ***                                Section::GetId                                           ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the symbol of a field of a PRM policy rule, enforcement compares rules *
+ *              by these symbols instead of strings.                                           *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   row -- Row of the PRM policy rule.                                                 *
+ *                                                                                             *
+ *          field_index -- Index of the field, eg: 1 for "res" of "a = sub, res, act".         *
+ *                                                                                             *
+ * OUTPUT:   The symbol, NO_SYMBOL if the rule has no such field.                              *
+ *                                                                                             *
+ * WARNINGS:    It does not check tombstones.                                                  *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+symbol_t Section::GetId(size_t row, size_t field_index) const {
+    if(field_index >= m_columns.size() || row >= m_row_count)
+        return NO_SYMBOL;
+
+    return m_columns[field_index][row];
+}
+
+/***********************************************************************************************
+ ***                                Section::GetColumn                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the symbols of a field of all PRM policy rules, one per row, so that a *
+ *              field is matched for every rule in one pass.                                   *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   field_index -- Index of the field, eg: 1 for "res" of "a = sub, res, act".         *
+ *                                                                                             *
+ * OUTPUT:   Pointer to RowCount symbols, nullptr if no rule has such a field.                 *
+ *                                                                                             *
+ * WARNINGS:    Tombstones and rules without the field are included, the latter hold           *
+ *              NO_SYMBOL. The pointer is invalidated once a rule is added or the tombstones   *
+ *              are dropped.                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+const symbol_t* Section::GetColumn(size_t field_index) const {
+    if(field_index >= m_columns.size())
+        return nullptr;
+
+    return m_columns[field_index].data();
+}
+
+/***********************************************************************************************
+ ***                                Section::GetRuleIds                                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the symbols of a PRM policy rule, the padding of a short rule is       *
+ *              dropped.                                                                       *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   row -- Row of the PRM policy rule.                                                 *
+ *                                                                                             *
+ * OUTPUT:   The symbols of the rule.                                                          *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::vector<symbol_t> Section::GetRuleIds(size_t row) const {
+    std::vector<symbol_t> ids;
+    for(const auto& column : m_columns) {
+        if(column[row] == NO_SYMBOL)
+            break;
+        ids.push_back(column[row]);
+    }
+
+    return ids;
+}
+
+/***********************************************************************************************
+ ***                                Section::GetRule                                         ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns a PRM policy rule as strings.                                          *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   row -- Row of the PRM policy rule.                                                 *
+ *                                                                                             *
+ * OUTPUT:   The rule, eg: {"Alice", "data", "read"}.                                          *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::vector<std::string> Section::GetRule(size_t row) const {
+    std::vector<std::string> rule;
+    for(const auto& column : m_columns) {
+        if(column[row] == NO_SYMBOL)
+            break;
+        rule.push_back(symbols->Name(column[row]));
+    }
+
+    return rule;
+}
+
+/***********************************************************************************************
+ ***                                Section::GetRules                                        ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns all live PRM policy rules of current Section as strings, in their      *
+ *              order.                                                                         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   The rules.                                                                        *
+ *                                                                                             *
+ * WARNINGS:    It materializes every rule, prefer GetId on hot paths.                         *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::vector<std::vector<std::string>> Section::GetRules() const {
+    std::vector<std::vector<std::string>> rules;
+    rules.reserve(RuleCount());
+    for(size_t i = 0; i < m_row_count; ++i) {
+        if(IsLive(i))
+            rules.push_back(GetRule(i));
+    }
+
+    return rules;
+}
+
+/***********************************************************************************************
+ ***                                Section::FindRule                                        ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the row of a PRM policy rule. Two rules are equal if they hold the     *
+ *              same values in any order, as CaepUtil::ArrayEqual does. The rule is looked up  *
+ *              by its fingerprint, only the rows sharing it are compared.                     *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   rule -- The PRM policy rule to be searched for.                                    *
+ *                                                                                             *
+ * OUTPUT:   The row of the first equal rule, NO_ROW if not found.                             *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t Section::FindRule(const std::vector<std::string>& rule) const {
+    if(symbols == nullptr)
+        return NO_ROW;
+
+    std::vector<symbol_t> ids;
+    ids.reserve(rule.size());
+    for(const auto& value : rule) {
+        symbol_t id = symbols->Find(value);
+        if(id == NO_SYMBOL)
+            return NO_ROW;
+        ids.push_back(id);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    size_t found = NO_ROW;
+    auto range = m_fingerprints.equal_range(Fingerprint(ids));
+    for(auto it = range.first; it != range.second; ++it) {
+        if(it->second >= found)
+            continue;
+        std::vector<symbol_t> row_ids = GetRuleIds(it->second);
+        std::sort(row_ids.begin(), row_ids.end());
+        if(row_ids == ids)
+            found = it->second;
+    }
+
+    return found;
+}
+
+/***********************************************************************************************
+ ***                                Section::AddRule                                         ***
+ ***********************************************************************************************
+ * DESCRIPTION: Interns a PRM policy rule, appends it to the columns of current Section and    *
+ *              indexes it.                                                                    *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   rule -- The PRM policy rule, eg: {"Alice", "data1", "read"}.                       *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It does not check duplicates, Model::AddPolicy does.                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::AddRule(const std::vector<std::string>& rule) {
+    if(symbols == nullptr)
+        symbols = std::make_shared<SymbolTable>();
+
+    std::vector<symbol_t> ids;
+    ids.reserve(rule.size());
+    for(const auto& field : rule)
+        ids.push_back(symbols->Intern(field));
+
+    AddRuleIds(ids);
+}
+
+/***********************************************************************************************
+ ***                                Section::AddRuleIds                                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Appends a PRM policy rule that is already interned to the columns of current   *
+ *              Section and indexes it, so that a loader tokenizing in place never builds the  *
+ *              strings of a rule.                                                             *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   ids -- The symbols of the rule, interned by symbols.                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It does not check duplicates. symbols must not be nullptr.                     *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::AddRuleIds(const std::vector<symbol_t>& ids) {
+    if(m_columns.size() < ids.size())
+        m_columns.resize(ids.size(), std::vector<symbol_t>(m_row_count, NO_SYMBOL));
+
+    for(size_t i = 0; i < m_columns.size(); ++i)
+        m_columns[i].push_back(i < ids.size() ? ids[i] : NO_SYMBOL);
+
+    if((m_row_count & 63) == 0)
+        m_live.push_back(0);
+    m_live[m_row_count >> 6] |= uint64_t(1) << (m_row_count & 63);
+    ++m_row_count;
+
+    policy_index.Add(m_row_count - 1, ids, *symbols);
+    m_fingerprints.emplace(Fingerprint(ids), m_row_count - 1);
+}
+
+/***********************************************************************************************
+ ***                                Section::LoadColumns                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Replaces all PRM policy rules of current Section by rules given column by      *
+ *              column, as a snapshot stores them, and indexes them at once instead of rule by *
+ *              rule.                                                                          *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   columns -- The symbols of every field, each one row_count long.                    *
+ *                                                                                             *
+ *          row_count -- Count of rules.                                                       *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It does not check duplicates. symbols must not be nullptr and must have        *
+ *              interned the symbols.                                                          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::LoadColumns(std::vector<std::vector<symbol_t>> columns, size_t row_count) {
+    for(const auto& column : columns) {
+        if(column.size() != row_count)
+            throw IllegalArgumentException("every column should hold a symbol per row");
+    }
+
+    m_columns = std::move(columns);
+    m_row_count = row_count;
+    Reindex();
+}
+
+/***********************************************************************************************
+ ***                                Section::AppendRules                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Appends rules given column by column after the rules of current Section, as    *
+ *              AddRuleIds would append them one by one. Every field is indexed by a task of   *
+ *              its own and the fingerprints are hashed in ranges of rows, the tasks run on up *
+ *              to thread_count threads.                                                       *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   columns -- The symbols of every field of the new rules, each one row_count long,   *
+ *          NO_SYMBOL past the end of a shorter rule.                                          *
+ *                                                                                             *
+ *          row_count -- Count of rules.                                                       *
+ *                                                                                             *
+ *          thread_count -- Count of threads, 1 indexes on the calling thread only.            *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It does not check duplicates. symbols must not be nullptr and must have        *
+ *              interned the symbols.                                                          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::AppendRules(const std::vector<std::vector<symbol_t>>& columns, size_t row_count, size_t thread_count) {
+    for(const auto& column : columns) {
+        if(column.size() != row_count)
+            throw IllegalArgumentException("every column should hold a symbol per row");
+    }
+
+    size_t first_row = m_row_count;
+    if(m_columns.size() < columns.size())
+        m_columns.resize(columns.size(), std::vector<symbol_t>(m_row_count, NO_SYMBOL));
+    for(size_t i = 0; i < m_columns.size(); ++i) {
+        if(i < columns.size())
+            m_columns[i].insert(m_columns[i].end(), columns[i].begin(), columns[i].end());
+        else
+            m_columns[i].resize(first_row + row_count, NO_SYMBOL);
+    }
+
+    m_row_count += row_count;
+    m_live.resize((m_row_count + 63) / 64, 0);
+    for(size_t row = first_row; row < m_row_count; ++row)
+        m_live[row >> 6] |= uint64_t(1) << (row & 63);
+
+    // The tasks only read the columns and symbols, and each one writes to a field or a range of its own.
+    policy_index.Widen(m_columns.size());
+    std::vector<uint64_t> fingerprints(row_count);
+    size_t range_count = std::max<size_t>(thread_count, 1);
+    size_t task_count = m_columns.size() + range_count;
+    std::atomic<size_t> next_task(0);
+    auto run_tasks = [&]() {
+        for(size_t task = next_task++; task < task_count; task = next_task++) {
+            if(task < m_columns.size()) {
+                policy_index.AddColumn(task, first_row, m_columns[task], *symbols);
+                continue;
+            }
+            size_t range = task - m_columns.size();
+            for(size_t i = row_count * range / range_count; i < row_count * (range + 1) / range_count; ++i)
+                fingerprints[i] = Fingerprint(GetRuleIds(first_row + i));
+        }
+    };
+
+    std::vector<std::unique_ptr<Thread>> workers;
+    std::vector<std::exception_ptr> errors(std::min(range_count, task_count));
+    for(size_t i = 1; i < errors.size(); ++i) {
+        workers.emplace_back(new Thread([&run_tasks, &errors, i]() {
+            try {
+                run_tasks();
+            }
+            catch(...) {
+                errors[i] = std::current_exception();
+            }
+        }, "SectionIndexer"));
+        workers.back()->Start();
+    }
+    try {
+        run_tasks();
+    }
+    catch(...) {
+        errors[0] = std::current_exception();
+    }
+    for(auto& worker : workers)
+        worker->Join();
+    for(const auto& error : errors) {
+        if(error)
+            std::rethrow_exception(error);
+    }
+
+    m_fingerprints.reserve(m_row_count);
+    for(size_t i = 0; i < row_count; ++i)
+        m_fingerprints.emplace(fingerprints[i], first_row + i);
+}
+
+/***********************************************************************************************
+ ***                                Section::RemoveRules                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Removes the PRM policy rules at the given rows. Every row is only marked as a  *
+ *              tombstone, the tombstones are dropped by Compact once they outnumber the live  *
+ *              rules.                                                                         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   rows -- Rows of the rules to be removed, tombstones are ignored.                   *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Compact renumbers the rows, rows got before a call are invalid after it.       *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::RemoveRules(const std::vector<size_t>& rows) {
+    for(size_t row : rows) {
+        if(!IsLive(row))
+            continue;
+
+        auto range = m_fingerprints.equal_range(Fingerprint(GetRuleIds(row)));
+        for(auto it = range.first; it != range.second; ++it) {
+            if(it->second == row) {
+                m_fingerprints.erase(it);
+                break;
+            }
+        }
+
+        m_live[row >> 6] &= ~(uint64_t(1) << (row & 63));
+        ++m_removed_count;
+    }
+
+    if(m_removed_count * 2 > m_row_count)
+        Compact();
+}
+
+/***********************************************************************************************
+ ***                                Section::ClearRules                                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Removes all PRM policy rules of current Section.                               *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    The SymbolTable is kept, it is shared by all sections of a Model.              *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::ClearRules() {
+    m_columns.clear();
+    m_live.clear();
+    m_row_count = 0;
+    m_removed_count = 0;
+    m_fingerprints.clear();
+    policy_index.Clear();
+}
+
+/***********************************************************************************************
+ ***                                Section::BuildIndex                                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Rebuilds the PolicyIndex from the PRM policy rules of current Section.         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Rows are positions in the columns, call it after every in place change of      *
+ *              them.                                                                          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::BuildIndex() {
+    policy_index.Build(*this);
+}
+
+/***********************************************************************************************
+ ***                                Section::Compact                                         ***
+ ***********************************************************************************************
+ * DESCRIPTION: Drops the tombstones of removed PRM policy rules. The live rules keep their    *
+ *              order and are renumbered from 0, then the fingerprints and the PolicyIndex are *
+ *              rebuilt.                                                                       *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    It costs O(RowCount()), RemoveRules calls it seldom enough to keep removals    *
+ *              O(1) amortized.                                                                *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Rebuilds the mask of live rows.                                       *
+ *=============================================================================================*/
+void Section::Compact() {
+    for(auto& column : m_columns) {
+        size_t kept = 0;
+        for(size_t i = 0; i < m_row_count; ++i) {
+            if(IsLive(i))
+                column[kept++] = column[i];
+        }
+        column.resize(kept);
+    }
+
+    m_row_count -= m_removed_count;
+    Reindex();
+}
+
+/***********************************************************************************************
+ ***                                Section::Reindex                                         ***
+ ***********************************************************************************************
+ * DESCRIPTION: Marks every row of current Section live and rebuilds the fingerprints and the  *
+ *              PolicyIndex of the rows.                                                       *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    The columns must hold no tombstone, m_row_count is the count of rules.         *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void Section::Reindex() {
+    m_removed_count = 0;
+    m_live.assign((m_row_count + 63) / 64, ~uint64_t(0));
+    if(m_row_count & 63)
+        m_live.back() = (uint64_t(1) << (m_row_count & 63)) - 1;
+
+    // One pass over the rows fills both, as BuildIndex would with the rules it reads again.
+    m_fingerprints.clear();
+    m_fingerprints.reserve(m_row_count);
+    policy_index.Clear();
+    for(size_t i = 0; i < m_row_count; ++i) {
+        std::vector<symbol_t> ids = GetRuleIds(i);
+        policy_index.Add(i, ids, *symbols);
+        m_fingerprints.emplace(Fingerprint(std::move(ids)), i);
+    }
+}
+
+/***********************************************************************************************
+ ***                                Section::Fingerprint                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Hashes the symbols of a PRM policy rule. The symbols are sorted first, so that *
+ *              rules holding the same values in any order share a fingerprint, as             *
+ *              CaepUtil::ArrayEqual compares them.                                            *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   ids -- Symbols of the PRM policy rule.                                             *
+ *                                                                                             *
+ * OUTPUT:   The fingerprint.                                                                  *
+ *                                                                                             *
+ * WARNINGS:    Equal fingerprints do not prove equal rules, compare the symbols as well.      *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+uint64_t Section::Fingerprint(std::vector<symbol_t> ids) {
+    std::sort(ids.begin(), ids.end());
+
+    // FNV-1a over the sorted symbols.
+    uint64_t hash = 14695981039346656037ULL;
+    for(symbol_t id : ids) {
+        hash ^= id;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= ids.size();
+    hash *= 1099511628211ULL;
+
+    return hash;
+}
 
 } // namespace caep 
 
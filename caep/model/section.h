@@ -17,16 +17,41 @@
  * Functions:                                                                                  *
  *   Section::BuildIncrementalRoleLinks -- Adds or deletes inheritance links for all Roles.    *
  *   Section::BuildRoleLinks -- Adds inheritance links for all Roles.                          *
+ *   Section::RuleCount -- Returns the count of PRM policy rules.                              *
+ *   Section::RowCount -- Returns the count of rows, tombstones included.                      *
+ *   Section::IsLive -- Determines whether a row holds a PRM policy rule.                      *
+ *   Section::GetId -- Returns the symbol of a field of a PRM policy rule.                     *
+ *   Section::GetRuleIds -- Returns the symbols of a PRM policy rule.                          *
+ *   Section::GetRule -- Returns a PRM policy rule.                                            *
+ *   Section::GetRules -- Returns all PRM policy rules.                                        *
+ *   Section::FindRule -- Returns the row of a PRM policy rule.                                *
+ *   Section::AddRule -- Appends a PRM policy rule and indexes it.                             *
+ *   Section::AddRuleIds -- Appends a PRM policy rule of symbols and indexes it.               *
+ *   Section::LoadColumns -- Replaces all PRM policy rules by columns of symbols.              *
+ *   Section::AppendRules -- Appends PRM policy rules given as columns and indexes them.       *
+ *   Section::RemoveRules -- Removes PRM policy rules by their rows.                           *
+ *   Section::ClearRules -- Removes all PRM policy rules.                                      *
+ *   Section::BuildIndex -- Rebuilds the PolicyIndex from the PRM policy rules.                *
+ *   Section::Compact -- Drops the tombstones of removed PRM policy rules.                     *
+ *   Section::Reindex -- Rebuilds the live mask, fingerprints and index of all rows.           *
+ *   Section::Fingerprint -- Hashes the symbols of a PRM policy rule in any order.             *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 #ifndef CAEP_SECTION_H
 #define CAEP_SECTION_H
 
 #include <memory>
+#include <cstdint>
 
 #include "../rbac/role_manager.h"
+#include "./policy_index.h"
 
 namespace caep {
 
+/*------------------------------------------------------------------------------------------
+ * @brief Row that no rule owns, returned by Section::FindRule if a rule is not found.
+ */
+const size_t NO_ROW = SIZE_MAX;
+
 /*------------------------------------------------------------------------------------------
  * @brief Options to determines whether to build or delete inheritance links.
  */
@@ -53,17 +78,47 @@ typedef enum policy_op policy_op;
  *  key -- "a"
  *  value -- "sub, res, act"
  *  key_val -- "sub", "res", "act"
- *  policy -- {{"Alice", "data", "read"},
- *            {"Bob", "data", "write"}}
  *  rm -- RoleManager 
+ *  symbols -- SymbolTable shared by all sections of a Model, "Alice" -- 0, "data" -- 1, ...
+ *  policy_index -- PolicyIndex of the rules.
+ *
+ *  The rules are stored column by column as symbols:
+ *
+ *  m_columns -- {{0, 3},       "Alice", "Bob"
+ *                {1, 1},       "data", "data"
+ *                {2, 4}}       "read", "write"
+ *
+ *  A rule shorter than the others is padded with NO_SYMBOL. A removed rule stays in its row as a
+ *  tombstone until Compact drops the tombstones and renumbers the rows, so that removing a rule
+ *  costs O(1) and the order of the rules is kept. Loops over rows should skip !IsLive(row).
+ *
+ *  m_live -- Bit r % 64 of word r / 64 is set while row r holds a rule, tombstones are cleared,
+ *            so that whole masks of rows are filtered by a word-wide AND.
+ *
+ *  m_fingerprints -- Hash of the sorted symbols of a rule -> its row, so that equal rules in the
+ *                    sense of CaepUtil::ArrayEqual are found in O(1).
  */
 class Section {
+private:
+    std::vector<std::vector<symbol_t>> m_columns;
+    std::vector<uint64_t> m_live;
+    size_t m_row_count = 0;
+    size_t m_removed_count = 0;
+    std::unordered_multimap<uint64_t, size_t> m_fingerprints;
+
+    static uint64_t Fingerprint(std::vector<symbol_t> ids);
+
+    void Compact();
+
+    void Reindex();
+
 public:
     std::string key;
     std::string value;
     std::vector<std::string> tokens;
-    std::vector<std::vector<std::string>> policy;
     std::shared_ptr<RoleManager> rm;
+    std::shared_ptr<SymbolTable> symbols;
+    PolicyIndex policy_index;
 
     /*
      * @brief Uses outter rules to build or delete inheritance links for all roles, according to the 'op'.
@@ -74,6 +129,74 @@ public:
      * @brief Uses inner rules to build inheritance links for all roles.
      */
     void BuildRoleLinks(std::shared_ptr<RoleManager> rm);
+
+    /*
+     * @brief Count of live rules.
+     */
+    size_t RuleCount() const;
+
+    /*
+     * @brief Count of rows, tombstones included.
+     */
+    size_t RowCount() const;
+
+    bool IsLive(size_t row) const;
+
+    /*
+     * @brief A bit per row as ColumnMatcher masks, set for the rows that are not tombstones.
+     */
+    const std::vector<uint64_t>& GetLiveMask() const;
+
+    symbol_t GetId(size_t row, size_t field_index) const;
+
+    /*
+     * @brief RowCount symbols of a field, nullptr if no rule has that field.
+     */
+    const symbol_t* GetColumn(size_t field_index) const;
+
+    std::vector<symbol_t> GetRuleIds(size_t row) const;
+
+    std::vector<std::string> GetRule(size_t row) const;
+
+    std::vector<std::vector<std::string>> GetRules() const;
+
+    /*
+     * @brief Rules are compared as CaepUtil::ArrayEqual does, returns NO_ROW if not found.
+     */
+    size_t FindRule(const std::vector<std::string>& rule) const;
+
+    /*
+     * @brief Appends a rule and keeps policy_index in sync.
+     */
+    void AddRule(const std::vector<std::string>& rule);
+
+    /*
+     * @brief Appends a rule whose fields are interned by symbols already, as AddRule does.
+     */
+    void AddRuleIds(const std::vector<symbol_t>& ids);
+
+    /*
+     * @brief Replaces all rules by row_count rows of columns, symbols interned them already.
+     */
+    void LoadColumns(std::vector<std::vector<symbol_t>> columns, size_t row_count);
+
+    /*
+     * @brief Appends row_count rows of columns as AddRuleIds would one by one, the fields are indexed
+     * on up to thread_count threads.
+     */
+    void AppendRules(const std::vector<std::vector<symbol_t>>& columns, size_t row_count, size_t thread_count);
+
+    /*
+     * @brief Removes the rules at the given rows, the others keep their order.
+     */
+    void RemoveRules(const std::vector<size_t>& rows);
+
+    void ClearRules();
+
+    /*
+     * @brief Rebuilds policy_index, used once rules are erased or reordered.
+     */
+    void BuildIndex();
 };
 
 } // namespace caep 
@@ -0,0 +1,195 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : symbol_table.cpp                                             *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   SymbolTable::Intern -- Returns the id of a string, assigns a new id if it is unknown.     *
+ *   SymbolTable::Find -- Returns the id of a string without assigning one.                    *
+ *   SymbolTable::Name -- Returns the string of an id.                                         *
+ *   SymbolTable::IsPattern -- Determines whether the string of an id holds a wildcard.        *
+ *   SymbolTable::Size -- Returns the count of interned strings.                               *
+ *   SymbolTable::Reserve -- Makes room for a count of strings.                                *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_SYMBOL_TABLE_CPP
+#define CAEP_SYMBOL_TABLE_CPP
+
+#include "./symbol_table.h"
+#include "../exception/caep_exception.h"
+
+namespace caep {
+
+/***********************************************************************************************
+ ***                                SymbolTable::Intern                                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the id of a string. An unknown string is copied into current table     *
+ *              and gets the next id.                                                          *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   name -- The string to be interned, eg: "Alice".                                    *
+ *                                                                                             *
+ * OUTPUT:   The id of the string.                                                             *
+ *                                                                                             *
+ * WARNINGS:    The keys of m_ids view into m_names, std::deque keeps them in place.           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+symbol_t SymbolTable::Intern(std::string_view name) {
+    auto it = m_ids.find(name);
+    if(it != m_ids.end())
+        return it->second;
+
+    if(m_names.size() >= NO_SYMBOL)
+        throw IllegalArgumentException("too many distinct strings in policy");
+
+    symbol_t id = symbol_t(m_names.size());
+    m_names.emplace_back(name);
+    size_t wildcard = name.find('*');
+    m_wildcards.push_back(wildcard == std::string_view::npos ? NO_WILDCARD : uint32_t(wildcard));
+    m_ids.emplace(std::string_view(m_names.back()), id);
+
+    return id;
+}
+
+/***********************************************************************************************
+ ***                                 SymbolTable::Find                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the id of a string without assigning one, requests are looked up by it *
+ *              so that they never grow current table.                                        *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   name -- The string to be searched for.                                             *
+ *                                                                                             *
+ * OUTPUT:   The id of the string, NO_SYMBOL if it is unknown.                                 *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+symbol_t SymbolTable::Find(std::string_view name) const {
+    auto it = m_ids.find(name);
+    if(it == m_ids.end())
+        return NO_SYMBOL;
+
+    return it->second;
+}
+
+/***********************************************************************************************
+ ***                                 SymbolTable::Name                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the string of an id.                                                   *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   id -- Id returned by SymbolTable::Intern.                                          *
+ *                                                                                             *
+ * OUTPUT:   The interned string.                                                              *
+ *                                                                                             *
+ * WARNINGS:    An unknown id throws IllegalArgumentException.                                 *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+const std::string& SymbolTable::Name(symbol_t id) const {
+    if(id >= m_names.size())
+        throw IllegalArgumentException("unknown symbol id");
+
+    return m_names[id];
+}
+
+/***********************************************************************************************
+ ***                               SymbolTable::IsPattern                                    ***
+ ***********************************************************************************************
+ * DESCRIPTION: Determines whether the string of an id holds "*", such a rule value may match  *
+ *              other strings than itself in DefaultMatcher.                                   *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   id -- Id returned by SymbolTable::Intern.                                          *
+ *                                                                                             *
+ * OUTPUT:   Returns true if the string holds a wildcard, else returns false.                  *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool SymbolTable::IsPattern(symbol_t id) const {
+    return id < m_wildcards.size() && m_wildcards[id] != NO_WILDCARD;
+}
+
+/***********************************************************************************************
+ ***                                SymbolTable::PatternPrefix                               ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the part of a wildcard string before its first "*", eg: "data" for     *
+ *              "data*". DefaultMatcher matches every string that starts with it.              *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   id -- Id returned by SymbolTable::Intern.                                          *
+ *                                                                                             *
+ * OUTPUT:   The prefix, the whole string if it holds no wildcard.                             *
+ *                                                                                             *
+ * WARNINGS:    The view is valid as long as current table.                                    *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::string_view SymbolTable::PatternPrefix(symbol_t id) const {
+    std::string_view name = Name(id);
+    return m_wildcards[id] == NO_WILDCARD ? name : name.substr(0, m_wildcards[id]);
+}
+
+/***********************************************************************************************
+ ***                                 SymbolTable::Size                                       ***
+ ***********************************************************************************************
+ * DESCRIPTION: Returns the count of interned strings.                                         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   The count of interned strings.                                                    *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+size_t SymbolTable::Size() const {
+    return m_names.size();
+}
+
+/***********************************************************************************************
+ ***                                SymbolTable::Reserve                                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Makes room for count strings, so that interning a known count of strings, eg:  *
+ *              those of a snapshot, never rehashes.                                           *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   count -- The count of strings current table will hold.                             *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void SymbolTable::Reserve(size_t count) {
+    m_wildcards.reserve(count);
+    m_ids.reserve(count);
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,91 @@
+/* $Header:  ~/code/GitRepositories/MyGit/caep   2.1.0   22 Aug 2019 19:00:00   ArZr        $ */
+/***********************************************************************************************
+ ***                  C O N F I D E N T I A L  ---  A R Z R  S T U D I O S                   ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Caep                                                         *
+ *                                                                                             *
+ *                    File Name : symbol_table.h                                               *
+ *                                                                                             *
+ *                   Programmer : Guan Zhe                                                     *
+ *                                                                                             *
+ *                   Start Date : Oct 17, 2026                                                 *
+ *                                                                                             *
+ *                  Last Update : Oct 17, 2026   [ArZr]                                        *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   SymbolTable::Intern -- Returns the id of a string, assigns a new id if it is unknown.     *
+ *   SymbolTable::Find -- Returns the id of a string without assigning one.                    *
+ *   SymbolTable::Name -- Returns the string of an id.                                         *
+ *   SymbolTable::IsPattern -- Determines whether the string of an id holds a wildcard.        *
+ *   SymbolTable::Size -- Returns the count of interned strings.                               *
+ *   SymbolTable::Reserve -- Makes room for a count of strings.                                *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+#ifndef CAEP_SYMBOL_TABLE_H
+#define CAEP_SYMBOL_TABLE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace caep {
+
+/*------------------------------------------------------------------------------------------------
+ * @brief Id of an interned string.
+ */
+typedef uint32_t symbol_t;
+
+/*------------------------------------------------------------------------------------------------
+ * @brief Id that no string owns, it marks a missing field or an unknown request value.
+ */
+const symbol_t NO_SYMBOL = UINT32_MAX;
+
+/*------------------------------------------------------------------------------------------------
+ * @brief Position in SymbolTable::m_wildcards of a string without "*".
+ */
+const uint32_t NO_WILDCARD = UINT32_MAX;
+
+/*------------------------------------------------------------------------------------------------
+ * @brief SymbolTable interns every string of the PRM policy rules once and hands out 32-bit ids,
+ * so that rules are stored as ids and compared by ids.
+ *
+ *                  eg: # policy.csv
+ *                  a, Alice, data1, read
+ *                  a, Bob, data1, write
+ *
+ *  in this case:
+ *
+ *  "Alice" -- 0, "data1" -- 1, "read" -- 2, "Bob" -- 3, "write" -- 4
+ *
+ *  Ids are never reused, the strings live as long as the table. m_wildcards keeps the position of
+ *  the first "*" of every string, NO_WILDCARD if it has none, so DefaultMatcher never searches.
+ */
+class SymbolTable {
+private:
+    std::deque<std::string> m_names;
+    std::vector<uint32_t> m_wildcards;
+    std::unordered_map<std::string_view, symbol_t> m_ids;
+
+public:
+    symbol_t Intern(std::string_view name);
+
+    symbol_t Find(std::string_view name) const;
+
+    const std::string& Name(symbol_t id) const;
+
+    bool IsPattern(symbol_t id) const;
+
+    std::string_view PatternPrefix(symbol_t id) const;
+
+    size_t Size() const;
+
+    void Reserve(size_t count);
+};
+
+} // namespace caep
+
+#endif
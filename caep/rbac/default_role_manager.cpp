@@ -15,364 +15,368 @@
  *                                                                                             *
  *---------------------------------------------------------------------------------------------*
  * Functions:                                                                                  *
- *   Role::Role -- Constructor.                                                                *
- *   Role::NewRole -- Gets a shared_ptr<Role>.                                                 *
- *   Role::AddRole -- Adds a Role to Role::all_roles.                                          *
- *   Role::DeleteRole -- Deletes a Role from Role::all_roles.                                  *
- *   Role::HasRole -- Determines if current Role::all_roles has a Role recursively.            *
- *   Role::HasDirectRole -- Determines if current Role::all_roles has a Role directly.         *
- *   Role::ToString -- Prints all Role's name in Role::all_roles.                              *
- *   Role::GetRoles -- Gets all Role's name in Role::all_roles.                                *
- *                                                                                             *
+ *   DefaultRoleManager::FindDomain -- Looks up the RoleGraph of a domain.                     *
+ *   DefaultRoleManager::CreateDomain -- Gets a new RoleGraph or an existed one for a domain.  *
+ *   DefaultRoleManager::FindRole -- Looks up the id of a Role.                                *
+ *   DefaultRoleManager::PatternRoles -- Gets the Roles that match a name by pattern.          *
+ *   DefaultRoleManager::IsPattern -- Determines if a name is a pattern Role.                  *
  *   DefaultRoleManager::HasRole -- Determines if RoleManager has a Role directly.             *
  *   DefaultRoleManager::CreateRole -- Gets a new Role or an existed Role.                     *
+ *   DefaultRoleManager::AddEdge -- Adds a direct parent and extends the reachability index.   *
+ *   DefaultRoleManager::DeleteEdge -- Deletes a direct parent and repairs the index.          *
  *   DefaultRoleManager::DefaultRoleManager -- Constructor and specifies a hierarchy_level.    *
  *   DefaultRoleManager::AddMatchingFunc -- Adds a match function to RoleManager.              *
  *   DefaultRoleManager::Clear -- Clears all Roles.                                            *
+ *   DefaultRoleManager::ClearDomain -- Clears all Roles of a domain.                          *
+ *   DefaultRoleManager::NewEmpty -- Creates a RoleManager with the same settings.             *
  *   DefaultRoleManager::AddLink -- Builds a hieritance link between two Roles.                *
  *   DefaultRoleManager::DeleteLink -- Deletes a hieritance link between two Roles.            *
  *   DefaultRoleManager::HasLink -- Determines if there is a hieritance link between two Roles.*
  *   DefaultRoleManager::GetRoles -- Gets all Roles that a user owns.                          *
  *   DefaultRoleManager::GetUsers -- Gets all Users that a Role owns.                          *
+ *   DefaultRoleManager::GetImplicitUsers -- Gets all Users that inherit a Role.               *
+ *   DefaultRoleManager::HasUsers -- Determines if a Role has direct Users.                    *
+ *   DefaultRoleManager::HasMatchingFunc -- Determines if a matching function was added.       *
  *   DefaultRoleManager::PrintRoles -- Prints all Roles in Rolemanager.                        *
+ *   DefaultRoleManager::SaveGraphs -- Writes the Roles, links and index of all domains.       *
+ *   DefaultRoleManager::LoadGraphs -- Restores the RoleGraphs that SaveGraphs wrote.          *
+ *   DefaultRoleManager::RoleGraph::Swap -- Exchanges the Roles of two RoleGraphs.             *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #ifndef CAEP_DEFAULT_ROLE_MANAGER_CPP
 #define CAEP_DEFAULT_ROLE_MANAGER_CPP
 
+#include <algorithm>
+
 #include "./default_role_manager.h"
 #include "../exception/rbac_exception.h"
-#include "../exception/weak_ptr_exception.h"
+#include "../exception/io_exception.h"
 
 namespace caep {
 
 /***********************************************************************************************
- ***                                Role::NewRole                                            ***
+ ***                                DefaultRoleManager::FindDomain                           ***
  ***********************************************************************************************
- * DESCRIPTION: Gets a shared_ptr<Role>.                                                       *
+ * DESCRIPTION: Looks up the id of the RoleGraph of a domain. Roles without a domain belong to *
+ *              the RoleGraph 0, which always exists.                                          *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   name -- It is used to initialize Role::name.                                       *
+ * INPUT:   domain -- Empty, or the name of the domain.                                        *
  *                                                                                             *
- * OUTPUT:   Returns smart pointer to Role.                                                    *
+ * OUTPUT:   Returns the id of the RoleGraph, or NO_DOMAIN if no link was ever added in the    *
+ *           domain.                                                                           *
  *                                                                                             *
- * WARNINGS:    NONE                                                                           *
+ * WARNINGS:    Size of domain should not exceed over 1, otherwise, an exception will be       *
+ *              thrown                                                                         *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
  *=============================================================================================*/
-SRptr Role::NewRole(std::string name) {
-    SRptr role(new Role(name));
-    return role;
+domain_t DefaultRoleManager::FindDomain(const std::vector<std::string>& domain) const {
+    if(domain.empty())
+        return 0;
+    if(domain.size() > 1)
+        throw CaepRbacException("error: domain should be 1 parameter");
+
+    auto it = this->domain_ids.find(domain[0]);
+    return it != this->domain_ids.end() ? it->second : NO_DOMAIN;
 }
 
 /***********************************************************************************************
- ***                                Role::AddRole                                            ***
+ ***                                DefaultRoleManager::CreateDomain                         ***
  ***********************************************************************************************
- * DESCRIPTION: Adds a Role to Role::all_roles, in other words, a parent Role is added to      *
- *              the current Role inheritance tree. A Role Tree like:                           *
- *                                      admin                                                  *
- *                                     /     \                                                 *
- *                                  group1 group2                                              *
- *                                   /   \ /   \                                               *
- *                                Alice  Bob Charlse                                           *
+ * DESCRIPTION: Interns a domain, creating an empty RoleGraph for it if the domain is new.     *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   role -- A weak_ptr<Role>, which is to avoid self-referencing smart pointer in Role.*
+ * INPUT:   domain -- Empty, or the name of the domain.                                        *
  *                                                                                             *
- * OUTPUT:   NONE                                                                              *
+ * OUTPUT:   Returns the id of the RoleGraph of the domain.                                    *
  *                                                                                             *
- * WARNINGS:    Better to check if INPUT's raw pointer is not nullptr or released.             *
+ * WARNINGS:    Size of domain should not exceed over 1, otherwise, an exception will be       *
+ *              thrown                                                                         *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
  *=============================================================================================*/
-void Role::AddRole(WRptr role) {
-    SRptr sr_ptr1, sr_ptr2;
-
-    try{
-        sr_ptr1 = role.lock();
-    }
-    catch(std::bad_weak_ptr bwp) {
-        throw WeakPtrException("Added Role has been expired!");
-    }
-
-    for(const auto& it : this->roles) {
-        try{
-            sr_ptr2 = it.lock();
-        }
-        catch(std::bad_weak_ptr bwp) {
-            throw WeakPtrException("There exits expired role in role tree.");
-        }
-        if(!(sr_ptr1->name).compare(sr_ptr2->name))
-            return;
-    }
-
-    this->roles.push_back(role);
+domain_t DefaultRoleManager::CreateDomain(const std::vector<std::string>& domain) {
+    domain_t id = FindDomain(domain);
+    if(id != NO_DOMAIN)
+        return id;
+
+    id = domain_t(this->graphs.size());
+    this->domain_ids[domain[0]] = id;
+    this->domain_names.push_back(domain[0]);
+    this->graphs.emplace_back();
+    return id;
 }
 
 /***********************************************************************************************
- ***                                Role::DeleteRole                                         ***
+ ***                                DefaultRoleManager::FindRole                             ***
  ***********************************************************************************************
- * DESCRIPTION: Deletes a Role from Role::all_roles, in other words, a parent Role is delete   *
- *              from the current Role inheritance tree.                                        *
+ * DESCRIPTION: Looks up the id of a Role by its name.                                         *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   role -- A weak_ptr<Role>, which is to avoid self-referencing smart pointer in Role.*
+ * INPUT:   graph -- RoleGraph of the domain the Roles belong to.                              *
  *                                                                                             *
- * OUTPUT:   NONE                                                                              *
+ *          name -- Name of the Role to search for.                                            *
+ *                                                                                             *
+ * OUTPUT:   Returns the id of the Role, or NO_ROLE if there is no such Role.                  *
  *                                                                                             *
- * WARNINGS:    Better to check if INPUT's raw pointer is not nullptr or released.             *
+ * WARNINGS:    NONE                                                                           *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
  *=============================================================================================*/
-void Role::DeleteRole(WRptr role) {
-    SRptr sr_ptr1, sr_ptr2;
-
-    try{
-        sr_ptr1 = role.lock();
-    }
-    catch(std::bad_weak_ptr bwp) {
-        throw WeakPtrException("Deleted Role has been expired!");
-    }
-
-    for(auto it = this->roles.begin(); it != this->roles.end();) {
-        try{
-            sr_ptr2 = it->lock();
-        }
-        catch(std::bad_weak_ptr bwp) {
-            throw WeakPtrException("There exits expired role in role tree.");
-        }
-        if(!(sr_ptr1->name).compare(sr_ptr2->name)) {
-            this->roles.erase(it);
-            --it;
-        }
-        ++it;
-    }
-    return;
+role_t DefaultRoleManager::FindRole(const RoleGraph& graph, const std::string& name) const {
+    auto it = graph.role_ids.find(name);
+    return it != graph.role_ids.end() ? it->second : NO_ROLE;
 }
 
 /***********************************************************************************************
- ***                                Role::HasRole                                            ***
+ ***                                DefaultRoleManager::PatternRoles                         ***
  ***********************************************************************************************
- * DESCRIPTION: Determines if current Role has a specified parent Role. Moreover,              *
- *              this function will search for the Role recursively. That is to say, not only   *
- *              it searches for its parent Role, but also its parent Role's parent Role,       *
- *              and so on, for each of the Roles.                                              *
+ * DESCRIPTION: Returns the Roles whose names match a name through the matching function, such *
+ *              as the Role "data_group_*" for the name "data_group_1". Such Roles are parents *
+ *              of the name although no link was added between them. Only the pattern Roles of *
+ *              the RoleGraph are tried, and the result is cached for the name until a pattern *
+ *              Role is created or the matching function changes.                              *
+ *                                                                                             *
  *                                                                                             *
+ * INPUT:   graph -- RoleGraph of the domain the Roles belong to.                              *
  *                                                                                             *
- * INPUT:   name -- The Role to search for.                                                    *
- *          hierarchy_level -- Maximum search depth.                                           *
+ *          name -- Name of the Role to match.                                                 *
  *                                                                                             *
- * OUTPUT:   Returns true if the specified Role is found, else returns false.                  *
+ * OUTPUT:   Returns the ids of the matching Roles, the Role named name itself excluded.       *
  *                                                                                             *
- * WARNINGS:    If hierarchy_level <= 0, HasRole won't search for the Role.                    *
+ * WARNINGS:    Returns nothing if there is no matching function. Safe to call from several    *
+ *              readers at once, the cache is guarded by pattern_lock.                         *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Tries the pattern Roles only and caches the matches.                  *
  *=============================================================================================*/
-bool Role::HasRole(std::string name, int hierarchy_level) {
-    if(!this->name.compare(name))
-        return true;
+std::vector<role_t> DefaultRoleManager::PatternRoles(const RoleGraph& graph, const std::string& name) const {
+    std::vector<role_t> roles;
+    if(!this->has_pattern)
+        return roles;
 
-    if(hierarchy_level <= 0)
-        return false;
+    {
+        ReadLockGuard guard(this->pattern_lock);
+        auto it = graph.pattern_matches.find(name);
+        if(it != graph.pattern_matches.end())
+            return it->second;
+    }
 
-    SRptr sr_ptr;
-    for(const auto& r : roles) {
-        try{
-            sr_ptr = r.lock();
-        }
-        catch(std::bad_weak_ptr bwp) {
-            throw WeakPtrException("There exits expired role in role tree.");
-        }
-        if(sr_ptr->HasRole(name, --hierarchy_level))
-            return true;
+    for(role_t role : graph.pattern_roles) {
+        if(name != graph.role_names[role] && this->mf(name, graph.role_names[role]))
+            roles.push_back(role);
     }
-    return false;
+
+    // Names come from requests too, the cache is dropped rather than grown without bound.
+    WriteLockGuard guard(this->pattern_lock);
+    if(graph.pattern_matches.size() >= MAX_PATTERN_MATCHES)
+        graph.pattern_matches.clear();
+    graph.pattern_matches.emplace(name, roles);
+    return roles;
 }
 
 /***********************************************************************************************
- ***                                Role::HasDirectRole                                      ***
+ ***                                DefaultRoleManager::IsPattern                            ***
  ***********************************************************************************************
- * DESCRIPTION: Determines if current Role has a specified parent Role, but it only            *
- *              searches for adjacent parent Roles.                                            *
+ * DESCRIPTION: Determines if a name is a pattern that the matching function may match other   *
+ *              names to.                                                                      *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   name -- The Role to search for.                                                    *
+ * INPUT:   name -- Name of the Role.                                                          *
  *                                                                                             *
- * OUTPUT:   Returns true if the specified Role is found, else returns false.                  *
+ * OUTPUT:   Returns the result of the pattern function, or true if no pattern function was    *
+ *           given, in which case every Role is tried as a pattern.                            *
  *                                                                                             *
  * WARNINGS:    NONE                                                                           *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
  *=============================================================================================*/
-bool Role::HasDirectRole(std::string name) {
-    SRptr sr_ptr;
-    for(const auto& r : roles) {
-        try{
-            sr_ptr = r.lock();
-        }
-        catch(std::bad_weak_ptr bwp) {
-            throw WeakPtrException("There exits expired role in role tree.");
-        }
-        if(!(sr_ptr->name).compare(name))
-            return true;
-        return false;
-    }
+bool DefaultRoleManager::IsPattern(const std::string& name) const {
+    return this->is_pattern == nullptr || this->is_pattern(name);
 }
 
 /***********************************************************************************************
- ***                                Role::ToString                                           ***
+ ***                                DefaultRoleManager::HasRole                              ***
  ***********************************************************************************************
- * DESCRIPTION: Returns all Roles' name as a string.                                           *
+ * DESCRIPTION: Determines if there is a specified Role in RoleManager. Moreover, you can also *
+ *              search for the Role using the specified matching function.                     *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   NONE                                                                               *
+ * INPUT:   graph -- RoleGraph of the domain the Roles belong to.                              *
  *                                                                                             *
- * OUTPUT:   Formatted string.                                                                 *
+ *          name -- Name of the Role to search for.                                            *
+ *                                                                                             *
+ * OUTPUT:   Returns true if the Role is found, else returns false.                            *
  *                                                                                             *
  * WARNINGS:    NONE                                                                           *
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
  *=============================================================================================*/
-std::string Role::ToString() {
-    if(this->roles.size() == 0)
-        return name;
-
-    std::string names = "";
-    if(this->roles.size() != 1) 
-        names +=  "(";
-
-    SRptr sr_ptr;
-    for(size_t i = 0; i < roles.size(); ++i) {
-        auto r = roles[i];
-        try{
-            sr_ptr = r.lock();
-        }
-        catch(std::bad_weak_ptr bwp) {
-            throw WeakPtrException("There exits expired role in role tree.");
-        }
-        if(i == 0)
-            names += sr_ptr->name;
-        else
-            names += ", " + sr_ptr->name;
-    }
-
-    if(this->roles.size() != 1)
-        names += ")";
-
-    return name + " < " + names;
+bool DefaultRoleManager::HasRole(const RoleGraph& graph, const std::string& name) const {
+    return FindRole(graph, name) != NO_ROLE || !PatternRoles(graph, name).empty();
 }
 
 /***********************************************************************************************
- ***                                Role::GetRoles                                           ***
+ ***                                DefaultRoleManager::CreateRole                           ***
  ***********************************************************************************************
- * DESCRIPTION: Returns all Roles' name as an array.                                           *
+ * DESCRIPTION: Creates a new Role in RoleManager if the specified Role is not in RoleManager. *
+ *              Or, if there is a specified Role in RoleManager, the existed Role would be     *
+ *              returned. Moreover, if matching function is specified in RoleManager, all      *
+ *              Roles that meet matching function would be linked as parents of the new Role   *
+ *              or the existed Role.                                                           *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   NONE                                                                               *
+ * INPUT:   graph -- RoleGraph of the domain the Roles belong to.                              *
+ *                                                                                             *
+ *          name -- Name of the Role to create or return.                                      *
  *                                                                                             *
- * OUTPUT:   A vector<string>, which stores all Roles' name.                                   *
+ * OUTPUT:   Returns the id of the new Role or the existed Role.                               *
  *                                                                                             *
  * WARNINGS:    NONE                                                                           *
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
+ *     10/17/2026 ARZR : Keeps the pattern Roles of the RoleGraph.                             *
  *=============================================================================================*/
-std::vector<std::string> Role::GetRoles() {
-    std::vector<std::string> names;
-    SRptr sr_ptr;
-    for(const auto& r : roles) {
-        try{
-            auto sr_ptr = r.lock();
-        }
-        catch(std::bad_weak_ptr bwp) {
-            throw WeakPtrException("There exits expired role in role tree.");
+role_t DefaultRoleManager::CreateRole(RoleGraph& graph, const std::string& name) {
+    role_t role = FindRole(graph, name);
+    if(role == NO_ROLE) {
+        role = role_t(graph.role_names.size());
+        graph.role_ids[name] = role;
+        graph.role_names.push_back(name);
+        graph.parents.emplace_back();
+        graph.ancestors.emplace_back();
+        graph.descendants.emplace_back();
+        graph.children.emplace_back();
+        if(this->has_pattern && IsPattern(name)) {
+            graph.pattern_roles.push_back(role);
+            graph.pattern_matches.clear();
         }
-        names.push_back(sr_ptr->name);
     }
-    return names;
+
+    for(role_t pattern_role : PatternRoles(graph, name))
+        AddEdge(graph, role, pattern_role);
+    return role;
 }
 
 /***********************************************************************************************
- ***                            DefaultRoleManager::HasRole                                  ***
+ ***                                DefaultRoleManager::AddEdge                              ***
  ***********************************************************************************************
- * DESCRIPTION: Determines if there is a specified Role in RoleManager. Moreover, you can      *
- *              also search for the Role using the specified matching function.                *
+ * DESCRIPTION: Adds a Role to the direct parents of another Role and extends the reachability *
+ *              index by the paths through the new link: every descendant of the child, the    *
+ *              child included, now reaches every ancestor of the parent, the parent included, *
+ *              if the path is no longer than max_hierarchy_level.                             *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   name -- Name of the Role to search for.                                            *
+ * INPUT:   graph -- RoleGraph of the domain the Roles belong to.                              *
  *                                                                                             *
- * OUTPUT:   Returns true if the Role is found, else returns false.                            *
+ *          child -- Id of the child Role.                                                     *
  *                                                                                             *
- * WARNINGS:    NONE                                                                           *
+ *          parent -- Id of the parent Role.                                                   *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Costs O(descendants of child * ancestors of parent).                           *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
  *=============================================================================================*/
-bool DefaultRoleManager::HasRole(std::string name) {
-    bool ok = false;
-    if(this->has_pattern) {
-        for(const auto& r : all_roles) {
-            if(this->mf(name, r.first))
-                ok = true;
+void DefaultRoleManager::AddEdge(RoleGraph& graph, role_t child, role_t parent) {
+    auto& direct = graph.parents[child];
+    if(std::find(direct.begin(), direct.end(), parent) != direct.end())
+        return;
+    direct.push_back(parent);
+    graph.children[parent].push_back(child);
+
+    // Copied first, a cycle makes the loops below write to the maps they would iterate.
+    std::vector<std::pair<role_t, int>> lower(graph.descendants[child].begin(), graph.descendants[child].end());
+    lower.emplace_back(child, 0);
+    std::vector<std::pair<role_t, int>> upper(graph.ancestors[parent].begin(), graph.ancestors[parent].end());
+    upper.emplace_back(parent, 0);
+
+    for(const auto& low : lower) {
+        for(const auto& up : upper) {
+            int hops = low.second + 1 + up.second;
+            if(low.first == up.first || hops > this->max_hierarchy_level)
+                continue;
+            auto it = graph.ancestors[low.first].find(up.first);
+            if(it == graph.ancestors[low.first].end() || it->second > hops) {
+                graph.ancestors[low.first][up.first] = hops;
+                graph.descendants[up.first][low.first] = hops;
+            }
         }
     }
-    ok = ok || this->all_roles.find(name) != this->all_roles.end();
-
-    return ok;
 }
 
 /***********************************************************************************************
- ***                            DefaultRoleManager::CreateRole                               ***
+ ***                                DefaultRoleManager::DeleteEdge                           ***
  ***********************************************************************************************
- * DESCRIPTION: Creates a new Role in RoleManager if the specified Role is not in RoleManager. *
- *              Or, if there is a specified Role in RoleManager, the existed Role would be     *
- *              returned. Moreover, if matching function is specified in RoleManager, it would *
- *              be applied to searching for the all Roles in RoleManager. All Roles that meet  *
- *              matching function would be added to Role Tree of the new Role or the existed   *
- *              Role.                                                                          *
+ * DESCRIPTION: Removes a Role from the direct parents of another Role. Only the child and its *
+ *              descendants may have lost a path, their ancestors are searched again breadth   *
+ *              first over the direct parents, the rest of the reachability index stays as it  *
+ *              is.                                                                            *
  *                                                                                             *
  *                                                                                             *
- * INPUT:   name -- Name of the Role to create or return.                                      *
+ * INPUT:   graph -- RoleGraph of the domain the Roles belong to.                              *
  *                                                                                             *
- * OUTPUT:   Returns a new Role or existed Role.                                               *
+ *          child -- Id of the child Role.                                                     *
  *                                                                                             *
- * WARNINGS:    NONE                                                                           *
+ *          parent -- Id of the parent Role.                                                   *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Costs O(descendants of child * links within max_hierarchy_level of them).      *
  *                                                                                             *
  * HISTORY:                                                                                    *
- *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Created.                                                              *
  *=============================================================================================*/
-SRptr DefaultRoleManager::CreateRole(std::string name) {
-    SRptr role;
-    bool found = all_roles.find(name) != all_roles.end();
-    if(!found) {
-        all_roles[name] = Role::NewRole(name);
-        role = all_roles[name];
+void DefaultRoleManager::DeleteEdge(RoleGraph& graph, role_t child, role_t parent) {
+    auto& direct = graph.parents[child];
+    auto it = std::find(direct.begin(), direct.end(), parent);
+    if(it == direct.end())
+        return;
+    direct.erase(it);
+    auto& members = graph.children[parent];
+    members.erase(std::find(members.begin(), members.end(), child));
+
+    std::vector<role_t> affected{child};
+    for(const auto& low : graph.descendants[child])
+        affected.push_back(low.first);
+
+    for(role_t role : affected) {
+        for(const auto& up : graph.ancestors[role])
+            graph.descendants[up.first].erase(role);
+        graph.ancestors[role].clear();
     }
-    else 
-        role = all_roles[name];
-
-    if(this->has_pattern) {
-        for(const auto& r : all_roles) {
-            if(this->mf(name, r.first) && name != r.first) {
-                SRptr role1;
-                bool found1 = this->all_roles.find(r.first) != this->all_roles.end();
-                if(!found1) {
-                    all_roles[r.first] = Role::NewRole(r.first);
-                    role1 = all_roles[r.first];
+
+    std::vector<role_t> frontier, next;
+    for(role_t role : affected) {
+        auto& reach = graph.ancestors[role];
+        frontier.assign(1, role);
+        for(int hops = 1; hops <= this->max_hierarchy_level && !frontier.empty(); ++hops) {
+            next.clear();
+            for(role_t from : frontier) {
+                for(role_t to : graph.parents[from]) {
+                    if(to != role && reach.emplace(to, hops).second)
+                        next.push_back(to);
                 }
-                else 
-                    role1 = all_roles[r.first];
-                role->AddRole(role1);
             }
+            frontier.swap(next);
         }
+        for(const auto& up : reach)
+            graph.descendants[up.first][role] = up.second;
     }
-    return role;
 }
 
 /***********************************************************************************************
@@ -390,30 +394,50 @@ SRptr DefaultRoleManager::CreateRole(std::string name) {
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Creates the RoleGraph of Roles without a domain.                      *
  *=============================================================================================*/
 DefaultRoleManager::DefaultRoleManager(int max_hierarchy_level) {
     this->max_hierarchy_level = max_hierarchy_level;
     this->has_pattern = false;
+    this->mf = nullptr;
+    this->is_pattern = nullptr;
+    this->graphs.emplace_back();
 }
 
 /***********************************************************************************************
- ***                        DefaultRoleManager::AddMatchingFunc                              ***
+ ***                                DefaultRoleManager::AddMatchingFunc                      ***
  ***********************************************************************************************
- * DESCRIPTION: Adds specified matching function to the RoleManager.                           *
+ * DESCRIPTION: Adds specified matching function to the RoleManager. The pattern Roles of      *
+ *              every RoleGraph are collected again and the cached matches are dropped.        *
  *                                                                                             *
  *                                                                                             *
  * INPUT:   mf -- The matching function, which is used to match two Roles.                     *
  *                                                                                             *
+ *          is_pattern -- Determines which Roles are patterns, such as the names that contain  *
+ *          "*". Only those Roles are passed to the matching function. If it is nullptr, every *
+ *          Role is.                                                                           *
+ *                                                                                             *
  * OUTPUT:   NONE                                                                              *
  *                                                                                             *
  * WARNINGS:    NONE                                                                           *
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Takes the pattern function and collects the pattern Roles.            *
  *=============================================================================================*/
-void DefaultRoleManager::AddMatchingFunc(MatchingFunc mf) {
+void DefaultRoleManager::AddMatchingFunc(MatchingFunc mf, PatternFunc is_pattern) {
     this->has_pattern = true;
     this->mf = mf;
+    this->is_pattern = is_pattern;
+
+    for(auto& graph : this->graphs) {
+        graph.pattern_roles.clear();
+        graph.pattern_matches.clear();
+        for(role_t role = 0; role < graph.role_names.size(); ++role) {
+            if(IsPattern(graph.role_names[role]))
+                graph.pattern_roles.push_back(role);
+        }
+    }
 }
 
 /***********************************************************************************************
@@ -433,9 +457,60 @@ void DefaultRoleManager::AddMatchingFunc(MatchingFunc mf) {
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Drops the RoleGraphs of all domains.                                  *
  *=============================================================================================*/
 void DefaultRoleManager::Clear() {
-    std::unordered_map<std::string, SRptr>().swap(this->all_roles);
+    std::unordered_map<std::string, domain_t>().swap(this->domain_ids);
+    std::vector<std::string>().swap(this->domain_names);
+    std::vector<RoleGraph>().swap(this->graphs);
+    this->graphs.emplace_back();
+}
+
+/***********************************************************************************************
+ ***                                DefaultRoleManager::ClearDomain                          ***
+ ***********************************************************************************************
+ * DESCRIPTION: Deletes all inheritance links and Roles of a domain. The RoleGraphs of the     *
+ *              other domains are not touched.                                                 *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   domain -- Name of the domain.                                                      *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    Costs O(Roles and links in the domain). The domain stays interned, its         *
+ *              RoleGraph is empty.                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void DefaultRoleManager::ClearDomain(const std::string& domain) {
+    domain_t id = FindDomain({domain});
+    if(id != NO_DOMAIN)
+        RoleGraph().Swap(this->graphs[id]);
+}
+
+/***********************************************************************************************
+ ***                                DefaultRoleManager::NewEmpty                             ***
+ ***********************************************************************************************
+ * DESCRIPTION: Creates a DefaultRoleManager with the max_hierarchy_level and the matching     *
+ *              function of current RoleManager, but without any Role.                         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   Returns the new RoleManager.                                                      *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::shared_ptr<RoleManager> DefaultRoleManager::NewEmpty() {
+    auto rm = std::make_shared<DefaultRoleManager>(this->max_hierarchy_level);
+    if(this->has_pattern)
+        rm->AddMatchingFunc(this->mf, this->is_pattern);
+    return rm;
 }
 
 /***********************************************************************************************
@@ -456,17 +531,14 @@ void DefaultRoleManager::Clear() {
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
  *=============================================================================================*/
 void DefaultRoleManager::AddLink(std::string name1, std::string name2, std::vector<std::string> domain) {
-    if(domain.size() == 1) {
-        name1 = domain[0] + "::" + name1;
-        name2 = domain[0] + "::" + name2;
-    } else if(domain.size() > 1)
-        throw CaepRbacException("error: domain should be 1 parameter");
-
-    auto role1 = this->CreateRole(name1);
-    auto role2 = this->CreateRole(name2);
-    role1->AddRole(role2);
+    RoleGraph& graph = this->graphs[CreateDomain(domain)];
+    role_t role1 = this->CreateRole(graph, name1);
+    role_t role2 = this->CreateRole(graph, name2);
+    this->AddEdge(graph, role1, role2);
 }
 
 /***********************************************************************************************
@@ -488,27 +560,26 @@ void DefaultRoleManager::AddLink(std::string name1, std::string name2, std::vect
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
  *=============================================================================================*/
 void DefaultRoleManager::DeleteLink(std::string name1, std::string name2, std::vector<std::string> domain) {
-    if(domain.size() == 1) {
-        name1 = domain[0] + "::" + name1;
-        name2 = domain[0] + "::" + name2;
-    } else if(domain.size() > 1)
-        throw CaepRbacException("error: domain should be 1 parameter");
-
-    if(!HasRole(name1) || !HasRole(name2))
+    domain_t id = FindDomain(domain);
+    if(id == NO_DOMAIN || !HasRole(this->graphs[id], name1) || !HasRole(this->graphs[id], name2))
         throw CaepRbacException("error: name1 or name2 does not exist");
 
-    auto role1 = this->CreateRole(name1);
-    auto role2 = this->CreateRole(name2);
-    role1->DeleteRole(role2);
+    RoleGraph& graph = this->graphs[id];
+    role_t role1 = this->CreateRole(graph, name1);
+    role_t role2 = this->CreateRole(graph, name2);
+    this->DeleteEdge(graph, role1, role2);
 }
 
 /***********************************************************************************************
  ***                        DefaultRoleManager::HasLink                                      ***
  ***********************************************************************************************
- * DESCRIPTION: Determines if there is an inhieritance link between two Roles.                 *
- *                                                                                             *
+ * DESCRIPTION: Determines if there is an inhieritance link between two Roles. The             *
+ *              reachability index answers it in a single lookup, only a name that matches     *
+ *              Roles through the matching function has to try them.                           *
  *                                                                                             *
  *                                                                                             *
  * INPUT:   name1 -- Child Role's name.                                                        *
@@ -521,21 +592,35 @@ void DefaultRoleManager::DeleteLink(std::string name1, std::string name2, std::v
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Leaves the role tree unchanged, it is safe under a read lock.         *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
  *=============================================================================================*/
 bool DefaultRoleManager::HasLink(std::string name1, std::string name2, std::vector<std::string> domain) {
-    if(domain.size() == 1) {
-        name1 = domain[0] + "::" + name1;
-        name2 = domain[0] + "::" + name2;
-    } else if(domain.size() > 1)
-        throw CaepRbacException("error: domain should be 1 parameter");
-
+    domain_t id = FindDomain(domain);
     if(!name1.compare(name2))
         return true;
-    if(!HasRole(name1) || !HasRole(name2))
+    if(id == NO_DOMAIN)
         return false;
+    const RoleGraph& graph = this->graphs[id];
 
-    auto role1 = this->CreateRole(name1);
-    return role1->HasRole(name2, max_hierarchy_level);
+    role_t role2 = FindRole(graph, name2);
+    if(role2 == NO_ROLE)
+        return false;
+
+    role_t role1 = FindRole(graph, name1);
+    if(role1 != NO_ROLE && graph.ancestors[role1].count(role2))
+        return true;
+
+    // Roles matched by a pattern are parents of name1, one link away.
+    for(role_t pattern_role : PatternRoles(graph, name1)) {
+        if(pattern_role == role2 && this->max_hierarchy_level >= 1)
+            return true;
+        auto it = graph.ancestors[pattern_role].find(role2);
+        if(it != graph.ancestors[pattern_role].end() && it->second + 1 <= this->max_hierarchy_level)
+            return true;
+    }
+    return false;
 }
 
 /***********************************************************************************************
@@ -554,26 +639,27 @@ bool DefaultRoleManager::HasLink(std::string name1, std::string name2, std::vect
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
  *=============================================================================================*/
 std::vector<std::string> DefaultRoleManager::GetRoles(std::string name, std::vector<std::string> domain) {
-    int domain_length = int(domain.size());
-    if(domain_length == 1)
-        name = domain[0] + "::" + name;
-    else if(domain_length > 1)
-        throw CaepRbacException("error: domain should be 1 parameter");
-
-    if(!HasRole(name)) {
-        std::vector<std::string> roles;
+    std::vector<std::string> roles;
+    domain_t id = FindDomain(domain);
+    if(id == NO_DOMAIN)
         return roles;
+    const RoleGraph& graph = this->graphs[id];
+
+    role_t role = FindRole(graph, name);
+    std::vector<role_t> ids;
+    if(role != NO_ROLE)
+        ids = graph.parents[role];
+    for(role_t pattern_role : PatternRoles(graph, name)) {
+        if(std::find(ids.begin(), ids.end(), pattern_role) == ids.end())
+            ids.push_back(pattern_role);
     }
 
-    auto roles = this->CreateRole(name)->GetRoles();
-    if(domain_length == 1) {
-        for(auto& role : roles) {
-            role = role.substr(domain[0].length() + 2, role.length() - domain[0].length() - 2);
-        }
-    }
-
+    for(role_t id : ids)
+        roles.push_back(graph.role_names[id]);
     return roles;
 }
 
@@ -593,32 +679,116 @@ std::vector<std::string> DefaultRoleManager::GetRoles(std::string name, std::vec
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Works on the RoleGraph of the domain.                                 *
+ *     10/17/2026 ARZR : Reads the direct members from the reverse links.                      *
  *=============================================================================================*/
 std::vector<std::string> DefaultRoleManager::GetUsers(std::string name, std::vector<std::string> domain) {
-    int domain_length = int(domain.size());
-    if(domain_length == 1)
-        name = domain[0] + "::" + name;
-    else if(domain_length > 1)
-        throw CaepRbacException("error: domain should be 1 parameter");
-
-    if(!HasRole(name))
+    domain_t id = FindDomain(domain);
+    if(id == NO_DOMAIN || !HasRole(this->graphs[id], name))
         throw CaepRbacException("error: name does not exist");
+    const RoleGraph& graph = this->graphs[id];
 
     std::vector<std::string> names;
-    for(const auto& it : all_roles) {
-        auto role = it.second;
-        if(role->HasDirectRole(name))
-            names.push_back(it.first);
-    }
+    role_t role = FindRole(graph, name);
+    if(role == NO_ROLE)
+        return names;
 
-    if(domain_length == 1) {
-        for(auto& name : names) {
-            name = name.substr(domain[0].length() + 2, name.length() - domain[0].length() - 2);
-        }
-    }
+    names.reserve(graph.children[role].size());
+    for(role_t user : graph.children[role])
+        names.push_back(graph.role_names[user]);
+    return names;
+}
+
+/***********************************************************************************************
+ ***                                DefaultRoleManager::GetImplicitUsers                     ***
+ ***********************************************************************************************
+ * DESCRIPTION: Gets all Users that inherit a Role directly or through other Roles, within     *
+ *              max_hierarchy_level links. They are read from the reachability index, nearest  *
+ *              Users first.                                                                   *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   name -- Name of the Role.                                                          *
+ *                                                                                             *
+ *          domain -- Describes the domain in which Role is located.                           *
+ *                                                                                             *
+ * OUTPUT:   Returns the names of the Users, empty if the Role does not exist.                 *
+ *                                                                                             *
+ * WARNINGS:    Costs O(k log k) for k Users, no matter how many Roles there are.              *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+std::vector<std::string> DefaultRoleManager::GetImplicitUsers(std::string name, std::vector<std::string> domain) {
+    std::vector<std::string> names;
+    domain_t id = FindDomain(domain);
+    if(id == NO_DOMAIN)
+        return names;
+    const RoleGraph& graph = this->graphs[id];
+    role_t role = FindRole(graph, name);
+    if(role == NO_ROLE)
+        return names;
+
+    std::vector<std::pair<int, role_t>> users;
+    users.reserve(graph.descendants[role].size());
+    for(const auto& low : graph.descendants[role])
+        users.emplace_back(low.second, low.first);
+    std::sort(users.begin(), users.end());
+
+    names.reserve(users.size());
+    for(const auto& user : users)
+        names.push_back(graph.role_names[user.second]);
     return names;
 }
 
+/***********************************************************************************************
+ ***                                DefaultRoleManager::HasUsers                             ***
+ ***********************************************************************************************
+ * DESCRIPTION: Determines if a Role has direct Users, which means the name is a Role that     *
+ *              others inherit. It reads the reverse links only.                               *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   name -- Name of the Role.                                                          *
+ *                                                                                             *
+ *          domain -- Describes the domain in which Role is located.                           *
+ *                                                                                             *
+ * OUTPUT:   Returns true if some User inherits the Role directly, false if not or the Role    *
+ *           does not exist.                                                                   *
+ *                                                                                             *
+ * WARNINGS:    Costs O(1), unlike GetUsers it builds no names.                                *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool DefaultRoleManager::HasUsers(std::string name, std::vector<std::string> domain) {
+    domain_t id = FindDomain(domain);
+    if(id == NO_DOMAIN)
+        return false;
+    const RoleGraph& graph = this->graphs[id];
+    role_t role = FindRole(graph, name);
+    return role != NO_ROLE && !graph.children[role].empty();
+}
+
+/***********************************************************************************************
+ ***                                DefaultRoleManager::HasMatchingFunc                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Determines if a matching function was added by AddMatchingFunc. Roles may then *
+ *              match names they are not linked to.                                            *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   NONE                                                                               *
+ *                                                                                             *
+ * OUTPUT:   Returns true if a matching function was added.                                    *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool DefaultRoleManager::HasMatchingFunc() const {
+    return this->has_pattern;
+}
+
 /***********************************************************************************************
  ***                        DefaultRoleManager::PrintRoles                                   ***
  ***********************************************************************************************
@@ -634,14 +804,187 @@ std::vector<std::string> DefaultRoleManager::GetUsers(std::string name, std::vec
  *                                                                                             *
  * HISTORY:                                                                                    *
  *     08/22/2019 ARZR : Created.                                                              *
+ *     10/17/2026 ARZR : Works on role ids and the reachability index.                         *
+ *     10/17/2026 ARZR : Prints the Roles of a domain as domain::name.                         *
  *=============================================================================================*/
 void DefaultRoleManager::PrintRoles() {
     std::string text;
-    for(auto it = this->all_roles.begin(); it != this->all_roles.end(); ++it)
-        text += it->second->ToString() + ";\n";
+    for(domain_t id = 0; id < this->graphs.size(); ++id) {
+        const RoleGraph& graph = this->graphs[id];
+        std::string prefix = id == 0 ? "" : this->domain_names[id - 1] + "::";
+        for(role_t role = 0; role < graph.role_names.size(); ++role) {
+            text += prefix + graph.role_names[role];
+            const auto& direct = graph.parents[role];
+            if(!direct.empty()) {
+                text += " < ";
+                if(direct.size() != 1)
+                    text += "(";
+                for(size_t i = 0; i < direct.size(); ++i)
+                    text += (i == 0 ? "" : ", ") + prefix + graph.role_names[direct[i]];
+                if(direct.size() != 1)
+                    text += ")";
+            }
+            text += ";\n";
+        }
+    }
     std::cout << text << std::endl;
 }
 
+/***********************************************************************************************
+ ***                                DefaultRoleManager::SaveGraphs                           ***
+ ***********************************************************************************************
+ * DESCRIPTION: Writes the RoleGraphs of all domains: the names of their Roles, the direct     *
+ *              parents and the reachability index, so that LoadGraphs restores them without   *
+ *              replaying a single link. children and descendants are the reverse of parents   *
+ *              and ancestors and are not written.                                             *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   out -- The writer the RoleGraphs are appended to.                                  *
+ *                                                                                             *
+ * OUTPUT:   Returns false and writes nothing if a matching function was added, the links it   *
+ *           made depend on a function that can not be written.                                *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool DefaultRoleManager::SaveGraphs(SnapshotWriter& out) const {
+    if(this->has_pattern)
+        return false;
+
+    out.Put(int32_t(this->max_hierarchy_level));
+    out.Put(uint32_t(this->graphs.size()));
+    for(domain_t id = 0; id < this->graphs.size(); ++id) {
+        const RoleGraph& graph = this->graphs[id];
+        out.PutString(id == 0 ? std::string() : this->domain_names[id - 1]);
+        out.Put(uint32_t(graph.role_names.size()));
+        for(const auto& name : graph.role_names)
+            out.PutString(name);
+        for(role_t role = 0; role < graph.role_names.size(); ++role) {
+            out.Put(uint32_t(graph.parents[role].size()));
+            out.PutBytes(graph.parents[role].data(), graph.parents[role].size() * sizeof(role_t));
+            out.Put(uint32_t(graph.ancestors[role].size()));
+            for(const auto& up : graph.ancestors[role]) {
+                out.Put(up.first);
+                out.Put(int32_t(up.second));
+            }
+        }
+    }
+    return true;
+}
+
+/***********************************************************************************************
+ ***                                DefaultRoleManager::LoadGraphs                           ***
+ ***********************************************************************************************
+ * DESCRIPTION: Replaces all Roles of current RoleManager by the RoleGraphs that SaveGraphs    *
+ *              wrote. The links and the reachability index are read as they are, no link is   *
+ *              added through AddEdge.                                                         *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   in -- The reader positioned where SaveGraphs started writing.                      *
+ *                                                                                             *
+ * OUTPUT:   Returns false and leaves current RoleManager untouched if it has a matching       *
+ *           function or another max_hierarchy_level than the written one, the Roles should be *
+ *           linked again then.                                                                *
+ *                                                                                             *
+ * WARNINGS:    Throws IOException if the data is truncated or refers to a Role that does not  *
+ *              exist.                                                                         *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+bool DefaultRoleManager::LoadGraphs(SnapshotReader& in) {
+    int32_t level = in.Get<int32_t>();
+    if(this->has_pattern || level != this->max_hierarchy_level)
+        return false;
+
+    uint32_t graph_count = in.Get<uint32_t>();
+    if(graph_count == 0)
+        throw IOException("corrupted snapshot: no role graph");
+
+    std::unordered_map<std::string, domain_t> ids;
+    std::vector<std::string> names;
+    std::vector<RoleGraph> loaded(graph_count);
+    for(domain_t id = 0; id < graph_count; ++id) {
+        std::string_view domain = in.GetString();
+        if(id > 0) {
+            ids.emplace(std::string(domain), id);
+            names.emplace_back(domain);
+        }
+
+        RoleGraph& graph = loaded[id];
+        uint32_t role_count = in.Get<uint32_t>();
+        graph.role_names.reserve(role_count);
+        graph.role_ids.reserve(role_count);
+        for(role_t role = 0; role < role_count; ++role) {
+            graph.role_names.emplace_back(in.GetString());
+            graph.role_ids.emplace(graph.role_names.back(), role);
+        }
+
+        graph.parents.resize(role_count);
+        graph.ancestors.resize(role_count);
+        graph.descendants.resize(role_count);
+        graph.children.resize(role_count);
+        for(role_t role = 0; role < role_count; ++role) {
+            auto& parents = graph.parents[role];
+            parents.resize(in.Get<uint32_t>());
+            std::string_view bytes = in.GetBytes(parents.size() * sizeof(role_t));
+            std::memcpy(parents.data(), bytes.data(), bytes.size());
+
+            uint32_t ancestor_count = in.Get<uint32_t>();
+            graph.ancestors[role].reserve(ancestor_count);
+            for(uint32_t i = 0; i < ancestor_count; ++i) {
+                role_t up = in.Get<role_t>();
+                int hops = in.Get<int32_t>();
+                if(up >= role_count)
+                    throw IOException("corrupted snapshot: unknown role");
+                graph.ancestors[role].emplace(up, hops);
+                graph.descendants[up].emplace(role, hops);
+            }
+        }
+
+        for(role_t role = 0; role < role_count; ++role) {
+            for(role_t parent : graph.parents[role]) {
+                if(parent >= role_count)
+                    throw IOException("corrupted snapshot: unknown role");
+                graph.children[parent].push_back(role);
+            }
+        }
+    }
+
+    this->domain_ids.swap(ids);
+    this->domain_names.swap(names);
+    this->graphs.swap(loaded);
+    return true;
+}
+
+/***********************************************************************************************
+ ***                                DefaultRoleManager::RoleGraph::Swap                      ***
+ ***********************************************************************************************
+ * DESCRIPTION: Exchanges the Roles and links of two RoleGraphs.                               *
+ *                                                                                             *
+ *                                                                                             *
+ * INPUT:   other -- RoleGraph to exchange with.                                               *
+ *                                                                                             *
+ * OUTPUT:   NONE                                                                              *
+ *                                                                                             *
+ * WARNINGS:    NONE                                                                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *     10/17/2026 ARZR : Created.                                                              *
+ *=============================================================================================*/
+void DefaultRoleManager::RoleGraph::Swap(RoleGraph& other) {
+    this->role_ids.swap(other.role_ids);
+    this->role_names.swap(other.role_names);
+    this->parents.swap(other.parents);
+    this->ancestors.swap(other.ancestors);
+    this->descendants.swap(other.descendants);
+    this->children.swap(other.children);
+    this->pattern_roles.swap(other.pattern_roles);
+    this->pattern_matches.swap(other.pattern_matches);
+}
+
 } // namespace  caep 
 
 
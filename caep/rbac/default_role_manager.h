@@ -15,109 +15,183 @@
  *                                                                                             *
  *---------------------------------------------------------------------------------------------*
  * Functions:                                                                                  *
- *   Role::Role -- Constructor.                                                                *
- *   Role::NewRole -- Gets a shared_ptr<Role>.                                                 *
- *   Role::AddRole -- Adds a Role to Role::all_roles.                                          *
- *   Role::DeleteRole -- Deletes a Role from Role::all_roles.                                  *
- *   Role::HasRole -- Determines if current Role::all_roles has a Role recursively.            *
- *   Role::HasDirectRole -- Determines if current Role::all_roles has a Role directly.         *
- *   Role::ToString -- Prints all Role's name in Role::all_roles.                              *
- *   Role::GetRoles -- Gets all Role's name in Role::all_roles.                                *
- *                                                                                             *
+ *   DefaultRoleManager::FindDomain -- Looks up the RoleGraph of a domain.                     *
+ *   DefaultRoleManager::CreateDomain -- Gets a new RoleGraph or an existed one for a domain.  *
+ *   DefaultRoleManager::FindRole -- Looks up the id of a Role.                                *
+ *   DefaultRoleManager::PatternRoles -- Gets the Roles that match a name by pattern.          *
+ *   DefaultRoleManager::IsPattern -- Determines if a name is a pattern Role.                  *
  *   DefaultRoleManager::HasRole -- Determines if RoleManager has a Role directly.             *
  *   DefaultRoleManager::CreateRole -- Gets a new Role or an existed Role.                     *
+ *   DefaultRoleManager::AddEdge -- Adds a direct parent and extends the reachability index.   *
+ *   DefaultRoleManager::DeleteEdge -- Deletes a direct parent and repairs the index.          *
  *   DefaultRoleManager::DefaultRoleManager -- Constructor and specifies a hierarchy_level.    *
  *   DefaultRoleManager::AddMatchingFunc -- Adds a match function to RoleManager.              *
  *   DefaultRoleManager::Clear -- Clears all Roles.                                            *
+ *   DefaultRoleManager::ClearDomain -- Clears all Roles of a domain.                          *
+ *   DefaultRoleManager::NewEmpty -- Creates a RoleManager with the same settings.             *
  *   DefaultRoleManager::AddLink -- Builds a hieritance link between two Roles.                *
  *   DefaultRoleManager::DeleteLink -- Deletes a hieritance link between two Roles.            *
  *   DefaultRoleManager::HasLink -- Determines if there is a hieritance link between two Roles.*
  *   DefaultRoleManager::GetRoles -- Gets all Roles that a user owns.                          *
  *   DefaultRoleManager::GetUsers -- Gets all Users that a Role owns.                          *
+ *   DefaultRoleManager::GetImplicitUsers -- Gets all Users that inherit a Role.               *
+ *   DefaultRoleManager::HasUsers -- Determines if a Role has direct Users.                    *
+ *   DefaultRoleManager::HasMatchingFunc -- Determines if a matching function was added.       *
  *   DefaultRoleManager::PrintRoles -- Prints all Roles in Rolemanager.                        *
+ *   DefaultRoleManager::SaveGraphs -- Writes the Roles, links and index of all domains.       *
+ *   DefaultRoleManager::LoadGraphs -- Restores the RoleGraphs that SaveGraphs wrote.          *
+ *   DefaultRoleManager::RoleGraph::Swap -- Exchanges the Roles of two RoleGraphs.             *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #ifndef CAEP_DEFAULT_ROLE_MANAGER_H
 #define CAEP_DEFAULT_ROLE_MANAGER_H
 
 #include <unordered_map>
+#include <cstdint>
 #include <iostream>
 
 #include "./role_manager.h"
+#include "../log/thread_util/rw_lock.h"
+#include "../util/snapshot_io.h"
 
 namespace caep {
 
 /*-------------------------------------------------------------------------------------------
- * @brief Forward declaration.
+ * @brief Id of a Role in DefaultRoleManager, ids are dense and start from 0.
  */
-class Role;
+typedef uint32_t role_t;
 
-typedef std::shared_ptr<Role> SRptr;
-typedef std::weak_ptr<Role> WRptr;
+/*-------------------------------------------------------------------------------------------
+ * @brief Id that no Role owns, returned by DefaultRoleManager::FindRole if a Role is not found.
+ */
+const role_t NO_ROLE = UINT32_MAX;
 
 /*-------------------------------------------------------------------------------------------
- * @brief These match function are for matching two Roles in customed pattern.
+ * @brief Id of a domain in DefaultRoleManager, 0 is for Roles without a domain.
  */
-using MatchingFunc = bool (*)(std::string, std::string);
+typedef uint32_t domain_t;
 
 /*-------------------------------------------------------------------------------------------
- * @brief This class records all messages that a Role has. Such as, a Role's name, it could
- * be a user's name or a role's name, because Caep do not distinguish user and role, all of
- * them are regarded as string-Type. In order to distinguish user and role, you can add suffix
- * to them, eg: User::Alice, Role::group. Also, Role class stores the inheritance tree that a 
- * Role owns, which is the bottom node of the inheritance tree.
+ * @brief Id that no domain owns, returned by DefaultRoleManager::FindDomain if a domain is not found.
  */
-class Role {
-private:
-    /*
-     * @brief Role's name.
-     */
-    std::string name;
-
-    /*
-     * @brief Describes a Role's inheritance tree, which is the bottom node of the inheritance tree.
-     */
-    std::vector<WRptr> roles;
-public:
-    
-    explicit Role(std::string name) : name(name) {};    
+const domain_t NO_DOMAIN = UINT32_MAX;
 
-    static SRptr NewRole(std::string name);
-    void AddRole(WRptr role);
-    void DeleteRole(WRptr role);
-    bool HasRole(std::string name, int hierarchy_level);
-    bool HasDirectRole(std::string name);
+/*-------------------------------------------------------------------------------------------
+ * @brief These match function are for matching two Roles in customed pattern.
+ */
+using MatchingFunc = bool (*)(std::string, std::string);
 
-    std::string ToString();
+/*-------------------------------------------------------------------------------------------
+ * @brief These functions tell which Roles are patterns, only those are passed to a MatchingFunc.
+ */
+using PatternFunc = bool (*)(const std::string&);
 
-    std::vector<std::string> GetRoles();
-};
+/*-------------------------------------------------------------------------------------------
+ * @brief Count of names whose pattern matches a RoleGraph caches before it drops them all.
+ */
+const size_t MAX_PATTERN_MATCHES = 1 << 16;
 
+/*-------------------------------------------------------------------------------------------
+ * @brief DefaultRoleManager stores the inheritance links between Roles. Caep do not distinguish
+ * user and role, all of them are regarded as string-Type. In order to distinguish user and role,
+ * you can add suffix to them, eg: User::Alice, Role::group.
+ *
+ *                  eg: g, Alice, admin
+ *                      g, admin, root
+ *
+ *  in this case:
+ *
+ *  role_ids -- "Alice" -- 0, "admin" -- 1, "root" -- 2
+ *  parents -- {{1}, {2}, {}}
+ *  ancestors -- {{1: 1, 2: 2}, {2: 1}, {}}
+ *  descendants -- {{}, {0: 1}, {0: 2, 1: 1}}
+ *  children -- {{}, {0}, {1}}
+ *
+ *  ancestors is the reachability index: every Role a Role inherits within max_hierarchy_level
+ *  links, with the count of links of the shortest path, so that HasLink is a single lookup.
+ *  descendants is its reverse, AddLink and DeleteLink use it to update only the Roles whose
+ *  ancestors changed, and GetImplicitUsers reads it. children is the reverse of parents, the
+ *  direct members of a Role for GetUsers. Roles that match a name through the matching function
+ *  are not indexed for that name, HasLink tries them on the fly: pattern_roles lists the Roles
+ *  the matching function may match to, and pattern_matches caches the result for each name.
+ *
+ *  Every domain owns a RoleGraph of the members above, found by the id that domain_ids interns
+ *  its name to, so Roles are never prefixed with their domain and a domain is cleared without
+ *  touching the others. Roles without a domain live in graphs[0].
+ *
+ *                  eg: g, Alice, admin, tenant1
+ *
+ *  domain_ids -- "tenant1" -- 1
+ *  graphs[1].role_ids -- "Alice" -- 0, "admin" -- 1
+ */
 class DefaultRoleManager : public RoleManager {
 private:
-    std::unordered_map<std::string, SRptr> all_roles;
+    typedef std::unordered_map<role_t, int> Reach;
+
+    class RoleGraph {
+    public:
+        std::unordered_map<std::string, role_t> role_ids;
+        std::vector<std::string> role_names;
+        std::vector<std::vector<role_t>> parents;
+        std::vector<Reach> ancestors;
+        std::vector<Reach> descendants;
+        std::vector<std::vector<role_t>> children;
+        std::vector<role_t> pattern_roles;
+        mutable std::unordered_map<std::string, std::vector<role_t>> pattern_matches;
+
+        void Swap(RoleGraph& other);
+    };
+
+    std::unordered_map<std::string, domain_t> domain_ids;
+    std::vector<std::string> domain_names;
+    std::vector<RoleGraph> graphs;
     bool has_pattern;
     MatchingFunc mf;
+    PatternFunc is_pattern;
+    mutable RWLock pattern_lock;
     int max_hierarchy_level;
 
-    bool HasRole(std::string name);
+    domain_t FindDomain(const std::vector<std::string>& domain) const;
+
+    domain_t CreateDomain(const std::vector<std::string>& domain);
+
+    role_t FindRole(const RoleGraph& graph, const std::string& name) const;
 
-    SRptr CreateRole(std::string name);
+    std::vector<role_t> PatternRoles(const RoleGraph& graph, const std::string& name) const;
+
+    bool IsPattern(const std::string& name) const;
+
+    bool HasRole(const RoleGraph& graph, const std::string& name) const;
+
+    role_t CreateRole(RoleGraph& graph, const std::string& name);
+
+    void AddEdge(RoleGraph& graph, role_t child, role_t parent);
+
+    void DeleteEdge(RoleGraph& graph, role_t child, role_t parent);
 
 public:
     DefaultRoleManager(int max_hierarchy_level);
     
-    void AddMatchingFunc(MatchingFunc mf);
+    void AddMatchingFunc(MatchingFunc mf, PatternFunc is_pattern = nullptr);
 
     void Clear();
+    void ClearDomain(const std::string& domain);
+    std::shared_ptr<RoleManager> NewEmpty();
     void AddLink(std::string name1, std::string name2, std::vector<std::string> domain = {});
     void DeleteLink(std::string name1, std::string name2, std::vector<std::string> domain = {});
     bool HasLink(std::string name1, std::string name2, std::vector<std::string> domain = {});
 
     std::vector<std::string> GetRoles(std::string name, std::vector<std::string> domain = {});
     std::vector<std::string> GetUsers(std::string name, std::vector<std::string> domain = {});
+    std::vector<std::string> GetImplicitUsers(std::string name, std::vector<std::string> domain = {});
+    bool HasUsers(std::string name, std::vector<std::string> domain = {});
+
+    bool HasMatchingFunc() const;
 
     void PrintRoles();
+
+    bool SaveGraphs(SnapshotWriter& out) const;
+    bool LoadGraphs(SnapshotReader& in);
 };
 
 } // namespace caep 
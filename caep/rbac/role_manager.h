@@ -19,9 +19,14 @@
 #ifndef CAEP_ROLE_MANAGER_H
 #define CAEP_ROLE_MANAGER_H 
 
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include "../exception/rbac_exception.h"
+#include "../exception/unsupported_operation_exception.h"
+
 namespace caep {
 
 class RoleManager {
@@ -37,6 +42,26 @@ public:
      * @brief Clears all roles in RoleManager.
      */
     virtual void Clear() = 0;
+
+    /*
+     * @brief Clears the roles of a domain, the roles of the other domains are kept. A RoleManager
+     * that does not override it throws UnsupportedOperationException.
+     *
+     * @param domain name of the domain.
+     */
+    virtual void ClearDomain(const std::string& /* domain */) {
+        throw UnsupportedOperationException("ClearDomain is not supported by this role manager");
+    }
+
+    /*
+     * @brief Creates a RoleManager with the settings of this one but no roles, such as the
+     * hierarchy level and the matching function. Policy reloads build their role graph in it.
+     * A RoleManager that does not override it throws UnsupportedOperationException, and is
+     * cleared and rebuilt in place instead.
+     */
+    virtual std::shared_ptr<RoleManager> NewEmpty() {
+        throw UnsupportedOperationException("NewEmpty is not supported by this role manager");
+    }
     
     /*
      * @brief Builds an inheritance links between two roles.
@@ -81,6 +106,48 @@ public:
      */
     virtual std::vector<std::string> GetUsers(std::string role, std::vector<std::string> domain = {}) = 0;
 
+    /*
+     * @brief Determines whether a role has direct users, i.e. whether others inherit it.
+     *
+     * @param role role's name.
+     * @param domain prefix of the role, determines role's domain.
+     */
+    virtual bool HasUsers(std::string role, std::vector<std::string> domain = {}) {
+        try {
+            return !GetUsers(role, domain).empty();
+        } catch(CaepRbacException&) {
+            return false;
+        }
+    }
+
+    /*
+     * @brief Get all users that inherit a role, directly or through other roles. The default
+     * walks GetUsers breadth first, every user is visited once.
+     *
+     * @param role role's name.
+     * @param domain prefix of the role, determines role's domain.
+     */
+    virtual std::vector<std::string> GetImplicitUsers(std::string role, std::vector<std::string> domain = {}) {
+        std::vector<std::string> res;
+        std::unordered_set<std::string> visited{role};
+        std::vector<std::string> q{role};
+        for(size_t i = 0; i < q.size(); i++) {
+            std::vector<std::string> users;
+            try {
+                users = GetUsers(q[i], domain);
+            } catch(CaepRbacException&) {
+                continue;
+            }
+            for(auto& user : users) {
+                if(visited.insert(user).second) {
+                    res.push_back(user);
+                    q.push_back(user);
+                }
+            }
+        }
+        return res;
+    }
+
     /*
      * @brief Prints all roles in the rolemanager.
      */
@@ -1,16 +1,12 @@
 #ifndef CAEP_BUILD_IN_FUNTIONS_CPP
 #define CAEP_BUILD_IN_FUNTIONS_CPP
 
-#include <regex>
-
 #include "./built_in_functions.h"
 #include "../rbac/role_manager.h"
 #include "./util.h"
+#include "./regex_cache.h"
 #include "../exception/illegal_argument_exception.h"
-#include "../ip_parser/parser/CIDR.h"
-#include "../ip_parser/parser/IP.h"
-#include "../ip_parser/parser/parseCIDR.h"
-#include "../ip_parser/parser/parseIP.h"
+#include "../ip_parser/parser/IPPrefix.h"
 
 namespace caep {
 
@@ -20,32 +16,25 @@ bool DefaultMatcher(std::string str1, std::string str2) {
     if(pos == std::string::npos)
         return str1 == str2;
 
-    if(str1.length() > pos)
-        return str1.substr(0, pos) == str2.substr(0, pos);
-
-    return str1 == str2.substr(0, pos);
+    // str1 matches if it starts with the part before "*", compared in place.
+    return str1.compare(0, pos, str2, 0, pos) == 0;
 }
 
 bool RegexMatcher(std::string str1, std::string str2) {
-    std::regex regex_s(str2);
-    return regex_match(str1, regex_s);
+    return RegexCache::Shared().Match(str1, str2);
 }
 
 bool IPMatcher(std::string ip1, std::string ip2) {
-    IP objIP1 = parseIP(ip1);
-    if (objIP1.isLegal == false)
+    IPPrefix addr;
+    if(!IPPrefix::Parse(ip1, addr) || addr.bits != 128)
         throw IllegalArgumentException("invalid argument: ip1 in IPMatch() function is not an IP address.");
 
-    CIDR objCIDR = parseCIDR(ip2);
-    if (objCIDR.ip.isLegal == false) {
-        IP objIP2 = parseIP(ip2);
-        if (objIP2.isLegal == false)
-            throw IllegalArgumentException("invalid argument: ip1 in IPMatch() function is not an IP address.");
-
-        return objIP1.Equal(objIP2);
-    }
+    // ip2 is an address or a CIDR, an address is the prefix of all of its 128 bits.
+    IPPrefix prefix;
+    if(!IPPrefix::Parse(ip2, prefix))
+        throw IllegalArgumentException("invalid argument: ip2 in IPMatch() function is neither an IP address nor a CIDR.");
 
-    return objCIDR.net.contains(objIP1);
+    return prefix.Contains(addr);
 }
 
 } // namespace caep 
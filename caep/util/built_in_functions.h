@@ -16,6 +16,7 @@ bool DefaultMatcher(std::string str1, std::string str2);
 
 /**
  * @breif RegexMatch determines whether key1 matches the pattern of key2 in regular expression.
+ * @breif key2 is compiled once and kept in RegexCache::Shared().
  */ 
 bool RegexMatcher(std::string str1, std::string str2);
 
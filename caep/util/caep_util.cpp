@@ -81,7 +81,7 @@ String CaepUtil::LTrim(const String& str, const String& delim) {
 String CaepUtil::ArrayToString(const StringList& arr) {
     String result = arr[0];
     for(size_t i = 1; i < arr.size(); ++i)
-        result = ", " + arr[i];
+        result += ", " + arr[i];
     return result;
 }
 
@@ -0,0 +1,56 @@
+#ifndef CAEP_MAPPED_FILE_CPP
+#define CAEP_MAPPED_FILE_CPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "./mapped_file.h"
+#include "../exception/io_exception.h"
+
+namespace caep {
+
+MappedFile::MappedFile(const std::string& path) : m_data(nullptr), m_size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw IOException("Cannot open file.");
+
+    struct stat st;
+    if(fstat(fd, &st) < 0) {
+        close(fd);
+        throw IOException("Cannot stat file.");
+    }
+
+    // mmap rejects a length of 0, an empty file is just an empty view.
+    m_size = size_t(st.st_size);
+    if(m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data == MAP_FAILED) {
+            close(fd);
+            throw IOException("Cannot map file.");
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+    }
+
+    // The mapping keeps the file alive, the descriptor is not needed anymore.
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if(m_data != nullptr)
+        munmap(const_cast<char*>(m_data), m_size);
+}
+
+std::string_view MappedFile::View() const {
+    return std::string_view(m_data, m_size);
+}
+
+size_t MappedFile::Size() const {
+    return m_size;
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef CAEP_MAPPED_FILE_H
+#define CAEP_MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+
+namespace caep {
+
+// MappedFile maps a whole file read-only into memory, so that it is parsed in place through
+// string_views instead of being copied line by line. The views live as long as the MappedFile.
+class MappedFile {
+private:
+    const char* m_data;
+    size_t m_size;
+
+public:
+    // MappedFile throws IOException if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view View() const;
+
+    size_t Size() const;
+};
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef CAEP_REGEX_CACHE_CPP
+#define CAEP_REGEX_CACHE_CPP
+
+#include "./regex_cache.h"
+
+namespace caep {
+
+RegexCache::RegexCache(size_t capacity) : m_capacity(capacity) {
+}
+
+bool RegexCache::IsLiteral(const std::string& pattern) {
+    return pattern.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+}
+
+std::shared_ptr<const RegexCache::Entry> RegexCache::Get(const std::string& pattern) {
+    {
+        ReadLockGuard guard(m_lock);
+        auto it = m_entries.find(pattern);
+        if(it != m_entries.end())
+            return it->second;
+    }
+
+    // Compiled without the lock, an invalid pattern throws std::regex_error and is not stored.
+    auto entry = std::make_shared<Entry>();
+    entry->literal = IsLiteral(pattern);
+    if(!entry->literal)
+        entry->regex = std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+
+    WriteLockGuard guard(m_lock);
+    if(m_entries.size() >= m_capacity)
+        m_entries.clear();
+    return m_entries.emplace(pattern, entry).first->second;
+}
+
+bool RegexCache::Match(const std::string& str, const std::string& pattern) {
+    std::shared_ptr<const Entry> entry = Get(pattern);
+    if(entry->literal)
+        return str == pattern;
+    return std::regex_match(str, entry->regex);
+}
+
+size_t RegexCache::Size() {
+    ReadLockGuard guard(m_lock);
+    return m_entries.size();
+}
+
+void RegexCache::Clear() {
+    WriteLockGuard guard(m_lock);
+    m_entries.clear();
+}
+
+RegexCache& RegexCache::Shared() {
+    static RegexCache cache;
+    return cache;
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef CAEP_REGEX_CACHE_H
+#define CAEP_REGEX_CACHE_H
+
+#include <regex>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "../log/thread_util/rw_lock.h"
+
+namespace caep {
+
+// RegexCache compiles every pattern once, RegexMatcher then only runs the compiled regex.
+// Patterns come from policy values, so there are as many entries as distinct regex cells.
+// A pattern without regex metacharacters only matches itself and is compared as a string.
+class RegexCache {
+private:
+    class Entry {
+    public:
+        bool literal;
+        std::regex regex;
+    };
+
+    RWLock m_lock;
+    std::unordered_map<std::string, std::shared_ptr<const Entry>> m_entries;
+    size_t m_capacity;
+
+    static bool IsLiteral(const std::string& pattern);
+
+    std::shared_ptr<const Entry> Get(const std::string& pattern);
+
+public:
+    // RegexCache drops all compiled patterns once it holds capacity of them.
+    explicit RegexCache(size_t capacity = 1 << 16);
+
+    // Match determines whether str matches pattern entirely, as std::regex_match does.
+    bool Match(const std::string& str, const std::string& pattern);
+
+    size_t Size();
+
+    void Clear();
+
+    // Shared returns the cache that RegexMatcher uses.
+    static RegexCache& Shared();
+};
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef CAEP_SNAPSHOT_IO_CPP
+#define CAEP_SNAPSHOT_IO_CPP
+
+#include "./snapshot_io.h"
+#include "../exception/io_exception.h"
+
+namespace caep {
+
+uint64_t Checksum(std::string_view data, uint64_t seed) {
+    const uint64_t PRIME = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+    size_t i = 0;
+    for(; i + 8 <= data.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + i, 8);
+        hash = (hash ^ word) * PRIME;
+        hash ^= hash >> 29;
+    }
+    for(; i < data.size(); ++i)
+        hash = (hash ^ uint8_t(data[i])) * PRIME;
+    return hash ^ data.size();
+}
+
+void SnapshotWriter::PutBytes(const void* data, size_t size) {
+    buffer.append(static_cast<const char*>(data), size);
+}
+
+void SnapshotWriter::PutString(std::string_view str) {
+    Put(uint32_t(str.size()));
+    buffer.append(str.data(), str.size());
+}
+
+SnapshotReader::SnapshotReader(std::string_view data) : m_data(data), m_pos(0) {
+}
+
+void SnapshotReader::Need(size_t size) const {
+    if(size > m_data.size() - m_pos)
+        throw IOException("corrupted snapshot: truncated data");
+}
+
+std::string_view SnapshotReader::GetBytes(size_t size) {
+    Need(size);
+    std::string_view bytes = m_data.substr(m_pos, size);
+    m_pos += size;
+    return bytes;
+}
+
+std::string_view SnapshotReader::GetString() {
+    return GetBytes(Get<uint32_t>());
+}
+
+bool SnapshotReader::AtEnd() const {
+    return m_pos == m_data.size();
+}
+
+size_t SnapshotReader::Position() const {
+    return m_pos;
+}
+
+} // namespace caep
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef CAEP_SNAPSHOT_IO_H
+#define CAEP_SNAPSHOT_IO_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace caep {
+
+// Checksum hashes data eight bytes at a time, it detects a torn or corrupted snapshot but is not
+// meant to resist tampering.
+uint64_t Checksum(std::string_view data, uint64_t seed = 0);
+
+// SnapshotWriter appends plain values in host byte order and strings prefixed by their length.
+class SnapshotWriter {
+public:
+    std::string buffer;
+
+    template<typename T>
+    void Put(T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values are written as bytes");
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void PutBytes(const void* data, size_t size);
+
+    void PutString(std::string_view str);
+};
+
+// SnapshotReader reads what SnapshotWriter wrote out of a view, typically of a MappedFile. Every
+// read is bounds checked, a short or corrupted view throws IOException instead of reading past it.
+class SnapshotReader {
+private:
+    std::string_view m_data;
+    size_t m_pos;
+
+    void Need(size_t size) const;
+
+public:
+    explicit SnapshotReader(std::string_view data);
+
+    template<typename T>
+    T Get() {
+        static_assert(std::is_trivially_copyable<T>::value, "only plain values are read as bytes");
+        Need(sizeof(T));
+        T value;
+        std::memcpy(&value, m_data.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return value;
+    }
+
+    // GetBytes returns a view of the next size bytes, they are not copied.
+    std::string_view GetBytes(size_t size);
+
+    std::string_view GetString();
+
+    bool AtEnd() const;
+
+    // Position is the count of bytes read so far.
+    size_t Position() const;
+};
+
+} // namespace caep
+
+#endif
@@ -1,5 +1,11 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
 #include <gtest/gtest.h>
 #include <caep/caep.h>
+#include <caep/log/thread_util/thread.h>
 
 namespace {
 
@@ -21,4 +27,222 @@ TEST(TestAdapter, TestAdapter) {
                   });
 }
 
+TEST(TestAdapter, TestLoadPolicyText) {
+    caep::Model* model = caep::Model::NewModelFromFile("../../example/basic_rbac_model.ini");
+    caep::LoadPolicyText("# comment\n"
+                         "  a, Alice , data1,read  \r\n"
+                         "\n"
+                         "r, Alice, admin\n"
+                         "a, Bob, data2, read", model);
+
+    ASSERT_EQ(model->GetPolicy("a", "a"), std::vector<std::vector<std::string>>({{"Alice", "data1", "read"}, {"Bob", "data2", "read"}}));
+    ASSERT_EQ(model->GetPolicy("r", "r"), std::vector<std::vector<std::string>>({{"Alice", "admin"}}));
+
+    // Fields are interned once, whichever Section they are loaded into.
+    auto section = model->m["a"].section_map["a"];
+    ASSERT_EQ(section->GetId(0, 0), model->m["r"].section_map["r"]->GetId(0, 0));
+
+    ASSERT_ANY_THROW(caep::LoadPolicyText("x, Alice, data1", model));
+}
+
+TEST(TestAdapter, TestLoadPolicyTextParallel) {
+    std::string text = "# comment\n\n";
+    for(int i = 0; i < 20000; ++i) {
+        if(i % 10 == 9)
+            text += "r, user" + std::to_string(i % 700) + ", role" + std::to_string(i % 30) + "\n";
+        else
+            text += "a, role" + std::to_string(i % 30) + " , data" + std::to_string(i) + ", read\n";
+    }
+    text += "a, data*, write";
+
+    // The chunks are merged in file order, the symbols get the same ids and the rules the same rows.
+    std::unique_ptr<caep::Model> serial(caep::Model::NewModelFromFile("../../example/basic_rbac_model.ini"));
+    caep::LoadPolicyText(text, serial.get());
+    for(size_t thread_count : {2, 4, 7}) {
+        std::unique_ptr<caep::Model> parallel(caep::Model::NewModelFromFile("../../example/basic_rbac_model.ini"));
+        caep::LoadPolicyTextParallel(text, parallel.get(), thread_count);
+        ASSERT_EQ(parallel->GetPolicy("a", "a"), serial->GetPolicy("a", "a"));
+        ASSERT_EQ(parallel->GetPolicy("r", "r"), serial->GetPolicy("r", "r"));
+        ASSERT_EQ(parallel->symbols->Size(), serial->symbols->Size());
+        for(caep::symbol_t id = 0; id < serial->symbols->Size(); ++id)
+            ASSERT_EQ(parallel->symbols->Name(id), serial->symbols->Name(id));
+        ASSERT_EQ(parallel->GetFilteredPolicy("a", "a", 1, {"data42"}), serial->GetFilteredPolicy("a", "a", 1, {"data42"}));
+        ASSERT_TRUE(parallel->HasPolicy("a", "a", {"data*", "write"}));
+    }
+
+    std::unique_ptr<caep::Model> bad(caep::Model::NewModelFromFile("../../example/basic_rbac_model.ini"));
+    ASSERT_THROW(caep::LoadPolicyTextParallel(text + "\nx, y", bad.get(), 4), caep::AdapterException);
+}
+
+TEST(TestAdapter, TestLoadPolicyMissingFile) {
+    caep::Model* model = caep::Model::NewModelFromFile("../../example/basic_rbac_model.ini");
+    caep::FileAdapter f_adapter("../../example/no_such_policy.csv");
+    ASSERT_ANY_THROW(f_adapter.LoadPolicy(model));
+}
+
+void CopyFile(const std::string& from, const std::string& to) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    out << in.rdbuf();
+}
+
+void RemoveWALFiles(const std::string& policy) {
+    for(const std::string suffix : {"", ".wal", ".wal.compacting", ".tmp"})
+        std::remove((policy + suffix).c_str());
+}
+
+TEST(TestAdapter, TestWALFileAdapter) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "wal_adapter_test.csv";
+    RemoveWALFiles(policy);
+    CopyFile("../../example/basic_rbac_model.csv", policy);
+
+    {
+        caep::Caeper c(model, std::make_shared<caep::WALFileAdapter>(policy));
+        c.AddPolicy({"Carol", "data3", "read"});
+        c.RemovePolicy({"Bob", "data2", "read"});
+        c.AddRoleForUser("Carol", "admin");
+        c.UpdatePolicy({"Alice", "data1", "read"}, {"Alice", "data3", "write"});
+    }
+
+    // The policy file is untouched, the changes are replayed from the log.
+    auto adapter = std::make_shared<caep::WALFileAdapter>(policy);
+    caep::Caeper c(model, adapter);
+    ASSERT_GT(adapter->LogSize(), 0);
+    ASSERT_TRUE(c.Caep({"Carol", "data3", "read"}));
+    ASSERT_TRUE(c.Caep({"Carol", "data2", "write"}));
+    ASSERT_TRUE(c.Caep({"Alice", "data3", "write"}));
+    ASSERT_FALSE(c.Caep({"Bob", "data2", "read"}));
+    ASSERT_FALSE(c.HasPolicy({"Alice", "data1", "read"}));
+
+    // A record torn by a crash is dropped and cut off, the records before it are kept.
+    size_t intact = adapter->LogSize();
+    {
+        std::ofstream out(adapter->LogPath(), std::ios::binary | std::ios::app);
+        out << "\x40\x00\x00\x00torn";
+    }
+    c.LoadPolicy();
+    ASSERT_EQ(adapter->LogSize(), intact);
+    ASSERT_TRUE(c.Caep({"Carol", "data3", "read"}));
+
+    auto rules = c.GetPolicy();
+    adapter->Compact();
+    ASSERT_EQ(adapter->LogSize(), 0);
+    c.LoadPolicy();
+    ASSERT_EQ(c.GetPolicy(), rules);
+
+    RemoveWALFiles(policy);
+}
+
+TEST(TestAdapter, TestWALBackgroundCompaction) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "wal_compaction_test.csv";
+    RemoveWALFiles(policy);
+    CopyFile("../../example/basic_rbac_model.csv", policy);
+
+    caep::WALOptions options;
+    options.sync_every = 16;
+    options.compact_min_bytes = 1024;
+    auto adapter = std::make_shared<caep::WALFileAdapter>(policy, options);
+    caep::Caeper c(model, adapter);
+    for(int i = 0; i < 200; ++i)
+        c.AddPolicy({"user" + std::to_string(i), "data1", "read"});
+    c.RemovePolicy({"user7", "data1", "read"});
+
+    // LoadPolicy waits for the compactor, then reads the folded policy file and what was appended since.
+    c.LoadPolicy();
+    std::unique_ptr<caep::Model> base(caep::Model::NewModelFromFile(model));
+    caep::FileAdapter(policy).LoadPolicy(base.get());
+    ASSERT_GT(base->GetPolicy("a", "a").size(), 4);
+    ASSERT_EQ(c.GetPolicy().size(), 4 + 199);
+    ASSERT_FALSE(c.HasPolicy({"user7", "data1", "read"}));
+    ASSERT_TRUE(c.HasPolicy({"user199", "data1", "read"}));
+
+    RemoveWALFiles(policy);
+}
+
+// LatchedBatchFileAdapter holds the first leader before it writes until release is set, so that the
+// changes of the other callers queue meanwhile.
+class LatchedBatchFileAdapter : public caep::BatchFileAdapter {
+public:
+    std::atomic<bool> first{true};
+    std::atomic<bool> release{false};
+
+    using caep::BatchFileAdapter::BatchFileAdapter;
+
+protected:
+    void WriteGroup(const Group& group) {
+        if(first.exchange(false)) {
+            while(!release)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        caep::BatchFileAdapter::WriteGroup(group);
+    }
+};
+
+TEST(TestAdapter, TestBatchFileAdapter) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "batch_adapter_test.csv";
+    CopyFile("../../example/basic_rbac_model.csv", policy);
+
+    {
+        caep::Caeper c(model, std::make_shared<caep::BatchFileAdapter>(policy));
+        c.AddPolicies({{"Carol", "data3", "read"}, {"Carol", "data3", "write"}, {"Dave", "data3", "read"}});
+        c.RemovePolicies({{"Bob", "data2", "read"}, {"Carol", "data3", "write"}});
+        c.RemoveFilteredPolicy(0, {"Dave"});
+        c.AddPolicy({"Erin", "data1", "read"});
+    }
+
+    caep::Caeper c(model, policy);
+    ASSERT_TRUE(c.HasPolicy({"Carol", "data3", "read"}));
+    ASSERT_TRUE(c.HasPolicy({"Erin", "data1", "read"}));
+    ASSERT_FALSE(c.HasPolicy({"Carol", "data3", "write"}));
+    ASSERT_FALSE(c.HasPolicy({"Dave", "data3", "read"}));
+    ASSERT_FALSE(c.HasPolicy({"Bob", "data2", "read"}));
+    ASSERT_EQ(c.GetPolicy().size(), 5);
+
+    // A rule is removed whatever the order of its fields, as the model compares rules.
+    {
+        caep::BatchFileAdapter reordered(policy);
+        reordered.RemovePolicy("a", "a", {"data1", "Erin", "read"});
+    }
+    c.LoadPolicy();
+    ASSERT_FALSE(c.HasPolicy({"Erin", "data1", "read"}));
+    ASSERT_EQ(c.GetPolicy().size(), 4);
+
+    // Batches of concurrent callers are all written, the ones queued behind the held leader in one commit.
+    auto adapter = std::make_shared<LatchedBatchFileAdapter>(policy, false);
+    std::vector<std::unique_ptr<caep::Thread>> threads;
+    for(int i = 0; i < 8; ++i) {
+        threads.emplace_back(new caep::Thread([adapter, i]() {
+            for(int j = 0; j < 10; ++j) {
+                std::vector<std::vector<std::string>> rules;
+                for(int k = 0; k < 10; ++k)
+                    rules.push_back({"user" + std::to_string(i * 100 + j * 10 + k), "data1", "read"});
+                adapter->AddPolicies("a", "a", rules);
+            }
+        }));
+    }
+    for(auto& thread : threads)
+        thread->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    adapter->release = true;
+    for(auto& thread : threads)
+        thread->Join();
+    ASSERT_LT(adapter->GroupCount(), 80);
+
+    c.LoadPolicy();
+    ASSERT_EQ(c.GetPolicy().size(), 4 + 800);
+    ASSERT_TRUE(c.HasPolicy({"user799", "data1", "read"}));
+
+    std::remove(policy.c_str());
+}
+
+TEST(TestAdapter, TestAddPoliciesWithoutBatchAdapter) {
+    // FileAdapter is no BatchAdapter, a batch falls back to its AddPolicy and RemovePolicy.
+    caep::Caeper c("../../example/basic_rbac_model.ini", std::make_shared<caep::FileAdapter>("../../example/basic_rbac_model.csv"));
+    ASSERT_TRUE(c.AddPolicies({{"Carol", "data3", "read"}}));
+    ASSERT_TRUE(c.RemovePolicies({{"Carol", "data3", "read"}}));
+}
+
 }
@@ -1,5 +1,12 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
 #include <gtest/gtest.h>
 #include <caep/caep.h>
+#include <caep/log/thread_util/thread.h>
 
 namespace {
 
@@ -21,6 +28,31 @@ TEST(TestCaeper, TestThreeParams) {
     ASSERT_EQ(c.Caep({"Bob", "data1", "read"}), false);
 }
 
+TEST(TestCaeper, TestCaepEx) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    c.EnableAutoSave(false);
+
+    caep::Explanation ex = c.CaepEx({"Alice", "data2", "write"});
+    ASSERT_TRUE(ex.decision);
+    ASSERT_EQ(ex.row, 3);
+    ASSERT_EQ(ex.rule, std::vector<std::string>({"admin", "data2", "write"}));
+    ASSERT_EQ(ex.terms, std::vector<std::string>({"RoleMatcher(a.sub)", "DefaultMatcher(a.res, a.act)"}));
+
+    // Nothing allows the request, so no rule decided under AllowPriority.
+    ex = c.CaepEx({"Bob", "data1", "read"});
+    ASSERT_FALSE(ex.decision);
+    ASSERT_EQ(ex.row, caep::NO_ROW);
+    ASSERT_TRUE(ex.rule.empty());
+
+    c.RemovePolicy({"Alice", "data1", "read"});
+    ex = c.CaepEx({"Bob", "data2", "read"});
+    ASSERT_EQ(ex.decision, c.Caep({"Bob", "data2", "read"}));
+    ASSERT_EQ(ex.rule, std::vector<std::string>({"Bob", "data2", "read"}));
+}
+
 //TEST(TestCaeper, TestFourParams) {
 //    std::string model = "../../example/rbac_with_domain.ini";
 //    std::string policy = "../../example/rbac_with_domain.csv";
@@ -38,4 +70,445 @@ TEST(TestCaeper, TestThreeParams) {
 //    ASSERT_EQ(c.Caep({"Bob", "data1", "write", "domain1"}), false);
 //}
 //
+TEST(TestCaeper, TestCaepWithMatcher) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+
+    ASSERT_EQ(c.CaepWithMatcher("DefaultMatcher(a.sub, a.res, a.act)", {"Alice", "data1", "read"}), true);
+    ASSERT_EQ(c.CaepWithMatcher("DefaultMatcher(a.sub, a.res, a.act)", {"Alice", "data1", "write"}), false);
+    ASSERT_EQ(c.CaepWithMatcher("RoleMatcher(a.sub) && DefaultMatcher(a.res, a.act)", {"Alice", "data1", "write"}), true);
+    ASSERT_EQ(c.CaepWithMatcher("!DefaultMatcher(a.sub) && DefaultMatcher(a.res)", {"Bob", "data1", "read"}), true);
+    ASSERT_THROW(c.CaepWithMatcher("UnknownMatcher(a.sub)", {"Alice", "data1", "read"}), caep::IllegalArgumentException);
+}
+
+TEST(TestCaeper, TestIndexedPolicy) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    c.EnableAutoSave(false);
+
+    ASSERT_EQ(c.Caep({"Carol", "data3", "read"}), false);
+    c.AddPolicy({"Carol", "data*", "read"});
+    ASSERT_EQ(c.Caep({"Carol", "data3", "read"}), true);
+    ASSERT_EQ(c.Caep({"Carol", "data3", "write"}), false);
+
+    c.RemovePolicy({"Alice", "data1", "read"});
+    ASSERT_EQ(c.Caep({"Carol", "data3", "read"}), true);
+    ASSERT_EQ(c.Caep({"Bob", "data2", "read"}), true);
+    ASSERT_EQ(c.Caep({"Alice", "data1", "write"}), true);
+}
+
+TEST(TestCaeper, TestSyncedCaeper) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::SyncedCaeper c(model, policy);
+    c.EnableAutoSave(false);
+
+    // Readers check rules that never change while a writer adds and removes others.
+    std::atomic<int> wrong(0);
+    std::vector<std::unique_ptr<caep::Thread>> threads;
+    for(int i = 0; i < 4; ++i) {
+        threads.emplace_back(new caep::Thread([&]() {
+            for(int j = 0; j < 2000; ++j) {
+                if(!c.Caep({"Alice", "data1", "read"}) || c.Caep({"Bob", "data1", "read"}))
+                    ++wrong;
+            }
+        }));
+    }
+    threads.emplace_back(new caep::Thread([&]() {
+        for(int j = 0; j < 200; ++j) {
+            c.AddPolicy({"user" + std::to_string(j), "data3", "read"});
+            if(j % 2)
+                c.RemovePolicy({"user" + std::to_string(j - 1), "data3", "read"});
+        }
+    }));
+
+    for(auto& thread : threads)
+        thread->Start();
+    for(auto& thread : threads)
+        thread->Join();
+
+    ASSERT_EQ(wrong, 0);
+    ASSERT_EQ(c.GetPolicy().size(), 4 + 100);
+    ASSERT_EQ(c.Caep({"user199", "data3", "read"}), true);
+    ASSERT_EQ(c.Caep({"user198", "data3", "read"}), false);
+}
+
+// SlowLoadAdapter waits after it has read the file, so that a change can be made before the reload
+// publishes what it read.
+class SlowLoadAdapter : public caep::BatchFileAdapter {
+public:
+    std::atomic<bool> loading{false};
+
+    using caep::BatchFileAdapter::BatchFileAdapter;
+
+    void LoadPolicy(caep::Model* model) {
+        caep::BatchFileAdapter::LoadPolicy(model);
+        loading = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+};
+
+TEST(TestCaeper, TestSyncedCaeperChangesDuringReload) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "synced_reload_test.csv";
+    {
+        std::ifstream in("../../example/basic_rbac_model.csv");
+        std::ofstream out(policy);
+        out << in.rdbuf();
+    }
+
+    // A rule added while the policy is reloaded is saved and kept by the reload.
+    auto adapter = std::make_shared<SlowLoadAdapter>(policy, false);
+    caep::SyncedCaeper c(model, adapter);
+    adapter->loading = false;
+    caep::Thread loader([&]() { c.LoadPolicy(); }, "loader");
+    caep::Thread adder([&]() {
+        while(!adapter->loading)
+            std::this_thread::yield();
+        c.AddPolicy({"Carol", "data3", "read"});
+    }, "adder");
+    loader.Start();
+    adder.Start();
+    loader.Join();
+    adder.Join();
+
+    ASSERT_TRUE(c.HasPolicy({"Carol", "data3", "read"}));
+    c.LoadPolicy();
+    ASSERT_TRUE(c.HasPolicy({"Carol", "data3", "read"}));
+    std::remove(policy.c_str());
+}
+
+TEST(TestCaeper, TestPolicySnapshot) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::SyncedCaeper c(model, policy);
+    c.EnableAutoSave(false);
+    c.AddPolicy({"Carol", "data3", "read"});
+
+    // A reload publishes a new model, the old one is still whole for requests that pinned it.
+    auto before = c.GetModel();
+    c.LoadPolicy();
+    ASSERT_NE(c.GetModel(), before);
+    ASSERT_EQ(before->GetPolicy("a", "a").size(), 5);
+    ASSERT_EQ(c.GetPolicy().size(), 4);
+
+    std::atomic<int> wrong(0);
+    std::vector<std::unique_ptr<caep::Thread>> threads;
+    for(int i = 0; i < 4; ++i) {
+        threads.emplace_back(new caep::Thread([&]() {
+            for(int j = 0; j < 2000; ++j) {
+                if(!c.Caep({"Alice", "data2", "write"}) || c.Caep({"Bob", "data1", "read"}))
+                    ++wrong;
+            }
+        }));
+    }
+    threads.emplace_back(new caep::Thread([&]() {
+        for(int j = 0; j < 50; ++j)
+            c.LoadPolicy();
+    }));
+
+    for(auto& thread : threads)
+        thread->Start();
+    for(auto& thread : threads)
+        thread->Join();
+
+    ASSERT_EQ(wrong, 0);
+}
+
+TEST(TestCaeper, TestFilteredPolicy) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    auto adapter = std::make_shared<caep::FilteredFileAdapter>(policy);
+    caep::Caeper c(std::shared_ptr<caep::Model>(caep::Model::NewModelFromFile(model)), adapter);
+
+    caep::Filter filter;
+    filter.A = {"Alice"};
+    c.LoadFilteredPolicy(&filter);
+
+    ASSERT_EQ(c.IsFiltered(), true);
+    ASSERT_EQ(c.GetPolicy().size(), 1);
+    ASSERT_EQ(c.Caep({"Alice", "data1", "read"}), true);
+    ASSERT_EQ(c.Caep({"Bob", "data2", "read"}), false);
+}
+
+TEST(TestCaeper, TestIndexedFilteredPolicy) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "indexed_filter_test.csv";
+    {
+        std::ifstream in("../../example/basic_rbac_model.csv");
+        std::ofstream out(policy);
+        out << in.rdbuf();
+    }
+
+    // The indexed adapter loads what the scanning one loads.
+    auto indexed = std::make_shared<caep::FilteredFileAdapter>(policy, true);
+    auto scanning = std::make_shared<caep::FilteredFileAdapter>(policy);
+    caep::Caeper c(std::shared_ptr<caep::Model>(caep::Model::NewModelFromFile(model)), indexed);
+    caep::Caeper expected(std::shared_ptr<caep::Model>(caep::Model::NewModelFromFile(model)), scanning);
+    std::vector<std::vector<std::string>> filters{{"admin"}, {"", "data2"}, {"Alice", "data1", "read"}, {"Carol"}, {"", "", "", "x"}};
+    for(const auto& values : filters) {
+        caep::Filter filter;
+        filter.A = values;
+        c.LoadFilteredPolicy(&filter);
+        expected.LoadFilteredPolicy(&filter);
+        ASSERT_EQ(c.GetPolicy(), expected.GetPolicy());
+        ASSERT_EQ(c.Caep({"Alice", "data2", "write"}), expected.Caep({"Alice", "data2", "write"}));
+    }
+    ASSERT_TRUE(std::ifstream(indexed->IndexPath()).good());
+
+    // A policy file changed after the index was built is indexed again.
+    {
+        std::ofstream out(policy, std::ios::app);
+        out << "\na, admin, data3, write\n";
+    }
+    caep::Filter filter;
+    filter.A = {"admin"};
+    c.LoadFilteredPolicy(&filter);
+    ASSERT_EQ(c.GetPolicy().size(), 3);
+    ASSERT_TRUE(c.Caep({"Alice", "data3", "write"}));
+
+    std::remove(indexed->IndexPath().c_str());
+    std::remove(policy.c_str());
+}
+
+
+TEST(TestCaeper, TestParallelBatchCaeper) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    std::vector<std::vector<std::string>> reqs;
+    for(int i = 0; i < 1000; ++i) {
+        reqs.push_back({"Alice", "data1", "read"});
+        reqs.push_back({"Bob", "data1", "read"});
+        reqs.push_back({"Alice", "data2", "write"});
+    }
+    auto expected = c.BatchCaeper(reqs);
+
+    auto pool = std::make_shared<caep::ThreadPool>(4);
+    c.SetThreadPool(pool);
+    ASSERT_EQ(c.BatchCaeper(reqs), expected);
+    ASSERT_EQ(expected[0], true);
+    ASSERT_EQ(expected[1], false);
+    ASSERT_EQ(expected[2], true);
+
+    // An exception in a worker reaches the caller.
+    ASSERT_THROW(pool->ParallelFor(100, 1, [](size_t begin, size_t) {
+        if(begin == 42)
+            throw caep::IllegalArgumentException("42");
+    }), caep::IllegalArgumentException);
+}
+
+
+TEST(TestCaeper, TestDecisionCache) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    c.EnableAutoSave(false);
+    c.EnableDecisionCache(100);
+    auto cache = c.GetDecisionCache();
+
+    ASSERT_EQ(c.Caep({"Bob", "data1", "read"}), false);
+    ASSERT_EQ(c.Caep({"Bob", "data1", "read"}), false);
+    ASSERT_EQ(cache->Hits(), 1);
+    ASSERT_EQ(cache->Misses(), 1);
+
+    // Every change to the policy or the role links invalidates the cached decisions.
+    c.AddPolicy({"Bob", "data1", "read"});
+    ASSERT_EQ(c.Caep({"Bob", "data1", "read"}), true);
+    c.RemovePolicy({"Bob", "data1", "read"});
+    ASSERT_EQ(c.Caep({"Bob", "data1", "read"}), false);
+    c.AddRoleForUser("Bob", "admin");
+    ASSERT_EQ(c.Caep({"Bob", "data1", "write"}), true);
+    c.LoadPolicy();
+    ASSERT_EQ(c.Caep({"Bob", "data1", "write"}), false);
+    ASSERT_EQ(cache->Hits(), 1);
+
+    // Fields are not joined, so shifting a separator makes another request.
+    ASSERT_EQ(c.Caep({"Alice", "data1", "read"}), true);
+    ASSERT_EQ(c.Caep({"Alice,data1", "", "read"}), false);
+
+    caep::DecisionCache small(2, 1);
+    small.Put({"a"}, 0, true);
+    small.Put({"b"}, 0, true);
+    bool decision;
+    ASSERT_EQ(small.Get({"a"}, 0, decision), true);
+    small.Put({"c"}, 0, false);
+    ASSERT_EQ(small.Size(), 2);
+    ASSERT_EQ(small.Get({"b"}, 0, decision), false);
+    ASSERT_EQ(small.Get({"a"}, 1, decision), false);
+    ASSERT_EQ(small.Get({"c"}, 0, decision), true);
+    ASSERT_EQ(decision, false);
+}
+
+TEST(TestCaeper, TestImplicitUsers) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    c.EnableAutoSave(false);
+    c.AddRoleForUser("Bob", "admin");
+    c.AddRoleForUser("team", "admin");
+    c.AddRoleForUser("Carol", "team");
+
+    std::vector<std::string> users = c.GetUsersForRole("admin");
+    std::sort(users.begin(), users.end());
+    ASSERT_EQ(users, std::vector<std::string>({"Alice", "Bob", "team"}));
+
+    // Carol inherits admin through team, roles are left out.
+    users = c.GetImplicitUsersForPermission({"data1", "write"});
+    std::sort(users.begin(), users.end());
+    ASSERT_EQ(users, std::vector<std::string>({"Alice", "Bob", "Carol"}));
+
+    c.DeleteRoleForUser("team", "admin");
+    users = c.GetImplicitUsersForPermission({"data1", "write"});
+    std::sort(users.begin(), users.end());
+    ASSERT_EQ(users, std::vector<std::string>({"Alice", "Bob"}));
+    ASSERT_EQ(c.GetUsersForRole("team"), std::vector<std::string>({"Carol"}));
+}
+
+
+bool PrefixMatch(std::string name, std::string pattern) {
+    return pattern.back() == '*' && name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+}
+
+TEST(TestCaeper, TestImplicitUsersForPatternSubjects) {
+    std::string text =
+        "[applicability]\na = sub, res, act\n"
+        "[role]\nr = $, $\n"
+        "[matcher]\nm = DefaultMatcher, RoleMatcher\n"
+        "[condition]\nc = DefaultMatcher(a.sub, a.res, a.act)\n"
+        "[effector]\ne = AllowPriority\n";
+    std::string policy = "implicit_users_test.csv";
+    {
+        std::ofstream out(policy);
+        out << "a, user*, data1, read\nr, user1, admin\nr, guest, visitor\n";
+    }
+
+    // user1 is allowed through the wildcard subject, not through a role link.
+    caep::Caeper c(std::shared_ptr<caep::Model>(caep::Model::NewModelFromText(text)), std::make_shared<caep::FileAdapter>(policy));
+    std::vector<std::string> users = c.GetImplicitUsersForPermission({"data1", "read"});
+    std::sort(users.begin(), users.end());
+    ASSERT_EQ(users, std::vector<std::string>({"user*", "user1"}));
+
+    // Matched by a pattern role, Carol only appears in a role rule.
+    caep::Caeper r("../../example/basic_rbac_model.ini", "../../example/basic_rbac_model.csv");
+    r.EnableAutoSave(false);
+    r.AddRoleForUser("staff*", "admin");
+    r.AddRoleForUser("staff_carol", "visitor");
+    std::dynamic_pointer_cast<caep::DefaultRoleManager>(r.GetRoleManager())->AddMatchingFunc(PrefixMatch);
+    users = r.GetImplicitUsersForPermission({"data1", "write"});
+    ASSERT_NE(std::find(users.begin(), users.end(), "staff_carol"), users.end());
+    std::remove(policy.c_str());
+}
+
+
+// LinkOnlyRoleManager implements only what a RoleManager must, NewEmpty is left to the default.
+class LinkOnlyRoleManager : public caep::RoleManager {
+public:
+    caep::DefaultRoleManager links{10};
+
+    void Clear() { links.Clear(); }
+    void AddLink(std::string name1, std::string name2, std::vector<std::string> domain = {}) { links.AddLink(name1, name2, domain); }
+    void DeleteLink(std::string name1, std::string name2, std::vector<std::string> domain = {}) { links.DeleteLink(name1, name2, domain); }
+    bool HasLink(std::string name1, std::string name2, std::vector<std::string> domain = {}) { return links.HasLink(name1, name2, domain); }
+    std::vector<std::string> GetRoles(std::string name, std::vector<std::string> domain = {}) { return links.GetRoles(name, domain); }
+    std::vector<std::string> GetUsers(std::string name, std::vector<std::string> domain = {}) { return links.GetUsers(name, domain); }
+    void PrintRoles() {}
+};
+
+TEST(TestCaeper, TestRoleManagerWithoutNewEmpty) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    auto rm = std::make_shared<LinkOnlyRoleManager>();
+    c.SetRoleManager(rm);
+    rm->AddLink("Carol", "admin");
+
+    // The role manager is cleared and rebuilt in place, the stale link is gone.
+    c.LoadPolicy();
+    ASSERT_EQ(c.GetRoleManager(), rm);
+    ASSERT_EQ(c.Caep({"Alice", "data1", "write"}), true);
+    ASSERT_EQ(c.Caep({"Carol", "data1", "write"}), false);
+    ASSERT_EQ(rm->GetImplicitUsers("admin"), std::vector<std::string>({"Alice"}));
+
+    caep::SyncedCaeper synced(model, policy);
+    synced.SetRoleManager(std::make_shared<LinkOnlyRoleManager>());
+    synced.LoadPolicy();
+    ASSERT_EQ(synced.Caep({"Alice", "data1", "write"}), true);
+}
+
+
+TEST(TestCaeper, TestIPMatcherIndex) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+
+    caep::Caeper c(model, policy);
+    c.EnableAutoSave(false);
+    c.AddPolicy({"192.168.2.0/24", "data1", "read"});
+    c.AddPolicy({"10.0.0.1", "data2", "read"});
+
+    // Only the rules whose CIDR contains the request address are visited, "Alice" is not parsed.
+    std::string condition = "IPMatcher(a.sub)";
+    ASSERT_EQ(c.CaepWithMatcher(condition, {"192.168.2.123", "data1", "read"}), true);
+    ASSERT_EQ(c.CaepWithMatcher(condition, {"192.168.3.1", "data1", "read"}), false);
+    ASSERT_EQ(c.CaepWithMatcher(condition, {"10.0.0.1", "data2", "read"}), true);
+    ASSERT_EQ(c.CaepWithMatcher(condition, {"10.0.0.2", "data2", "read"}), false);
+
+    // A request that is not an address still reaches IPMatcher, which rejects it.
+    ASSERT_ANY_THROW(c.CaepWithMatcher(condition, {"Alice", "data1", "read"}));
+}
+
+TEST(TestCaeper, TestSnapshotFile) {
+    std::string model = "../../example/basic_rbac_model.ini";
+    std::string policy = "../../example/basic_rbac_model.csv";
+    std::string path = "caeper_test_snapshot.caep";
+
+    caep::Caeper c(model, policy);
+    c.EnableAutoSave(false);
+    c.RemovePolicy({"Alice", "data1", "read"});
+    c.AddRoleForUser("Carol", "Alice");
+    c.SaveSnapshotFile(path);
+
+    caep::Caeper loaded;
+    loaded.LoadSnapshotFile(path);
+    ASSERT_EQ(loaded.GetPolicy(), c.GetPolicy());
+    ASSERT_EQ(loaded.GetRolePolicy(), c.GetRolePolicy());
+    ASSERT_TRUE(loaded.GetRoleManager()->HasLink("Carol", "admin"));
+    for(const auto& req : std::vector<std::vector<std::string>>{{"Alice", "data2", "write"}, {"Carol", "data1", "write"},
+                                                                 {"Alice", "data1", "read"}, {"Bob", "data2", "read"}})
+        ASSERT_EQ(loaded.Caep(req), c.Caep(req));
+
+    // The role graph is read back as it is, the links are not built again.
+    caep::PolicySnapshot snapshot;
+    snapshot.rm = std::make_shared<caep::DefaultRoleManager>(10);
+    ASSERT_TRUE(caep::SnapshotFile::Load(path, snapshot));
+    ASSERT_EQ(snapshot.rm->GetRoles("Carol"), std::vector<std::string>({"Alice"}));
+
+    // A flipped byte fails the checksum of its block, the loaded policy stays as it is.
+    std::string bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bytes[bytes.size() - 1] ^= 1;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << bytes;
+    }
+    ASSERT_ANY_THROW(loaded.LoadSnapshotFile(path));
+    ASSERT_EQ(loaded.GetPolicy(), c.GetPolicy());
+
+    std::remove(path.c_str());
+}
+
 }
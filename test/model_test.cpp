@@ -79,4 +79,231 @@ TEST(TestModel, TestModel_AddDef) {
     ASSERT_FALSE(ok);
 }
 
+TEST(TestModel, TestPolicyIndex) {
+    caep::Model* model = caep::Model::NewModelFromFile(basic_example);
+    model->AddPolicy("a", "a", {"Alice", "data1", "read"});
+    model->AddPolicy("a", "a", {"Bob", "data2", "write"});
+    model->AddPolicy("a", "a", {"Carol", "data*", "read"});
+
+    auto& index = model->m["a"].section_map["a"]->policy_index;
+    ASSERT_EQ(*index.Find(1, model->symbols->Find("data2")), std::vector<size_t>({1}));
+    ASSERT_EQ(*index.Wildcards(1), std::vector<size_t>({2}));
+    ASSERT_EQ(index.Find(1, model->symbols->Find("data*")), nullptr);
+
+    // Removed rules are tombstones until the section compacts itself.
+    auto section = model->m["a"].section_map["a"];
+    model->RemovePolicy("a", "a", {"Alice", "data1", "read"});
+    ASSERT_FALSE(section->IsLive(0));
+    ASSERT_EQ(section->RuleCount(), 2);
+    ASSERT_EQ(*index.Find(1, model->symbols->Find("data2")), std::vector<size_t>({1}));
+
+    model->UpdatePolicy("a", "a", {"Bob", "data2", "write"}, {"Bob", "data3", "write"});
+    ASSERT_EQ(index.Find(1, model->symbols->Find("data2")), nullptr);
+    ASSERT_EQ(*index.Find(1, model->symbols->Find("data3")), std::vector<size_t>({1}));
+
+    model->ClearPolicy();
+    ASSERT_EQ(index.Find(1, model->symbols->Find("data3")), nullptr);
+    ASSERT_EQ(index.Wildcards(1), nullptr);
+}
+
+TEST(TestModel, TestCIDRIndex) {
+    caep::Model* model = caep::Model::NewModelFromFile(basic_example);
+    model->AddPolicy("a", "a", {"10.0.0.0/8", "data1", "read"});
+    model->AddPolicy("a", "a", {"10.1.0.0/16", "data1", "read"});
+    model->AddPolicy("a", "a", {"192.168.2.1", "data1", "read"});
+    model->AddPolicy("a", "a", {"Alice", "data1", "read"});
+    model->AddPolicy("a", "a", {"2001:db8::/32", "data1", "read"});
+    model->AddPolicy("a", "a", {"10.1.2.0/24", "data1", "read"});
+
+    auto& index = model->m["a"].section_map["a"]->policy_index;
+    auto find = [&](const std::string& ip) {
+        caep::IPPrefix addr;
+        EXPECT_TRUE(caep::IPPrefix::Parse(ip, addr));
+        std::vector<size_t> rows;
+        index.FindIP(0, addr, rows);
+        return rows;
+    };
+
+    ASSERT_EQ(find("10.1.2.3"), std::vector<size_t>({0, 1, 5}));
+    ASSERT_EQ(find("10.2.0.1"), std::vector<size_t>({0}));
+    ASSERT_EQ(find("192.168.2.1"), std::vector<size_t>({2}));
+    ASSERT_EQ(find("::ffff:192.168.2.1"), std::vector<size_t>({2}));
+    ASSERT_EQ(find("2001:db8::1"), std::vector<size_t>({4}));
+    ASSERT_TRUE(find("172.16.0.1").empty());
+
+    caep::IPPrefix prefix;
+    ASSERT_FALSE(caep::IPPrefix::Parse("Alice", prefix));
+    ASSERT_FALSE(caep::IPPrefix::Parse("10.0.0.0/33", prefix));
+    ASSERT_TRUE(caep::IPPrefix::Parse("10.1.2.3/16", prefix));
+    ASSERT_EQ(prefix.bits, 112);
+    ASSERT_EQ(prefix.addr.bytes[14], 0);
+}
+
+TEST(TestModel, TestColumnMatcher) {
+    caep::Model* model = caep::Model::NewModelFromFile(basic_example);
+    std::vector<std::string> resources = {"data1", "data2", "data*", "/topic/*", "*", "/topic/1"};
+    for(int i = 0; i < 150; ++i)
+        model->AddPolicy("a", "a", {"u" + std::to_string(i), resources[i % resources.size()], "read"});
+    model->AddPolicy("a", "a", {"Alice"});
+
+    const auto& section = *model->m["a"].section_map["a"];
+    for(const std::string value : {"data1", "data3", "/topic/1", "/topic", "", "Bob"}) {
+        std::vector<uint64_t> mask;
+        caep::ColumnMatcher::DefaultMatch(section, 1, value, section.symbols->Find(value), mask);
+        ASSERT_EQ(mask.size(), caep::ColumnMatcher::MaskWords(section.RowCount()));
+        for(size_t row = 0; row < section.RowCount(); ++row) {
+            caep::symbol_t id = section.GetId(row, 1);
+            bool expected = id != caep::NO_SYMBOL && caep::DefaultMatcher(value, section.symbols->Name(id));
+            ASSERT_EQ(bool(mask[row / 64] >> (row % 64) & 1), expected) << value << " " << row;
+        }
+    }
+}
+
+// CountingEffector merges with DefaultEffector and keeps how many effects it was given.
+class CountingEffector : public caep::Effector {
+public:
+    size_t effect_count = 0;
+
+    bool MergeEffects(std::string expr, std::vector<caep::Effect> effects, std::vector<float> results) {
+        effect_count = effects.size();
+        return caep::DefaultEffector().MergeEffects(expr, effects, results);
+    }
+};
+
+TEST(TestModel, TestConditionEvaluate) {
+    caep::Model* model = caep::Model::NewModelFromFile(basic_example);
+    caep::Matcher matcher;
+    matcher.LoadMatcherFromModel(model);
+    std::vector<std::string> resources = {"data1", "data2", "data*", "/topic/*", "*", "/topic/1"};
+    for(int i = 0; i < 200; ++i)
+        model->AddPolicy("a", "a", {"u" + std::to_string(i % 7), resources[i % resources.size()], i % 3 ? "read" : "write"});
+    for(int i = 0; i < 200; i += 9)
+        model->RemovePolicy("a", "a", {"u" + std::to_string(i % 7), resources[i % resources.size()], i % 3 ? "read" : "write"});
+
+    const auto& section = *model->m["a"].section_map["a"];
+    const auto& live = section.GetLiveMask();
+    caep::DefaultEffector eft;
+    for(const std::string exp : {"DefaultMatcher(a.res, a.act)", "DefaultMatcher(a.res) && !DefaultMatcher(a.act)", "DefaultMatcher(a.sub) || DefaultMatcher(a.res) && DefaultMatcher(a.act)"}) {
+        auto plan = caep::ConditionPlan::Compile(exp, model, &matcher);
+        for(std::vector<std::string> req : std::vector<std::vector<std::string>>{{"u1", "data1", "read"}, {"u3", "/topic/1", "write"}, {"u9", "data7", "read"}}) {
+            std::vector<caep::symbol_t> req_ids;
+            for(const auto& value : req)
+                req_ids.push_back(section.symbols->Find(value));
+
+            std::vector<uint64_t> matched;
+            plan->Evaluate(req, req_ids, section, nullptr, live, matched);
+            for(size_t row = 0; row < section.RowCount(); ++row) {
+                bool expected = section.IsLive(row) && plan->Match(req, req_ids, section, row, nullptr);
+                ASSERT_EQ(bool(matched[row / 64] >> (row % 64) & 1), expected) << exp << " " << row;
+            }
+
+            // DefaultEffector reads the masks as the expanded effects would be merged, and streams them to the same decision.
+            for(const std::string effect : {"AllowPriority", "DenyPriority", "FirstPriority"}) {
+                caep::EffectKind kind = caep::ParseEffectKind(effect);
+                bool merged = eft.Effector::MergeMask(effect, kind, matched, live, section.RowCount());
+                ASSERT_EQ(eft.MergeMask(effect, kind, matched, live, section.RowCount()), merged);
+
+                caep::EffectStream stream;
+                eft.Begin(effect, kind, section.RowCount(), stream);
+                for(size_t i = 0; i < live.size() && !eft.Feed(stream, matched[i], live[i]); ++i);
+                ASSERT_EQ(eft.End(stream), merged) << effect;
+
+                stream = caep::EffectStream();
+                eft.Effector::Begin(effect, kind, section.RowCount(), stream);
+                for(size_t i = 0; i < live.size() && !eft.Effector::Feed(stream, matched[i], live[i]); ++i);
+                ASSERT_EQ(eft.Effector::End(stream), merged) << effect;
+            }
+        }
+    }
+
+    // The default End expands one effect per row, not per bit of the words fed.
+    CountingEffector counting;
+    caep::EffectStream stream;
+    counting.Begin("AllowPriority", caep::EffectKind::AllowPriority, section.RowCount(), stream);
+    for(size_t i = 0; i < live.size(); ++i)
+        counting.Feed(stream, 0, live[i]);
+    ASSERT_EQ(counting.End(stream), false);
+    ASSERT_EQ(counting.effect_count, section.RowCount());
+    ASSERT_NE(section.RowCount() % 64, 0u);
+
+    // Skipping words without matched rows decides as feeding them does.
+    std::vector<uint64_t> sparse(live.size(), 0);
+    sparse[2] = live[2] & (live[2] - 1);
+    for(const std::string effect : {"AllowPriority", "DenyPriority", "FirstPriority"}) {
+        caep::EffectKind kind = caep::ParseEffectKind(effect);
+        for(size_t split = 0; split <= live.size(); ++split) {
+            caep::EffectStream fed, skipped;
+            eft.Begin(effect, kind, section.RowCount(), fed);
+            for(size_t i = 0; i < live.size() && !eft.Feed(fed, i < split ? 0 : sparse[i], live[i]); ++i);
+            eft.Begin(effect, kind, section.RowCount(), skipped);
+            if(!eft.Skip(skipped, live, 0, split))
+                for(size_t i = split; i < live.size() && !eft.Feed(skipped, sparse[i], live[i]); ++i);
+            ASSERT_EQ(eft.End(skipped), eft.End(fed)) << effect << " " << split;
+            ASSERT_EQ(skipped.row, fed.row) << effect << " " << split;
+        }
+    }
+}
+
+TEST(TestModel, TestColumnarPolicy) {
+    caep::Model* model = caep::Model::NewModelFromFile(basic_example);
+    model->AddPolicy("a", "a", {"Alice", "data1", "read"});
+    model->AddPolicy("a", "a", {"Bob", "data1", "write"});
+    model->AddPolicy("a", "a", {"Alice", "data2", "write", "domain1"});
+
+    ASSERT_EQ(model->GetPolicy("a", "a"), std::vector<std::vector<std::string>>({
+        {"Alice", "data1", "read"},
+        {"Bob", "data1", "write"},
+        {"Alice", "data2", "write", "domain1"}}));
+    ASSERT_EQ(model->GetFilteredPolicy("a", "a", 1, {"data1"}), std::vector<std::vector<std::string>>({
+        {"Alice", "data1", "read"},
+        {"Bob", "data1", "write"}}));
+    ASSERT_EQ(model->GetFilteredPolicy("a", "a", 0, {"Alice", "", "write"}), std::vector<std::vector<std::string>>({
+        {"Alice", "data2", "write", "domain1"}}));
+    ASSERT_TRUE(model->GetFilteredPolicy("a", "a", 0, {"Carol"}).empty());
+
+    ASSERT_TRUE(model->HasPolicy("a", "a", {"read", "Alice", "data1"}));
+    ASSERT_FALSE(model->HasPolicy("a", "a", {"Alice", "data2", "write"}));
+    ASSERT_EQ(model->GetValuesForFieldInPolicy("a", "a", 3), std::vector<std::string>({"domain1"}));
+
+    auto section = model->m["a"].section_map["a"];
+    ASSERT_EQ(section->GetId(0, 0), section->GetId(2, 0));
+    ASSERT_EQ(section->GetId(0, 3), caep::NO_SYMBOL);
+    ASSERT_EQ(model->symbols->Size(), 7);
+
+    auto removed = model->RemoveFilteredPolicy("a", "a", 0, {"Alice"});
+    ASSERT_TRUE(removed.first);
+    ASSERT_EQ(removed.second.size(), 2);
+    ASSERT_EQ(model->GetPolicy("a", "a"), std::vector<std::vector<std::string>>({{"Bob", "data1", "write"}}));
+}
+
+TEST(TestModel, TestPolicyFingerprint) {
+    caep::Model* model = caep::Model::NewModelFromFile(basic_example);
+    auto section = model->m["a"].section_map["a"];
+
+    std::vector<std::vector<std::string>> rules;
+    for(int i = 0; i < 1000; ++i)
+        rules.push_back({"user" + std::to_string(i), "data" + std::to_string(i % 10), "read"});
+    ASSERT_TRUE(model->AddPolicies("a", "a", rules));
+    ASSERT_FALSE(model->AddPolicies("a", "a", {{"Alice", "data1", "read"}, {"user7", "data7", "read"}}));
+
+    // Rules holding the same values in any order are equal, as CaepUtil::ArrayEqual does.
+    ASSERT_TRUE(model->HasPolicy("a", "a", {"read", "data7", "user7"}));
+    ASSERT_FALSE(model->HasPolicy("a", "a", {"user7", "data7"}));
+    ASSERT_FALSE(model->AddPolicy("a", "a", {"data7", "user7", "read"}));
+
+    for(int i = 0; i < 1000; i += 2)
+        ASSERT_TRUE(model->RemovePolicy("a", "a", rules[i]));
+    ASSERT_EQ(section->RuleCount(), 500);
+    ASSERT_FALSE(model->HasPolicy("a", "a", rules[0]));
+    ASSERT_TRUE(model->HasPolicy("a", "a", rules[1]));
+
+    // The order of the remaining rules is kept through compactions.
+    ASSERT_TRUE(model->RemovePolicy("a", "a", rules[1]));
+    auto policy = model->GetPolicy("a", "a");
+    ASSERT_EQ(policy.size(), 499);
+    for(size_t i = 0; i < policy.size(); ++i)
+        ASSERT_EQ(policy[i], rules[2 * i + 3]);
+    ASSERT_EQ(section->RowCount(), section->RuleCount());
+}
+
 } // namespace
@@ -14,6 +14,14 @@ void TestDomainRole(caep::DefaultRoleManager& rm, const std::string& name1, cons
     ASSERT_EQ(res, my_res);
 }
 
+bool PrefixMatch(std::string name, std::string pattern) {
+    return pattern.back() == '*' && name.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+}
+
+bool IsPrefixPattern(const std::string& name) {
+    return !name.empty() && name.back() == '*';
+}
+
 TEST(TestRoleManager, TestRole) {
     caep::DefaultRoleManager rm(3);
     rm.AddLink("u1", "g1");
@@ -174,4 +182,102 @@ TEST(TestRoleManager, TestClear) {
     TestRole(rm, "u4", "g3", false);
 }
 
+TEST(TestRoleManager, TestHierarchyLevel) {
+    caep::DefaultRoleManager rm(2);
+    rm.AddLink("u1", "g1");
+    rm.AddLink("g1", "g2");
+    rm.AddLink("g2", "g3");
+    rm.AddLink("u1", "g4");
+    rm.AddLink("g4", "g2");
+
+    // Current role inheritance tree, max_hierarchy_level is 2:
+    //             g3
+    //             |
+    //             g2
+    //            /  \
+    //          g1    g4
+    //            \  /
+    //             u1
+
+    TestRole(rm, "u1", "g2", true);
+    TestRole(rm, "u1", "g3", false);
+    TestRole(rm, "g1", "g3", true);
+
+    rm.AddLink("u1", "g2");
+    TestRole(rm, "u1", "g3", true);
+
+    // u1 still reaches g2 through g4 after deleting the shorter paths.
+    rm.DeleteLink("u1", "g2");
+    rm.DeleteLink("g1", "g2");
+    TestRole(rm, "u1", "g2", true);
+    TestRole(rm, "u1", "g3", false);
+    TestRole(rm, "g1", "g2", false);
+
+    // A cycle does not make a Role inherit itself through the index.
+    rm.AddLink("g3", "u1");
+    TestRole(rm, "g3", "g4", true);
+    TestRole(rm, "g2", "u1", true);
+    rm.DeleteLink("g3", "u1");
+    TestRole(rm, "g2", "u1", false);
+}
+
+TEST(TestRoleManager, TestClearDomain) {
+    caep::DefaultRoleManager rm(3);
+    std::vector<std::string> domain1 = { "domain1" };
+    std::vector<std::string> domain2 = { "domain2" };
+
+    rm.AddLink("u1", "g1", domain1);
+    rm.AddLink("g1", "admin", domain1);
+    rm.AddLink("u1", "g1", domain2);
+    rm.AddLink("u1", "g1");
+
+    TestDomainRole(rm, "u1", "admin", domain1, true);
+    TestDomainRole(rm, "u1", "admin", domain2, false);
+    ASSERT_EQ(std::vector<std::string>{ "g1" }, rm.GetRoles("u1", domain2));
+    ASSERT_EQ(std::vector<std::string>{ "u1" }, rm.GetUsers("g1", domain1));
+
+    rm.ClearDomain("domain1");
+
+    // Only the links in domain1 are deleted.
+
+    TestDomainRole(rm, "u1", "g1", domain1, false);
+    TestDomainRole(rm, "u1", "admin", domain1, false);
+    TestDomainRole(rm, "u1", "g1", domain2, true);
+    TestRole(rm, "u1", "g1", true);
+    ASSERT_TRUE(rm.GetRoles("u1", domain1).empty());
+    ASSERT_ANY_THROW(rm.HasLink("u1", "g1", { "domain1", "domain2" }));
+
+    rm.AddLink("u2", "g2", domain1);
+    TestDomainRole(rm, "u2", "g2", domain1, true);
+    TestDomainRole(rm, "u2", "g2", domain2, false);
+}
+
+TEST(TestRoleManager, TestPatternRole) {
+    caep::DefaultRoleManager rm(3);
+    rm.AddMatchingFunc(PrefixMatch, IsPrefixPattern);
+    rm.AddLink("book_*", "reader");
+    rm.AddLink("book_1", "archive");
+
+    // book_1 and book_2 inherit book_* through the pattern, only book_1 has a link of its own.
+
+    TestRole(rm, "book_1", "book_*", true);
+    TestRole(rm, "book_1", "reader", true);
+    TestRole(rm, "book_2", "reader", true);
+    TestRole(rm, "book_2", "archive", false);
+    TestRole(rm, "pen_1", "reader", false);
+
+    // The cached matches of book_2 are dropped once a new pattern Role is created.
+    rm.AddLink("book_2*", "writer");
+    TestRole(rm, "book_2", "writer", true);
+    TestRole(rm, "book_1", "writer", false);
+
+    rm.DeleteLink("book_*", "reader");
+    TestRole(rm, "book_2", "reader", false);
+
+    caep::DefaultRoleManager all(3);
+    all.AddMatchingFunc(PrefixMatch);
+    all.AddLink("book_*", "reader");
+    TestRole(all, "book_3", "reader", true);
+}
+
 } // namespace
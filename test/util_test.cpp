@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include <caep/caep.h>
+#include <caep/ip_parser/parser/parseCIDR.h>
+#include <caep/ip_parser/parser/parseIP.h>
 
 namespace {
 
@@ -79,4 +81,66 @@ TEST(TestCaepUtil, TestSplit) {
     TestSplitFn("a && b && c", "&&", -1, {"a ", " b ", " c"});
 }   
 
+void TestRegexMatcherFn(const std::string& str, const std::string& pattern, bool res) {
+    bool my_res = caep::RegexMatcher(str, pattern);
+    ASSERT_EQ(my_res, res);
+}
+
+TEST(TestCaepUtil, TestRegexMatcher) {
+    TestRegexMatcherFn("/topic/create", "/topic/create", true);
+    TestRegexMatcherFn("/topic/create/123", "/topic/create", false);
+    TestRegexMatcherFn("/topic/delete/123", "/topic/delete/[0-9]+", true);
+    TestRegexMatcherFn("/topic/delete/abc", "/topic/delete/[0-9]+", false);
+    TestRegexMatcherFn("/topic/edit/123", "/topic/delete/[0-9]+", false);
+    ASSERT_ANY_THROW(caep::RegexMatcher("a", "[a"));
+
+    // Each pattern is compiled once, a full cache starts over.
+    caep::RegexCache cache(2);
+    ASSERT_TRUE(cache.Match("ab", "a."));
+    ASSERT_TRUE(cache.Match("ac", "a."));
+    ASSERT_EQ(cache.Size(), 1);
+    ASSERT_FALSE(cache.Match("b", "a|c"));
+    ASSERT_EQ(cache.Size(), 2);
+    ASSERT_TRUE(cache.Match("b", "b"));
+    ASSERT_EQ(cache.Size(), 1);
+}
+
+TEST(TestCaepUtil, TestParseIPAddr) {
+    constexpr caep::IPAddr addr = caep::IPAddr::From4(192, 168, 2, 1);
+    static_assert(addr.Mask(120) == caep::IPAddr::From4(192, 168, 2, 0), "");
+    static_assert(addr.PrefixEqual(caep::IPAddr::From4(192, 168, 3, 1), 118), "");
+    static_assert(!addr.PrefixEqual(caep::IPAddr::From4(192, 168, 3, 1), 120), "");
+
+    caep::IPAddr parsed;
+    ASSERT_TRUE(caep::parseIPAddr("192.168.2.1", parsed));
+    ASSERT_TRUE(parsed.Is4());
+    ASSERT_EQ(parsed, addr);
+    ASSERT_TRUE(caep::parseIPAddr("::ffff:192.168.2.1", parsed));
+    ASSERT_FALSE(parsed.Is4());
+    ASSERT_EQ(parsed, addr);
+    ASSERT_TRUE(caep::parseIPAddr("2001:db8::1", parsed));
+    ASSERT_EQ(parsed.bytes[1], 0x01);
+    ASSERT_EQ(parsed.bytes[15], 0x01);
+    for(const char* s : {"", "Alice", "192.168.2", "192.168.2.256", "1::2::3", "1:2:3:4:5:6:7:8:9", "::1.2.3"})
+        ASSERT_FALSE(caep::parseIPAddr(s, parsed)) << s;
+
+    int bits;
+    ASSERT_TRUE(caep::parseCIDRAddr("10.1.2.3/16", parsed, bits));
+    ASSERT_EQ(bits, 112);
+    ASSERT_EQ(parsed.Mask(bits), caep::IPAddr::From4(10, 1, 0, 0));
+    ASSERT_FALSE(caep::parseCIDRAddr("10.0.0.0/33", parsed, bits));
+    ASSERT_TRUE(caep::parseCIDRAddr("2001:db8::/128", parsed, bits));
+    ASSERT_FALSE(caep::parseCIDRAddr("2001:db8::/129", parsed, bits));
+
+    // parseIP and parseCIDR wrap the parsers above.
+    ASSERT_EQ(caep::parseIP("10.0.0.1").toString(), "10.0.0.1");
+    ASSERT_FALSE(caep::parseIP("10.0.0").isLegal);
+    caep::CIDR cidr = caep::parseCIDR("192.168.2.1/24");
+    ASSERT_EQ(cidr.ip.toString(), "192.168.2.1");
+    ASSERT_EQ(cidr.net.NETIP_toString(), "192.168.2.0");
+    ASSERT_EQ(cidr.net.IPMask_toString(), "255.255.255.0");
+    ASSERT_TRUE(cidr.net.contains(caep::parseIP("192.168.2.200")));
+    ASSERT_ANY_THROW(caep::parseCIDR("192.168.2.1"));
+}
+
 } // namespace 